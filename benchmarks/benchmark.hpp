@@ -0,0 +1,63 @@
+
+#ifndef BENCHMARK_HPP
+#define BENCHMARK_HPP
+
+#include <algorithm> // std::min, std::max
+#include <atomic> // std::atomic_signal_fence
+#include <chrono> // std::chrono::steady_clock
+#include <cstddef> // std::size_t
+
+// Timing helpers shared by all benchmarks, so that their measurements are comparable
+namespace benchmark {
+
+    // Prevents the compiler from optimizing away the computation of 'value'
+    template <typename T>
+    inline void do_not_optimize(const T& value) {
+        #if defined(__GNUC__) || defined(__clang__)
+            asm volatile("" : : "r,m"(value) : "memory");
+        #else
+            static volatile const void* sink;
+            sink = &value;
+            std::atomic_signal_fence(std::memory_order_seq_cst);
+        #endif
+    }
+
+    // Returns the average time (in nanoseconds) of 'iterations' calls to 'fn'
+    // Measured with std::chrono::steady_clock, which (unlike std::chrono::high_resolution_clock in libstdc++) is not affected by adjustments to the system clock
+    template <typename Fn>
+    inline double measure_ns(Fn&& fn, std::size_t iterations) {
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        for (std::size_t i = 0u; i < iterations; ++i) {
+            fn();
+        }
+        std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+        return (double) std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count() / (double) iterations;
+    }
+
+    struct Measurement {
+        double ns; // Average time per call
+        std::size_t iterations;
+    };
+
+    // Times rounds of increasing iteration counts with measure_ns(...) until a round takes at least 'target', returns the last round
+    // For benchmarks where the cost of a call is not known up front
+    template <typename Fn>
+    inline Measurement measure(Fn&& fn, std::chrono::nanoseconds target) {
+        std::size_t iterations = 1u;
+        while (true) {
+            double ns = measure_ns(fn, iterations);
+            double elapsed = ns * (double) iterations;
+
+            if (elapsed >= (double) target.count() || iterations >= (std::size_t(1u) << 32u)) {
+                return { ns, iterations };
+            }
+
+            // Aim slightly past the target, growing by at most 10x per round
+            double scale = elapsed > 0.0 ? 1.2 * (double) target.count() / elapsed : 10.0;
+            iterations = std::max(iterations + 1u, (std::size_t) ((double) iterations * std::min(scale, 10.0)));
+        }
+    }
+
+}
+
+#endif // BENCHMARK_HPP
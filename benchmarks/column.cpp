@@ -0,0 +1,73 @@
+
+#include "utils/string.hpp"
+
+#include "benchmark.hpp"
+
+#include <charconv> // std::from_chars
+#include <iostream> // std::cout
+#include <random> // std::mt19937_64
+#include <string> // std::string, std::to_string
+#include <vector> // std::vector
+
+namespace {
+
+    // Reference implementation that parses each field with std::from_chars (without validating the characters that follow)
+    template <typename T>
+    std::size_t parse_column_from_chars(std::string_view buffer, char delimiter, std::vector<T>& out) {
+        const char* current = buffer.data();
+        const char* end = current + buffer.length();
+        
+        std::size_t count = 0u;
+        while (current < end && count < out.size()) {
+            current = std::from_chars(current, end, out[count++]).ptr + 1;
+            while (current < end && current[-1] != delimiter) {
+                ++current;
+            }
+        }
+        return count;
+    }
+
+    // Parses a newline-separated column of 'num_values' random values that are less than 'limit' (divided by 'scale' for floating point types)
+    template <typename T>
+    bool run(const char* name, std::uint64_t limit, T scale = T(1)) {
+        constexpr std::size_t num_values = 1000000u;
+        
+        std::mt19937_64 generator(0u);
+        std::string buffer;
+        for (std::size_t i = 0u; i < num_values; ++i) {
+            buffer += std::to_string((T) (generator() % limit) / scale);
+            buffer += '\n';
+        }
+
+        std::vector<T> expected(num_values);
+        double reference_ns = benchmark::measure_ns([&]() {
+            parse_column_from_chars(buffer, '\n', expected);
+        }, 10u);
+
+        std::vector<T> values(num_values);
+        utils::BulkParseResult result { };
+        double column_ns = benchmark::measure_ns([&]() {
+            result = utils::parse_column<T>(buffer, '\n', values);
+        }, 10u);
+
+        std::cout << name << " (" << buffer.length() << " bytes): "
+                  << "std::from_chars: " << (double) buffer.length() / reference_ns * 1000.0 << " MB/s, "
+                  << "parse_column: " << (double) buffer.length() / column_ns * 1000.0 << " MB/s" << std::endl;
+
+        if (result.count != num_values || result.num_errors != 0u || values != expected) {
+            std::cout << "error: parse_column result does not match std::from_chars" << std::endl;
+            return false;
+        }
+        return true;
+    }
+
+}
+
+// Measures the throughput of parsing numeric columns, such as those of CSV / TSV files
+int main() {
+    bool success = true;
+    success &= run<int>("int, up to 9 digits", 1000000000ull);
+    success &= run<long long>("long long, up to 18 digits", 1000000000000000000ull);
+    success &= run<double>("double, 6 decimal places", 100000000ull, 100.0);
+    return success ? 0 : 1;
+}
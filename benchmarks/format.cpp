@@ -0,0 +1,114 @@
+
+#include "utils/string.hpp"
+
+#include "benchmark.hpp"
+
+#include <cstdlib> // std::malloc, std::free
+#include <iostream> // std::cout
+#include <new> // std::bad_alloc
+#include <vector> // std::vector
+
+// Heap usage is tracked by replacing the global allocation functions
+// Each allocation is prefixed with its size so that the number of live bytes is known when the allocation is released
+namespace {
+
+    constexpr std::size_t header_size = alignof(std::max_align_t);
+
+    std::size_t live_bytes = 0u;
+    std::size_t peak_bytes = 0u;
+
+    // Returns the peak number of live heap bytes allocated while running 'fn', relative to the number of live bytes before the call
+    template <typename Fn>
+    std::size_t measure_peak_bytes(Fn&& fn) {
+        std::size_t start = live_bytes;
+        peak_bytes = live_bytes;
+
+        fn();
+
+        return peak_bytes - start;
+    }
+
+}
+
+void* operator new(std::size_t size) {
+    void* ptr = std::malloc(size + header_size);
+    if (!ptr) {
+        throw std::bad_alloc();
+    }
+
+    *static_cast<std::size_t*>(ptr) = size;
+    live_bytes += size;
+    if (live_bytes > peak_bytes) {
+        peak_bytes = live_bytes;
+    }
+
+    return static_cast<char*>(ptr) + header_size;
+}
+
+void operator delete(void* ptr) noexcept {
+    if (!ptr) {
+        return;
+    }
+
+    void* allocation = static_cast<char*>(ptr) - header_size;
+    live_bytes -= *static_cast<std::size_t*>(allocation);
+    std::free(allocation);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept {
+    operator delete(ptr);
+}
+
+// Formats a large std::vector<int> and reports the amount of heap memory used by the formatting engine itself
+// The output is written into storage that is reserved up front, so any additional heap usage is overhead of the implementation and should remain constant regardless of the number of elements
+int main() {
+    // Overhead above this limit (in bytes) is considered a regression
+    constexpr std::size_t overhead_limit = 4096u;
+    bool success = true;
+
+    for (std::size_t num_elements : { 1000u, 10000u, 100000u }) {
+        std::vector<int> value(num_elements);
+        for (std::size_t i = 0u; i < num_elements; ++i) {
+            value[i] = (int) i;
+        }
+
+        std::size_t length = 0u;
+        std::size_t size_overhead = measure_peak_bytes([&]() {
+            length = utils::formatted_size("{}", value);
+        });
+
+        std::string result;
+        result.reserve(length);
+        std::size_t format_to_overhead = measure_peak_bytes([&]() {
+            utils::format_to(result, "{}", value);
+        });
+
+        double ns = benchmark::measure_ns([&]() {
+            result.clear();
+            utils::format_to(result, "{}", value);
+        }, 100u);
+
+        // Elements past 'max_elements' are never visited, so the cost should remain constant regardless of the number of elements
+        double truncated_ns = benchmark::measure_ns([&]() {
+            result.clear();
+            utils::format_to(result, "{:max_elements=[10]}", value);
+        }, 100u);
+
+        std::cout << "format std::vector<int> (" << num_elements << " elements): " << length << " characters, "
+                  << "formatted_size overhead: " << size_overhead << " bytes, "
+                  << "format_to overhead: " << format_to_overhead << " bytes, "
+                  << (std::size_t) ns << " ns/call, "
+                  << (std::size_t) truncated_ns << " ns/call (max_elements=[10])" << std::endl;
+
+        if (size_overhead > overhead_limit || format_to_overhead > overhead_limit) {
+            success = false;
+        }
+    }
+
+    if (!success) {
+        std::cout << "error: formatting overhead exceeds " << overhead_limit << " bytes" << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
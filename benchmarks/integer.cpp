@@ -0,0 +1,117 @@
+
+#include "utils/string.hpp"
+
+#include "benchmark.hpp"
+
+#include <charconv> // std::to_chars
+#include <cstdint> // std::int8_t, std::uint64_t, ...
+#include <iostream> // std::cout
+#include <limits> // std::numeric_limits
+#include <random> // std::mt19937_64
+#include <string> // std::string
+#include <string_view> // std::string_view
+#include <vector> // std::vector
+
+#if __has_include(<format>)
+    #include <format> // std::format_to
+#endif
+
+namespace {
+
+    // Values are spread uniformly over the number of significant bits so that short and long numbers are equally represented
+    template <typename T>
+    std::vector<T> generate_values(std::size_t count) {
+        std::mt19937_64 generator(0u);
+        std::vector<T> values(count);
+        for (T& value : values) {
+            std::uint64_t bits = generator() >> (generator() % 64u);
+            value = static_cast<T>(bits);
+        }
+        return values;
+    }
+
+    template <typename T>
+    void run(std::string_view name) {
+        constexpr std::size_t iterations = 100u;
+        std::vector<T> values = generate_values<T>(10000u);
+        
+        std::string result;
+        result.reserve(values.size() * 32u);
+        
+        // Values are widened so that char types are formatted as numbers by the standard library
+        using Widened = std::conditional_t<std::is_signed_v<T>, long long, unsigned long long>;
+        
+        double to_chars_ns = benchmark::measure_ns([&]() {
+            result.clear();
+            char buffer[32];
+            for (T value : values) {
+                std::to_chars_result r = std::to_chars(buffer, buffer + sizeof(buffer), (Widened) value);
+                result.append(buffer, r.ptr);
+            }
+        }, iterations) / (double) values.size();
+        
+        // Format spec is parsed once, isolating the cost of converting the value itself
+        double formatter_ns = benchmark::measure_ns([&]() {
+            result.clear();
+            utils::Formatter<T> formatter { };
+            utils::detail::StringBuffer buffer(result);
+            for (T value : values) {
+                formatter.format_to(value, buffer);
+            }
+        }, iterations) / (double) values.size();
+        
+        double format_to_ns = benchmark::measure_ns([&]() {
+            result.clear();
+            for (T value : values) {
+                utils::format_to(result, "{}", value);
+            }
+        }, iterations) / (double) values.size();
+        
+        double separator_ns = benchmark::measure_ns([&]() {
+            result.clear();
+            for (T value : values) {
+                utils::format_to(result, "{:use_separator=[true]}", value);
+            }
+        }, iterations) / (double) values.size();
+        
+        double hexadecimal_ns = benchmark::measure_ns([&]() {
+            result.clear();
+            for (T value : values) {
+                utils::format_to(result, "{:representation=[hexadecimal],use_base_prefix=[true]}", value);
+            }
+        }, iterations) / (double) values.size();
+        
+        std::cout << name << ": "
+                  << "std::to_chars: " << to_chars_ns << " ns, "
+                  << "utils::Formatter: " << formatter_ns << " ns, "
+                  << "utils::format_to: " << format_to_ns << " ns, "
+                  << "with separators: " << separator_ns << " ns, "
+                  << "hexadecimal: " << hexadecimal_ns << " ns";
+
+#if defined(__cpp_lib_format)
+        double std_format_ns = benchmark::measure_ns([&]() {
+            result.clear();
+            for (T value : values) {
+                std::format_to(std::back_inserter(result), "{}", (Widened) value);
+            }
+        }, iterations) / (double) values.size();
+        std::cout << ", std::format_to: " << std_format_ns << " ns";
+#endif
+        
+        std::cout << " (per value)" << std::endl;
+    }
+
+}
+
+// Formats integers of every width and compares against the standard library
+int main() {
+    run<std::int8_t>("int8_t");
+    run<std::uint8_t>("uint8_t");
+    run<std::int16_t>("int16_t");
+    run<std::uint16_t>("uint16_t");
+    run<std::int32_t>("int32_t");
+    run<std::uint32_t>("uint32_t");
+    run<std::int64_t>("int64_t");
+    run<std::uint64_t>("uint64_t");
+    return 0;
+}
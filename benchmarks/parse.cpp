@@ -0,0 +1,73 @@
+
+#include "utils/string.hpp"
+
+#include "benchmark.hpp"
+
+#include <iostream> // std::cout
+#include <string> // std::string
+
+namespace {
+
+    // Reference implementation that inspects one character at a time
+    std::size_t find_brace_scalar(std::string_view in, std::size_t offset) {
+        while (offset < in.length() && in[offset] != '{' && in[offset] != '}') {
+            ++offset;
+        }
+        return offset;
+    }
+
+    template <typename Fn>
+    std::size_t count_braces(std::string_view in, Fn&& find) {
+        std::size_t count = 0u;
+        for (std::size_t i = find(in, 0u); i < in.length(); i = find(in, i + 1u)) {
+            ++count;
+        }
+        return count;
+    }
+
+}
+
+// Formats ~1 KB format strings consisting of long runs of literal text with a few placeholders
+// Format strings are provided at runtime, so they are parsed on every call
+int main() {
+    constexpr std::size_t iterations = 100000u;
+
+    std::string text;
+    for (std::size_t i = 0u; text.length() < 1024u; ++i) {
+        text += "The quick brown fox jumps over the lazy dog. ";
+        if (i % 6 == 5) {
+            text += "{} ";
+        }
+    }
+    std::string_view fmt = text;
+
+    std::size_t scalar = 0u;
+    double scalar_ns = benchmark::measure_ns([&]() {
+        scalar += count_braces(fmt, find_brace_scalar);
+    }, iterations);
+
+    std::size_t vectorized = 0u;
+    double vectorized_ns = benchmark::measure_ns([&]() {
+        vectorized += count_braces(fmt, [](std::string_view in, std::size_t offset) {
+            return utils::detail::find_first_of(in, offset, "{}");
+        });
+    }, iterations);
+
+    if (scalar != vectorized) {
+        std::cout << "error: scalar and vectorized scans disagree" << std::endl;
+        return 1;
+    }
+
+    std::string result;
+    double format_ns = benchmark::measure_ns([&]() {
+        result.clear();
+        utils::format_to(result, fmt, 1, 2.5, "three", 4u);
+    }, iterations);
+
+    std::cout << "format string length: " << fmt.length() << " characters" << std::endl;
+    std::cout << "brace scan (scalar): " << scalar_ns << " ns/call" << std::endl;
+    std::cout << "brace scan (vectorized): " << vectorized_ns << " ns/call" << std::endl;
+    std::cout << "format_to (runtime format string): " << format_ns << " ns/call, " << (double) fmt.length() / format_ns * 1000.0 << " MB/s" << std::endl;
+
+    return 0;
+}
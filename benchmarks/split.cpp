@@ -0,0 +1,73 @@
+
+#include "utils/string.hpp"
+
+#include "benchmark.hpp"
+
+#include <iostream> // std::cout
+#include <string> // std::string, std::to_string
+
+namespace {
+
+    // Reference implementation that searches for each delimiter with std::string_view::find
+    std::size_t split_find(std::string_view in, std::string_view delimiter) {
+        std::size_t total = 0u;
+        std::size_t position = 0u;
+        while (true) {
+            std::size_t end = in.find(delimiter, position);
+            if (end == std::string_view::npos) {
+                return total + in.length() - position;
+            }
+            total += end - position;
+            position = end + delimiter.length();
+        }
+    }
+
+}
+
+// Splits a ~4 MB buffer of short fields, reports throughput of the eager (split) and lazy (split_view) implementations
+int main() {
+    constexpr std::size_t iterations = 20u;
+    bool success = true;
+    
+    for (std::string_view delimiter : { std::string_view(","), std::string_view("<|>") }) {
+        std::string buffer;
+        for (std::size_t i = 0u; buffer.length() < (4u << 20u); ++i) {
+            buffer += "field ";
+            buffer += std::to_string(i);
+            buffer += delimiter;
+        }
+        
+        std::size_t expected = split_find(buffer, delimiter);
+        double find_ns = benchmark::measure_ns([&]() {
+            expected = split_find(buffer, delimiter);
+        }, iterations);
+        
+        std::size_t eager = 0u;
+        double split_ns = benchmark::measure_ns([&]() {
+            eager = 0u;
+            for (std::string_view component : utils::split(buffer, delimiter)) {
+                eager += component.length();
+            }
+        }, iterations);
+        
+        std::size_t lazy = 0u;
+        double split_view_ns = benchmark::measure_ns([&]() {
+            lazy = 0u;
+            for (std::string_view component : utils::split_view(buffer, delimiter)) {
+                lazy += component.length();
+            }
+        }, iterations);
+        
+        std::cout << "delimiter '" << delimiter << "': "
+                  << "std::string_view::find: " << (double) buffer.length() / find_ns * 1000.0 << " MB/s, "
+                  << "split: " << (double) buffer.length() / split_ns * 1000.0 << " MB/s, "
+                  << "split_view: " << (double) buffer.length() / split_view_ns * 1000.0 << " MB/s" << std::endl;
+        
+        if (eager != expected || lazy != expected) {
+            std::cout << "error: split results do not match std::string_view::find" << std::endl;
+            success = false;
+        }
+    }
+    
+    return success ? 0 : 1;
+}
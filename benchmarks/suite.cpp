@@ -0,0 +1,526 @@
+
+#include "utils/string.hpp"
+#include "utils/datetime.hpp"
+#include "utils/logging.hpp"
+
+#include "benchmark.hpp"
+
+#include <algorithm> // std::sort, std::min, std::max
+#include <barrier> // std::barrier
+#include <chrono> // std::chrono
+#include <filesystem> // std::filesystem
+#include <fstream> // std::ofstream
+#include <iomanip> // std::setw, std::setprecision
+#include <iostream> // std::cout, std::cerr
+#include <memory> // std::shared_ptr
+#include <optional> // std::optional
+#include <string> // std::string
+#include <thread> // std::thread
+#include <vector> // std::vector
+#if __has_include(<format>)
+    #include <format> // std::format
+#endif
+
+#if defined(__cpp_lib_format)
+    #define UTILS_BENCHMARK_STD_FORMAT 1
+#endif
+
+// Benchmark suite covering formatting, parsing, datetime, and the logging front end
+// Usage: utils_benchmarks [--filter=<substring>] [--json=<path>] [--quick] [--max-threads=<count>]
+//   --filter: only runs benchmarks whose name contains the given substring
+//   --json: additionally writes results to the given file ('-' for standard output), for tracking regressions between releases
+//   --quick: shorter measurements, for smoke testing
+//   --max-threads: upper limit on the number of threads used by the logging benchmarks (default: 64)
+namespace {
+
+    struct Configuration {
+        std::string filter;
+        std::optional<std::string> json;
+        bool quick = false;
+        std::size_t max_threads = 64u;
+    };
+
+    Configuration configuration;
+
+    struct Latency {
+        std::size_t threads;
+        double p50; // Nanoseconds
+        double p99;
+        double p999;
+        double throughput; // Operations per second, across all threads
+    };
+
+    struct Result {
+        std::string name;
+        double ns; // Average time per operation
+        std::size_t iterations;
+        std::optional<Latency> latency;
+    };
+
+    std::vector<Result> results;
+
+    using benchmark::do_not_optimize;
+
+    [[nodiscard]] bool is_selected(std::string_view name) {
+        return name.find(configuration.filter) != std::string_view::npos;
+    }
+
+    // Runs 'fn' for increasing iteration counts until the measurement takes long enough to be reliable
+    template <typename Fn>
+    void run(const std::string& name, Fn&& fn) {
+        if (!is_selected(name)) {
+            return;
+        }
+
+        using namespace std::chrono;
+        benchmark::Measurement measurement = benchmark::measure(fn, configuration.quick ? milliseconds(5) : milliseconds(200));
+
+        double ns = measurement.ns;
+        results.push_back(Result { name, ns, measurement.iterations, std::nullopt });
+        std::cout << std::left << std::setw(60) << name << std::right << std::setw(12) << std::fixed << std::setprecision(2) << ns << " ns/op" << std::endl;
+    }
+
+    // Formatting
+
+    template <typename T>
+    void run_format(const std::string& type, const T& value) {
+        std::string out;
+
+        run("format/" + type + "/utils::format", [&]() {
+            std::string result = utils::format("{}", value);
+            do_not_optimize(result);
+        });
+
+        run("format/" + type + "/utils::format_to", [&]() {
+            out.clear();
+            utils::format_to(out, "{}", value);
+            do_not_optimize(out);
+        });
+
+        #if defined(UTILS_BENCHMARK_STD_FORMAT)
+            if constexpr (requires { std::formatter<T, char>(); }) {
+                run("format/" + type + "/std::format", [&]() {
+                    std::string result = std::format("{}", value);
+                    do_not_optimize(result);
+                });
+
+                run("format/" + type + "/std::format_to", [&]() {
+                    out.clear();
+                    std::format_to(std::back_inserter(out), "{}", value);
+                    do_not_optimize(out);
+                });
+            }
+        #endif
+    }
+
+    void run_format_benchmarks() {
+        int integer = -123456789;
+        run_format("int", integer);
+
+        unsigned long long large = 18446744073709551615ull;
+        run_format("unsigned long long", large);
+
+        double floating = 3.14159265358979;
+        run_format("double", floating);
+
+        run_format("char", 'x');
+
+        const char* c_string = "the quick brown fox jumps over the lazy dog";
+        run_format("const char*", c_string);
+
+        std::string string = "the quick brown fox jumps over the lazy dog";
+        run_format("std::string", string);
+
+        std::string_view view = string;
+        run_format("std::string_view", view);
+
+        void* pointer = &integer;
+        run_format("pointer", pointer);
+
+        std::vector<int> container { 1, 2, 3, 4, 5, 6, 7, 8, 9, 10 };
+        run_format("std::vector<int>", container);
+
+        std::pair<int, std::string> pair { 42, "value" };
+        run_format("std::pair", pair);
+
+        run("format/mixed/utils::format", [&]() {
+            std::string result = utils::format("{} {} {} {}", integer, floating, string, container);
+            do_not_optimize(result);
+        });
+
+        utils::CompiledFormat compiled("{} {} {}");
+        run("format/mixed/utils::CompiledFormat", [&]() {
+            std::string result = utils::format(compiled, integer, floating, string);
+            do_not_optimize(result);
+        });
+    }
+
+    // Parsing
+
+    void run_parse_benchmarks() {
+        std::string csv;
+        for (int i = 0; i < 64; ++i) {
+            csv += std::to_string(i * 7919);
+            csv += ',';
+        }
+
+        run("parse/split", [&]() {
+            std::vector<std::string_view> components = utils::split(csv, ",");
+            do_not_optimize(components);
+        });
+
+        run("parse/split_view", [&]() {
+            std::size_t count = 0u;
+            for (std::string_view component : utils::split_view(csv, ",")) {
+                count += component.length();
+            }
+            do_not_optimize(count);
+        });
+
+        std::string_view components[64];
+        run("parse/split_into", [&]() {
+            std::size_t count = utils::split_into(csv, ",", components);
+            do_not_optimize(count);
+        });
+
+        std::string padded = "   \t  the quick brown fox  \n ";
+        run("parse/trim", [&]() {
+            std::string_view result = utils::trim(padded);
+            do_not_optimize(result);
+        });
+
+        run("parse/from_string<int>", [&]() {
+            utils::ParseResult<int, utils::ParseError> result = utils::from_string<int>("-123456789");
+            do_not_optimize(result);
+        });
+
+        run("parse/from_string<unsigned long long>", [&]() {
+            utils::ParseResult<unsigned long long, utils::ParseError> result = utils::from_string<unsigned long long>("18446744073709551615");
+            do_not_optimize(result);
+        });
+
+        run("parse/from_string<double>", [&]() {
+            utils::ParseResult<double, utils::ParseError> result = utils::from_string<double>("3.14159265358979");
+            do_not_optimize(result);
+        });
+
+        std::vector<int> values(64);
+        run("parse/parse_column<int>", [&]() {
+            utils::BulkParseResult result = utils::parse_column<int>(csv, ',', values);
+            do_not_optimize(result);
+        });
+
+        run("parse/from_string<Timestamp> (ISO-8601)", [&]() {
+            utils::ParseResult<utils::Timestamp, utils::ParseError> result = utils::from_string<utils::Timestamp>("2024-02-29T13:45:30.123Z");
+            do_not_optimize(result);
+        });
+    }
+
+    // Datetime
+
+    void run_datetime_benchmarks() {
+        run("datetime/Clock::now (precise)", []() {
+            utils::Clock::time_point now = utils::Clock::now();
+            do_not_optimize(now);
+        });
+
+        utils::Clock::set_source(utils::Clock::Source::Coarse);
+        run("datetime/Clock::now (coarse)", []() {
+            utils::Clock::time_point now = utils::Clock::now();
+            do_not_optimize(now);
+        });
+        utils::Clock::set_source(utils::Clock::Source::Precise);
+
+        run("datetime/Timestamp::now", []() {
+            utils::Timestamp now = utils::Timestamp::now();
+            do_not_optimize(now);
+        });
+
+        run("datetime/EpochTimestamp::now", []() {
+            utils::EpochTimestamp now = utils::EpochTimestamp::now();
+            do_not_optimize(now);
+        });
+
+        utils::Timestamp timestamp = utils::Timestamp::now();
+        std::string out;
+
+        run("datetime/format Date", [&]() {
+            out.clear();
+            utils::format_to(out, "{}", timestamp.date);
+            do_not_optimize(out);
+        });
+
+        run("datetime/format Time", [&]() {
+            out.clear();
+            utils::format_to(out, "{}", timestamp.time);
+            do_not_optimize(out);
+        });
+
+        run("datetime/format Timestamp", [&]() {
+            out.clear();
+            utils::format_to(out, "{}", timestamp);
+            do_not_optimize(out);
+        });
+
+        run("datetime/format Timestamp (custom pattern)", [&]() {
+            out.clear();
+            utils::format_to(out, "{:format=[%Y-%m-%dT%H:%M:%S.%f]}", timestamp);
+            do_not_optimize(out);
+        });
+    }
+
+    // Logging
+
+    // Discards all messages, isolating the cost of the logging front end
+    class NullSink : public utils::logging::Sink {
+        public:
+            NullSink() : Sink("null", { }, utils::logging::Message::Level::Info) {
+            }
+
+            ~NullSink() override = default;
+
+        private:
+            void log(std::string_view message, const utils::logging::Message&) override {
+                do_not_optimize(message);
+            }
+    };
+
+    enum class SinkType {
+        Null = 0,
+        File,
+        Binary
+    };
+
+    [[nodiscard]] const char* to_string(SinkType type) {
+        switch (type) {
+            case SinkType::Null:
+                return "null";
+            case SinkType::File:
+                return "file";
+            case SinkType::Binary:
+                return "binary";
+        }
+        return "";
+    }
+
+    // Measures the latency of each call to the logging front end, as well as the overall throughput (including writing out all messages)
+    void run_logging(SinkType type, bool async, std::size_t num_threads) {
+        std::string name = "logging/" + std::string(to_string(type)) + "/" + (async ? "async" : "sync") + "/" + std::to_string(num_threads) + " threads";
+        if (!is_selected(name)) {
+            return;
+        }
+
+        using namespace std::chrono;
+        namespace logging = utils::logging;
+
+        std::filesystem::path directory = std::filesystem::temp_directory_path() / "utils_benchmarks";
+        std::filesystem::create_directories(directory);
+        
+        std::shared_ptr<logging::Sink> sink;
+        switch (type) {
+            case SinkType::Null:
+                sink = logging::create_sink<NullSink>();
+                break;
+            case SinkType::File:
+                sink = logging::create_sink<logging::FileSink>(directory / "file.log", std::ios::trunc);
+                break;
+            case SinkType::Binary:
+                sink = logging::create_sink<logging::BinaryFileSink>(directory / "binary.log");
+                logging::enable_deferred_formatting();
+                break;
+        }
+
+        if (async) {
+            logging::enable_async();
+        }
+
+        std::size_t total = configuration.quick ? 20000u : 400000u;
+        std::size_t messages_per_thread = std::max(total / num_threads, std::size_t(1000u));
+
+        std::vector<std::vector<std::int64_t>> latencies(num_threads);
+        std::barrier start(static_cast<std::ptrdiff_t>(num_threads + 1u));
+
+        std::vector<std::thread> threads;
+        for (std::size_t t = 0u; t < num_threads; ++t) {
+            threads.emplace_back([&, t]() {
+                std::vector<std::int64_t>& samples = latencies[t];
+                samples.reserve(messages_per_thread);
+
+                start.arrive_and_wait();
+                for (std::size_t i = 0u; i < messages_per_thread; ++i) {
+                    steady_clock::time_point begin = steady_clock::now();
+                    logging::info("message {} from thread {}: {}", i, t, 3.14159);
+                    samples.push_back(duration_cast<nanoseconds>(steady_clock::now() - begin).count());
+                }
+            });
+        }
+
+        steady_clock::time_point begin = steady_clock::now();
+        start.arrive_and_wait();
+        for (std::thread& thread : threads) {
+            thread.join();
+        }
+        logging::flush();
+        double seconds = duration_cast<duration<double>>(steady_clock::now() - begin).count();
+
+        if (async) {
+            logging::disable_async();
+        }
+        if (type == SinkType::Binary) {
+            logging::disable_deferred_formatting();
+        }
+        logging::destroy_sink(sink->get_name());
+        sink.reset();
+
+        std::vector<std::int64_t> samples;
+        for (const std::vector<std::int64_t>& thread_samples : latencies) {
+            samples.insert(samples.end(), thread_samples.begin(), thread_samples.end());
+        }
+        std::sort(samples.begin(), samples.end());
+
+        auto percentile = [&samples](double p) {
+            std::size_t index = std::min((std::size_t) (p * (double) samples.size()), samples.size() - 1u);
+            return (double) samples[index];
+        };
+
+        double sum = 0.0;
+        for (std::int64_t sample : samples) {
+            sum += (double) sample;
+        }
+
+        Latency latency { num_threads, percentile(0.5), percentile(0.99), percentile(0.999), (double) samples.size() / seconds };
+        results.push_back(Result { name, sum / (double) samples.size(), samples.size(), latency });
+
+        std::cout << std::left << std::setw(60) << name << std::right << std::fixed << std::setprecision(0)
+                  << "p50: " << std::setw(8) << latency.p50 << " ns, "
+                  << "p99: " << std::setw(8) << latency.p99 << " ns, "
+                  << "p99.9: " << std::setw(8) << latency.p999 << " ns, "
+                  << std::setw(12) << latency.throughput << " messages/s" << std::endl;
+    }
+
+    void run_logging_benchmarks() {
+        namespace logging = utils::logging;
+
+        // Default console sinks would dominate the measurements
+        logging::get_sink("stdout")->disable();
+        logging::get_sink("stderr")->disable();
+
+        for (SinkType type : { SinkType::Null, SinkType::File, SinkType::Binary }) {
+            for (bool async : { false, true }) {
+                for (std::size_t num_threads = 1u; num_threads <= configuration.max_threads; num_threads *= 2u) {
+                    run_logging(type, async, num_threads);
+                }
+            }
+        }
+
+        logging::get_sink("stdout")->enable();
+        logging::get_sink("stderr")->enable();
+
+        std::filesystem::remove_all(std::filesystem::temp_directory_path() / "utils_benchmarks");
+    }
+
+    // Output
+
+    [[nodiscard]] std::string escape(std::string_view in) {
+        std::string out;
+        for (char c : in) {
+            if (c == '"' || c == '\\') {
+                out += '\\';
+            }
+            out += c;
+        }
+        return out;
+    }
+
+    void write_json(std::ostream& out) {
+        out << std::setprecision(3) << std::fixed;
+        out << "{\n";
+        out << "  \"context\": {\n";
+        out << "    \"date\": \"" << utils::format("{:format=[%Y-%m-%dT%H:%M:%SZ]}", utils::Timestamp::now()) << "\",\n";
+        #if defined(NDEBUG)
+            out << "    \"build_type\": \"release\",\n";
+        #else
+            out << "    \"build_type\": \"debug\",\n";
+        #endif
+        out << "    \"hardware_concurrency\": " << std::thread::hardware_concurrency() << ",\n";
+        out << "    \"quick\": " << (configuration.quick ? "true" : "false") << "\n";
+        out << "  },\n";
+        out << "  \"benchmarks\": [\n";
+
+        for (std::size_t i = 0u; i < results.size(); ++i) {
+            const Result& result = results[i];
+            out << "    { \"name\": \"" << escape(result.name) << "\", \"ns_per_op\": " << result.ns << ", \"iterations\": " << result.iterations;
+
+            if (result.latency) {
+                const Latency& latency = *result.latency;
+                out << ", \"threads\": " << latency.threads
+                    << ", \"p50_ns\": " << latency.p50
+                    << ", \"p99_ns\": " << latency.p99
+                    << ", \"p999_ns\": " << latency.p999
+                    << ", \"throughput\": " << latency.throughput;
+            }
+
+            out << " }" << (i + 1u < results.size() ? "," : "") << "\n";
+        }
+
+        out << "  ]\n";
+        out << "}\n";
+    }
+
+    [[nodiscard]] bool parse_arguments(int argc, char** argv) {
+        for (int i = 1; i < argc; ++i) {
+            std::string_view argument = argv[i];
+
+            if (argument.starts_with("--filter=")) {
+                configuration.filter = argument.substr(9);
+            }
+            else if (argument.starts_with("--json=")) {
+                configuration.json = std::string(argument.substr(7));
+            }
+            else if (argument == "--quick") {
+                configuration.quick = true;
+            }
+            else if (argument.starts_with("--max-threads=")) {
+                utils::ParseResult<std::size_t, utils::ParseError> result = utils::from_string<std::size_t>(argument.substr(14));
+                if (!result.ok() || result.result() == 0u) {
+                    std::cerr << "error: invalid thread count '" << argument.substr(14) << "'" << std::endl;
+                    return false;
+                }
+                configuration.max_threads = result.result();
+            }
+            else {
+                std::cerr << "usage: " << argv[0] << " [--filter=<substring>] [--json=<path>] [--quick] [--max-threads=<count>]" << std::endl;
+                return false;
+            }
+        }
+        return true;
+    }
+
+}
+
+int main(int argc, char** argv) {
+    if (!parse_arguments(argc, argv)) {
+        return 1;
+    }
+
+    run_format_benchmarks();
+    run_parse_benchmarks();
+    run_datetime_benchmarks();
+    run_logging_benchmarks();
+
+    if (configuration.json) {
+        if (*configuration.json == "-") {
+            write_json(std::cout);
+        }
+        else {
+            std::ofstream file(*configuration.json);
+            if (!file.is_open()) {
+                std::cerr << "error: failed to open '" << *configuration.json << "'" << std::endl;
+                return 1;
+            }
+            write_json(file);
+        }
+    }
+
+    return 0;
+}
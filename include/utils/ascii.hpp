@@ -0,0 +1,64 @@
+#pragma once
+
+#ifndef ASCII_HPP
+#define ASCII_HPP
+
+#include <string> // std::string
+#include <string_view> // std::string_view
+#include <span> // std::span
+#include <cstddef> // std::size_t
+
+// Locale-independent character and string functions
+// Only ASCII characters are classified / converted, all other characters (including UTF-8 sequences) are treated as-is
+// All functions that can be used in constant expressions switch to vectorized implementations (SSE2 / NEON) when evaluated at runtime
+
+namespace utils::ascii {
+
+    // Equivalent to the <cctype> functions in the "C" locale
+    [[nodiscard]] constexpr bool is_space(char c); // ' ', '\t', '\n', '\v', '\f', '\r'
+    [[nodiscard]] constexpr bool is_digit(char c);
+    [[nodiscard]] constexpr bool is_alpha(char c);
+    [[nodiscard]] constexpr bool is_alphanumeric(char c);
+    [[nodiscard]] constexpr bool is_upper(char c);
+    [[nodiscard]] constexpr bool is_lower(char c);
+
+    [[nodiscard]] constexpr char to_lower(char c);
+    [[nodiscard]] constexpr char to_upper(char c);
+
+    // Case-insensitive comparison
+    [[nodiscard]] constexpr bool iequals(std::string_view first, std::string_view second);
+
+    // Trims whitespace characters from either (or both) sides of 'in'
+    [[nodiscard]] constexpr std::string_view trim(std::string_view in);
+    [[nodiscard]] constexpr std::string_view trim_left(std::string_view in);
+    [[nodiscard]] constexpr std::string_view trim_right(std::string_view in);
+
+    [[nodiscard]] std::string to_lower(std::string_view in);
+    [[nodiscard]] std::string to_upper(std::string_view in);
+
+    void to_lower_in_place(std::span<char> str);
+    void to_upper_in_place(std::span<char> str);
+
+    // Case-insensitive hash, strings that compare equal with iequals(...) produce the same hash
+    [[nodiscard]] constexpr std::size_t ihash(std::string_view in);
+
+    // Hash and equality functors for case-insensitive keys of unordered containers, ex:
+    //   std::unordered_map<std::string, T, ascii::CaseInsensitiveHash, ascii::CaseInsensitiveEqual>
+    // Both functors are transparent, so lookups by std::string_view / const char* do not construct a temporary key
+
+    struct CaseInsensitiveHash {
+        using is_transparent = void;
+        [[nodiscard]] constexpr std::size_t operator()(std::string_view in) const;
+    };
+
+    struct CaseInsensitiveEqual {
+        using is_transparent = void;
+        [[nodiscard]] constexpr bool operator()(std::string_view first, std::string_view second) const;
+    };
+
+}
+
+// Template definitions.
+#include "utils/detail/ascii.tpp"
+
+#endif // ASCII_HPP
@@ -1,20 +1,46 @@
 
 #pragma once
 
-#include <string> // std::string
+#include <string_view> // std::string_view
 #include <source_location> // std::source_location
+#include <type_traits> // std::type_identity_t
+
+// Keeps failure paths out of line, and out of the way of the code around them
+#if defined(__GNUC__) || defined(__clang__)
+    #define UTILS_COLD __attribute__((cold, noinline))
+#elif defined(_MSC_VER)
+    #define UTILS_COLD __declspec(noinline)
+#else
+    #define UTILS_COLD
+#endif
 
 namespace utils {
     
     template <typename ...Ts>
-    void cppassert(const std::string& expression, bool result, std::source_location source, const std::string& message, const Ts&... args);
+    struct FormatString;
     
-    void cppassert(const std::string& expression, bool result, std::source_location source, const std::string& message);
+    namespace internal {
+        
+        // Reports a failed assertion through logging and aborts
+        // Out of line and marked cold, so that only the condition is evaluated inline (and nothing is allocated) while the assertion holds
+        [[noreturn]] UTILS_COLD void cppassert(const char* expression, std::source_location source, std::string_view message);
+        
+        // Message is formatted only once the assertion has failed
+        template <typename ...Ts>
+        [[noreturn]] UTILS_COLD void cppassert(const char* expression, std::source_location source, FormatString<std::type_identity_t<Ts>...> message, const Ts&... args);
+        
+    }
 
 }
 
 #if !defined NDEBUG
-    #define ASSERT(EXPRESSION, MESSAGE, ...) utils::cppassert(#EXPRESSION, EXPRESSION, std::source_location::current(), MESSAGE, ##__VA_ARGS__)
+    #define ASSERT(EXPRESSION, MESSAGE, ...)                                                                        \
+        do {                                                                                                        \
+            if (!static_cast<bool>(EXPRESSION)) [[unlikely]] {                                                      \
+                utils::internal::cppassert(#EXPRESSION, std::source_location::current(), MESSAGE, ##__VA_ARGS__);   \
+            }                                                                                                       \
+        }                                                                                                           \
+        while (false)
 #else
     #define ASSERT(EXPRESSION, MESSAGE, ...)  \
         do { }                                \
@@ -13,7 +13,7 @@
 #include <unordered_set>
 #include <vector>
 #include <type_traits> // std::true_type, std::false_type
-#include <string> // std::string
+#include <string> // std::string, std::pmr::string
 #include <string_view> // std::string_view
 
 namespace utils {
@@ -195,6 +195,10 @@ namespace utils {
     struct is_integer_type : std::false_type {
     };
     
+    template <>
+    struct is_integer_type<signed char> : std::true_type {
+    };
+    
     template <>
     struct is_integer_type<unsigned char> : std::true_type {
     };
@@ -231,6 +235,10 @@ namespace utils {
     struct is_integer_type<unsigned long long> : std::true_type {
     };
     
+    template <>
+    struct is_integer_type<signed char&> : std::true_type {
+    };
+    
     template <>
     struct is_integer_type<unsigned char&> : std::true_type {
     };
@@ -347,6 +355,11 @@ namespace utils {
     struct is_string_type<std::string> : std::true_type {
     };
     
+    // std::pmr::string
+    template <>
+    struct is_string_type<std::pmr::string> : std::true_type {
+    };
+    
     // std::string_view
     template <>
     struct is_string_type<std::string_view> : std::true_type {
@@ -6,8 +6,13 @@
 
 #include "utils/string.hpp"
 
-#include <cstdint> // std::uint8_t, std::uint16_t, std::uint32_t
+#include <cstdint> // std::uint8_t, std::uint16_t, std::uint32_t, std::int64_t
 #include <chrono> // std::chrono
+#include <string> // std::string
+#include <string_view> // std::string_view
+#include <vector> // std::vector
+#include <memory> // std::shared_ptr
+#include <span> // std::span
 
 namespace utils {
 
@@ -60,6 +65,23 @@ namespace utils {
         std::uint16_t milliseconds; // ranges from 0 to 999
     };
 
+    // Wall clock used by Timestamp::now() and logging
+    class Clock {
+        public:
+            using time_point = std::chrono::system_clock::time_point;
+            
+            enum class Source : std::uint8_t {
+                Precise = 0, // std::chrono::system_clock
+                Coarse, // Cheaper to read, with a resolution of a few milliseconds (CLOCK_REALTIME_COARSE, falls back to the precise clock where not supported)
+            };
+            
+            static time_point now();
+            
+            // Applies to all threads
+            static void set_source(Source source);
+            [[nodiscard]] static Source get_source();
+    };
+    
     struct Date {
         static Date today();
 
@@ -111,6 +133,12 @@ namespace utils {
         static Timestamp now();
 
         Timestamp(); // Returns a timestamp of the current date/time, equivalent to calling Timestamp::now()
+        
+        // Breaks 'time_point' down into a UTC date and time
+        // The breakdown is cached per thread and only recomputed when the second changes, so converting consecutive time points is cheap
+        explicit Timestamp(Clock::time_point time_point);
+        
+        Timestamp(const Date& date, const Time& time);
 
         // Automatically accounts for overflow
         Timestamp(Month month, std::uint8_t day, std::uint32_t year, std::uint32_t hours = 0, std::uint32_t minutes = 0, std::uint32_t seconds = 0, std::uint32_t milliseconds = 0);
@@ -128,6 +156,98 @@ namespace utils {
         Time time;
     };
     
+    // Compact (8-byte) timestamp stored as the number of microseconds since the Unix epoch (UTC)
+    // Cheaper to store, compare, and subtract than Timestamp, which only needs to be constructed to access calendar fields
+    struct EpochTimestamp {
+        static EpochTimestamp now();
+        
+        EpochTimestamp(); // Unix epoch
+        explicit EpochTimestamp(std::int64_t microseconds);
+        explicit EpochTimestamp(Clock::time_point time_point); // Truncated to microseconds
+        explicit EpochTimestamp(const Timestamp& timestamp);
+        ~EpochTimestamp();
+        
+        [[nodiscard]] Timestamp to_timestamp() const;
+        [[nodiscard]] Clock::time_point to_time_point() const;
+        
+        // Difference between two timestamps is signed
+        std::chrono::microseconds operator-(const EpochTimestamp& other) const;
+        
+        EpochTimestamp operator+(std::chrono::microseconds duration) const;
+        EpochTimestamp operator-(std::chrono::microseconds duration) const;
+        EpochTimestamp& operator+=(std::chrono::microseconds duration);
+        EpochTimestamp& operator-=(std::chrono::microseconds duration);
+        
+        bool operator==(const EpochTimestamp& other) const;
+        bool operator!=(const EpochTimestamp& other) const;
+        bool operator<(const EpochTimestamp& other) const;
+        bool operator<=(const EpochTimestamp& other) const;
+        bool operator>(const EpochTimestamp& other) const;
+        bool operator>=(const EpochTimestamp& other) const;
+        
+        std::int64_t microseconds;
+    };
+    
+    // Parsing supports the following layouts (leading whitespace is skipped):
+    //   - ISO-8601: YYYY-MM-DDTHH:MM:SS[.fff][Z | +HH:MM | -HH:MM], 'T' may also be a space
+    //     Fractional seconds may have any number of digits (truncated to milliseconds), timestamps with an offset are converted to UTC
+    //   - Formatter<Timestamp> default layout: MM/DD/YYYY HH:MM:SS:ffff
+    // Date and Time accept the date / time portion of either layout (without an offset)
+    // Fixed-width fields are validated and converted eight characters at a time
+    
+    // Returns the number of characters processed, throws on invalid input (including fields that are out of range)
+    std::size_t from_string(std::string_view in, Timestamp& out);
+    std::size_t from_string(std::string_view in, Date& out);
+    std::size_t from_string(std::string_view in, Time& out);
+    
+    // Non-throwing variants, with the same semantics as the non-throwing variants for fundamental types
+    template <>
+    [[nodiscard]] ParseResult<Timestamp, ParseError> from_string<Timestamp>(std::string_view in);
+    
+    template <>
+    [[nodiscard]] ParseResult<Date, ParseError> from_string<Date>(std::string_view in);
+    
+    template <>
+    [[nodiscard]] ParseResult<Time, ParseError> from_string<Time>(std::string_view in);
+    
+    // Timestamps are parsed directly into EpochTimestamps, without constructing an intermediate Timestamp
+    // Same semantics as the bulk variants for fundamental types, fields that cannot be parsed are set to the Unix epoch
+    template <>
+    BulkParseResult from_string<EpochTimestamp>(std::span<const std::string_view> in, std::span<EpochTimestamp> out);
+    
+    template <>
+    BulkParseResult parse_column<EpochTimestamp>(std::string_view buffer, char delimiter, std::span<EpochTimestamp> out);
+    
+    // Date / time layout compiled into a sequence of literals and fields, which are written out directly from digit tables
+    // Supports strftime-style conversions:
+    //   - %Y: year, %m: month (01 - 12), %d: day (01 - 31)
+    //   - %B / %b: full / abbreviated month name, %A / %a: full / abbreviated weekday name
+    //   - %H: hour (00 - 23), %M: minute (00 - 59), %S: second (00 - 59), %f: millisecond (000 - 999)
+    //   - %F: equivalent to %Y-%m-%d, %T: equivalent to %H:%M:%S, %%: '%'
+    // as well as placeholders (day, weekday, month, year, hour, minute, second, millisecond, date, time)
+    // Placeholders accept width, fill, and justification specifiers, representation (for month and weekday), and format (for date and time)
+    // Unknown conversions are written out as literals, unknown placeholders raise an exception
+    class TimestampPattern {
+        public:
+            explicit TimestampPattern(std::string_view pattern);
+            ~TimestampPattern();
+            
+            // Everything before the first millisecond field only changes once per second, and is cached per thread
+            void format_to(const Date& date, const Time& time, FormatBuffer& out) const;
+            
+        private:
+            struct Field;
+            
+            void compile(std::string_view pattern);
+            void append_literal(std::string_view literal);
+            
+            void render(const Field* first, const Field* last, const Date& date, const Time& time, FormatBuffer& out) const;
+            
+            std::vector<Field> m_fields;
+            std::size_t m_prefix_length; // Number of fields before the first millisecond field
+            std::uint64_t m_id; // Identifies the pattern in the per-thread prefix cache
+    };
+    
     // datetime Formatter definitions
     
     template <>
@@ -193,9 +313,10 @@ namespace utils {
             
             void parse(const FormatSpec& spec);
             std::string format(const Date& date) const;
+            void format_to(const Date& date, FormatBuffer& out) const;
             
         private:
-            std::string_view m_format;
+            std::shared_ptr<const TimestampPattern> m_pattern;
     };
     
     template <>
@@ -206,9 +327,10 @@ namespace utils {
             
             void parse(const FormatSpec& spec);
             std::string format(const Time& time) const;
+            void format_to(const Time& time, FormatBuffer& out) const;
             
         private:
-            std::string_view m_format;
+            std::shared_ptr<const TimestampPattern> m_pattern;
     };
     
     template <>
@@ -219,9 +341,10 @@ namespace utils {
             
             void parse(const FormatSpec& spec);
             std::string format(const Timestamp& timestamp) const;
+            void format_to(const Timestamp& timestamp, FormatBuffer& out) const;
             
         private:
-            std::string_view m_format;
+            std::shared_ptr<const TimestampPattern> m_pattern;
     };
     
 }
@@ -0,0 +1,166 @@
+#pragma once
+
+#ifndef ASCII_TPP
+#define ASCII_TPP
+
+#include <cstdint> // std::uint64_t
+#include <cstring> // std::memcpy
+#include <bit> // std::endian
+#include <type_traits> // std::is_constant_evaluated
+
+namespace utils::ascii {
+
+    namespace detail {
+
+        // Vectorized implementations, defined in ascii.cpp
+        bool iequals(const char* first, const char* second, std::size_t length);
+        std::size_t count_leading_spaces(const char* data, std::size_t length);
+        std::size_t count_trailing_spaces(const char* data, std::size_t length);
+
+        // Folds ASCII uppercase characters to lowercase in all 8 bytes of 'word' at once
+        constexpr std::uint64_t fold_lower(std::uint64_t word) {
+            // The high bit of each byte is set after the addition if the (7-bit) byte is >= 'A' / > 'Z' respectively
+            std::uint64_t heptets = word & 0x7F7F7F7F7F7F7F7Full;
+            std::uint64_t above_a = heptets + 0x3F3F3F3F3F3F3F3Full;
+            std::uint64_t above_z = heptets + 0x2525252525252525ull;
+            std::uint64_t is_upper = (above_a ^ above_z) & ~word & 0x8080808080808080ull;
+            return word | (is_upper >> 2u);
+        }
+
+        // Loads (at most 8) characters into a word, in little endian order
+        constexpr std::uint64_t load_word(const char* data, std::size_t length) {
+            if (!std::is_constant_evaluated() && std::endian::native == std::endian::little && length == 8u) {
+                std::uint64_t word;
+                std::memcpy(&word, data, sizeof(word));
+                return word;
+            }
+
+            std::uint64_t word = 0u;
+            for (std::size_t i = 0u; i < length; ++i) {
+                word |= static_cast<std::uint64_t>(static_cast<unsigned char>(data[i])) << (i * 8u);
+            }
+            return word;
+        }
+
+    }
+
+    constexpr bool is_space(char c) {
+        return c == ' ' || (c >= '\t' && c <= '\r');
+    }
+
+    constexpr bool is_digit(char c) {
+        return c >= '0' && c <= '9';
+    }
+
+    constexpr bool is_alpha(char c) {
+        return is_lower(c) || is_upper(c);
+    }
+
+    constexpr bool is_alphanumeric(char c) {
+        return is_alpha(c) || is_digit(c);
+    }
+
+    constexpr bool is_upper(char c) {
+        return c >= 'A' && c <= 'Z';
+    }
+
+    constexpr bool is_lower(char c) {
+        return c >= 'a' && c <= 'z';
+    }
+
+    constexpr char to_lower(char c) {
+        return is_upper(c) ? static_cast<char>(c - 'A' + 'a') : c;
+    }
+
+    constexpr char to_upper(char c) {
+        return is_lower(c) ? static_cast<char>(c - 'a' + 'A') : c;
+    }
+
+    constexpr bool iequals(std::string_view first, std::string_view second) {
+        if (first.length() != second.length()) {
+            return false;
+        }
+
+        // Short strings (such as identifiers) are compared inline, as the overhead of a function call outweighs the benefits of vectorization
+        if (std::is_constant_evaluated() || first.length() < 16u) {
+            for (std::size_t i = 0u; i < first.length(); ++i) {
+                if (to_lower(first[i]) != to_lower(second[i])) {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        return detail::iequals(first.data(), second.data(), first.length());
+    }
+
+    constexpr std::string_view trim_left(std::string_view in) {
+        if (std::is_constant_evaluated()) {
+            std::size_t start = 0u;
+            while (start < in.length() && is_space(in[start])) {
+                ++start;
+            }
+            return in.substr(start);
+        }
+
+        // Most strings do not start with whitespace
+        if (in.empty() || !is_space(in.front())) {
+            return in;
+        }
+        return in.substr(detail::count_leading_spaces(in.data(), in.length()));
+    }
+
+    constexpr std::string_view trim_right(std::string_view in) {
+        if (std::is_constant_evaluated()) {
+            std::size_t end = in.length();
+            while (end > 0u && is_space(in[end - 1u])) {
+                --end;
+            }
+            return in.substr(0u, end);
+        }
+
+        // Most strings do not end with whitespace
+        if (in.empty() || !is_space(in.back())) {
+            return in;
+        }
+        return in.substr(0u, in.length() - detail::count_trailing_spaces(in.data(), in.length()));
+    }
+
+    constexpr std::string_view trim(std::string_view in) {
+        return trim_right(trim_left(in));
+    }
+
+    constexpr std::size_t ihash(std::string_view in) {
+        // Characters are folded and mixed 8 at a time
+        std::uint64_t hash = 0x9E3779B97F4A7C15ull ^ in.length();
+
+        const char* data = in.data();
+        std::size_t length = in.length();
+
+        while (length) {
+            std::size_t count = length < 8u ? length : 8u;
+
+            hash ^= detail::fold_lower(detail::load_word(data, count));
+            hash *= 0xBF58476D1CE4E5B9ull;
+            hash ^= hash >> 31u;
+
+            data += count;
+            length -= count;
+        }
+
+        hash *= 0x94D049BB133111EBull;
+        hash ^= hash >> 29u;
+        return static_cast<std::size_t>(hash);
+    }
+
+    constexpr std::size_t CaseInsensitiveHash::operator()(std::string_view in) const {
+        return ihash(in);
+    }
+
+    constexpr bool CaseInsensitiveEqual::operator()(std::string_view first, std::string_view second) const {
+        return iequals(first, second);
+    }
+
+}
+
+#endif // ASCII_TPP
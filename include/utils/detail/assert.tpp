@@ -6,15 +6,10 @@
 namespace utils {
     namespace internal {
         
-        [[noreturn]] inline void cppassert(const std::string& expression, std::source_location source, const std::string& message);
-        
-    }
-    
-    template <typename ...Ts>
-    void cppassert(const std::string& expression, bool result, std::source_location source, const std::string& message, const Ts&... args) {
-        if (!result) {
-            internal::cppassert(expression, source, utils::format(message, args...));
+        template <typename ...Ts>
+        void cppassert(const char* expression, std::source_location source, FormatString<std::type_identity_t<Ts>...> message, const Ts&... args) {
+            cppassert(expression, source, std::string_view(utils::format(message, args...)));
         }
+        
     }
-    
 }
@@ -20,6 +20,69 @@ namespace utils {
 
         return total;
     }
+    
+    // EpochTimestamp operations are defined inline so that they compile down to plain integer arithmetic when processing timestamps in bulk
+    
+    inline EpochTimestamp::EpochTimestamp() : microseconds(0) {
+    }
+    
+    inline EpochTimestamp::EpochTimestamp(std::int64_t microseconds) : microseconds(microseconds) {
+    }
+    
+    inline EpochTimestamp::EpochTimestamp(Clock::time_point time_point) : microseconds(std::chrono::floor<std::chrono::microseconds>(time_point.time_since_epoch()).count()) {
+    }
+    
+    inline EpochTimestamp::~EpochTimestamp() = default;
+    
+    inline Clock::time_point EpochTimestamp::to_time_point() const {
+        return Clock::time_point(std::chrono::duration_cast<Clock::time_point::duration>(std::chrono::microseconds(microseconds)));
+    }
+    
+    inline std::chrono::microseconds EpochTimestamp::operator-(const EpochTimestamp& other) const {
+        return std::chrono::microseconds(microseconds - other.microseconds);
+    }
+    
+    inline EpochTimestamp EpochTimestamp::operator+(std::chrono::microseconds duration) const {
+        return EpochTimestamp(microseconds + duration.count());
+    }
+    
+    inline EpochTimestamp EpochTimestamp::operator-(std::chrono::microseconds duration) const {
+        return EpochTimestamp(microseconds - duration.count());
+    }
+    
+    inline EpochTimestamp& EpochTimestamp::operator+=(std::chrono::microseconds duration) {
+        microseconds += duration.count();
+        return *this;
+    }
+    
+    inline EpochTimestamp& EpochTimestamp::operator-=(std::chrono::microseconds duration) {
+        microseconds -= duration.count();
+        return *this;
+    }
+    
+    inline bool EpochTimestamp::operator==(const EpochTimestamp& other) const {
+        return microseconds == other.microseconds;
+    }
+    
+    inline bool EpochTimestamp::operator!=(const EpochTimestamp& other) const {
+        return microseconds != other.microseconds;
+    }
+    
+    inline bool EpochTimestamp::operator<(const EpochTimestamp& other) const {
+        return microseconds < other.microseconds;
+    }
+    
+    inline bool EpochTimestamp::operator<=(const EpochTimestamp& other) const {
+        return microseconds <= other.microseconds;
+    }
+    
+    inline bool EpochTimestamp::operator>(const EpochTimestamp& other) const {
+        return microseconds > other.microseconds;
+    }
+    
+    inline bool EpochTimestamp::operator>=(const EpochTimestamp& other) const {
+        return microseconds >= other.microseconds;
+    }
 
 }
 
@@ -7,7 +7,7 @@
 namespace utils {
     
     template <typename ...Ts>
-    FormattedError::FormattedError(std::string_view fmt, const Ts&... args) : std::runtime_error(utils::format(fmt, args...)) {
+    FormattedError::FormattedError(FormatString<std::type_identity_t<Ts>...> fmt, const Ts&... args) : std::runtime_error(utils::format(fmt, args...)) {
     }
     
 }
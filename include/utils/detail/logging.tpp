@@ -6,55 +6,269 @@
 
 #include "utils/string.hpp"
 
+#include <cstring> // std::memcpy
+#include <type_traits> // std::is_integral, std::is_signed, std::is_trivially_copyable
+
 namespace utils::logging {
     
+    // Message constructors are defined inline so that calls for disabled levels are (almost) free
+    
+    inline Message::Message(const std::string& fmt, std::source_location source) : level(Level::Debug),
+                                                                                  format(fmt),
+                                                                                  source(source),
+                                                                                  timestamp(),
+                                                                                  message() {
+    }
+    
+    inline Message::Message(std::string_view fmt, std::source_location source) : level(Level::Debug),
+                                                                                format(fmt),
+                                                                                source(source),
+                                                                                timestamp(),
+                                                                                message() {
+    }
+    
+    inline Message::Message(const char* fmt, std::source_location source) : level(Level::Debug),
+                                                                           format(fmt),
+                                                                           source(source),
+                                                                           timestamp(),
+                                                                           message() {
+    }
+    
+    inline Message::~Message() = default;
+    
     namespace detail {
         
         void log(Message& message);
+        void log(const BinaryRecord& record);
         void add_sink(const std::shared_ptr<Sink>& sink);
+        
+        // Lowest level across all enabled sinks, or a value above all levels if no sink is enabled
+        // Kept up to date by the logger whenever a sink is created / destroyed, or the level / state of a sink changes
+        inline std::atomic<std::uint8_t> min_enabled_level { 0u };
+        
+        // Messages that would be discarded by every sink are rejected before they are formatted (or timestamped)
+        // The compile-time check folds away for levels below UTILS_LOG_MIN_LEVEL, removing the entire call
+        inline bool is_enabled(Message::Level level) {
+            return static_cast<int>(level) >= UTILS_LOG_MIN_LEVEL && static_cast<std::uint8_t>(level) >= min_enabled_level.load(std::memory_order_relaxed);
+        }
+        
+        // Writes the fields of a message record that do not depend on the message arguments, returns the format ID of the message
+        std::uint32_t begin_record(std::pmr::string& record, Message::Level level, const Message& message);
+        
+        template <typename T>
+        void write_value(std::pmr::string& record, const T& value) {
+            static_assert(std::is_trivially_copyable<T>::value, "values written to binary records must be trivially copyable");
+            record.append(reinterpret_cast<const char*>(&value), sizeof(T));
+        }
+        
+        inline void write_string(std::pmr::string& record, std::string_view value) {
+            write_value(record, static_cast<std::uint32_t>(value.length()));
+            record.append(value);
+        }
+        
+        template <typename T>
+        constexpr ArgumentType integer_argument_type() {
+            switch (sizeof(T)) {
+                case 1:
+                    return std::is_signed<T>::value ? ArgumentType::Int8 : ArgumentType::UInt8;
+                case 2:
+                    return std::is_signed<T>::value ? ArgumentType::Int16 : ArgumentType::UInt16;
+                case 4:
+                    return std::is_signed<T>::value ? ArgumentType::Int32 : ArgumentType::UInt32;
+                default:
+                    return std::is_signed<T>::value ? ArgumentType::Int64 : ArgumentType::UInt64;
+            }
+        }
+        
+        template <typename T>
+        void write_argument(std::pmr::string& record, const T& value) {
+            if constexpr (is_named_argument<T>::value) {
+                write_value(record, ArgumentType::Named);
+                write_string(record, value.name);
+                write_argument(record, value.value);
+            }
+            else if constexpr (std::is_same<T, char>::value) {
+                write_value(record, ArgumentType::Char);
+                write_value(record, value);
+            }
+            else if constexpr (std::is_integral<T>::value && sizeof(T) <= 8u) {
+                // Integers are stored as the fixed-width type with the same size and signedness
+                write_value(record, integer_argument_type<T>());
+                write_value(record, value);
+            }
+            else if constexpr (std::is_same<T, float>::value) {
+                write_value(record, ArgumentType::Float);
+                write_value(record, value);
+            }
+            else if constexpr (std::is_same<T, double>::value) {
+                write_value(record, ArgumentType::Double);
+                write_value(record, value);
+            }
+            else if constexpr (std::is_convertible<const T&, std::string_view>::value) {
+                // std::string, std::string_view, const char*, character arrays
+                write_value(record, ArgumentType::String);
+                write_string(record, std::string_view(value));
+            }
+            else if constexpr (std::is_pointer<T>::value || std::is_null_pointer<T>::value) {
+                write_value(record, ArgumentType::Pointer);
+                write_value(record, reinterpret_cast<std::uintptr_t>(static_cast<const void*>(value)));
+            }
+            else {
+                // Types that cannot be reconstructed by the decoder are formatted up front
+                write_value(record, ArgumentType::String);
+                write_string(record, utils::format(record.get_allocator().resource(), "{}", value));
+            }
+        }
+        
+        template <typename ...Ts>
+        void log_deferred(Message::Level level, const Message& message, const Ts&... args) {
+            static_assert(sizeof...(Ts) <= max_deferred_arguments, "deferred messages support at most 12 arguments (the limit of the decoder)");
+            
+            MessageArena arena;
+            std::pmr::string record(arena.resource());
+            record.reserve(256u);
+            
+            std::uint32_t id = begin_record(record, level, message);
+            write_value(record, static_cast<std::uint8_t>(sizeof...(Ts)));
+            (write_argument(record, args), ...);
+            
+            // Patch the size of the record, which excludes the record type and the size itself
+            std::uint32_t size = static_cast<std::uint32_t>(record.length() - sizeof(RecordType) - sizeof(std::uint32_t));
+            std::memcpy(record.data() + sizeof(RecordType), &size, sizeof(size));
+            
+            detail::log(BinaryRecord { level, id, record });
+        }
     
     }
     
     template <typename ...Ts>
     void info(Message message, const Ts&... args) {
-        message.message = utils::format(message.format, args..., NamedArgument("__source", message.source));
+        if (!detail::is_enabled(Message::Level::Info)) {
+            return;
+        }
+        
+        if (deferred_formatting_enabled()) {
+            detail::log_deferred(Message::Level::Info, message, args...);
+            return;
+        }
+        
+        message.timestamp = Clock::now();
+        
+        detail::MessageArena arena;
+        std::pmr::string str = utils::format(arena.resource(), message.format, args..., NamedArgument("__source", message.source));
+        
+        message.message = str;
         message.level = Message::Level::Info;
         detail::log(message);
     }
     
     template <typename ...Ts>
     void debug(Message message, const Ts&... args) {
-        message.message = utils::format(message.format, args..., NamedArgument("__source", message.source));
+        if (!detail::is_enabled(Message::Level::Debug)) {
+            return;
+        }
+        
+        if (deferred_formatting_enabled()) {
+            detail::log_deferred(Message::Level::Debug, message, args...);
+            return;
+        }
+        
+        message.timestamp = Clock::now();
+        
+        detail::MessageArena arena;
+        std::pmr::string str = utils::format(arena.resource(), message.format, args..., NamedArgument("__source", message.source));
+        
+        message.message = str;
         message.level = Message::Level::Debug;
         detail::log(message);
     }
     
     template <typename ...Ts>
     void warning(Message message, const Ts&... args) {
-        message.message = utils::format(message.format, args..., NamedArgument("__source", message.source));
+        if (!detail::is_enabled(Message::Level::Warning)) {
+            return;
+        }
+        
+        if (deferred_formatting_enabled()) {
+            detail::log_deferred(Message::Level::Warning, message, args...);
+            return;
+        }
+        
+        message.timestamp = Clock::now();
+        
+        detail::MessageArena arena;
+        std::pmr::string str = utils::format(arena.resource(), message.format, args..., NamedArgument("__source", message.source));
+        
+        message.message = str;
         message.level = Message::Level::Warning;
         detail::log(message);
     }
     
     template <typename ...Ts>
     void error(Message message, const Ts&... args) {
-        message.message = utils::format(message.format, args..., NamedArgument("__source", message.source));
+        if (!detail::is_enabled(Message::Level::Error)) {
+            return;
+        }
+        
+        if (deferred_formatting_enabled()) {
+            detail::log_deferred(Message::Level::Error, message, args...);
+            return;
+        }
+        
+        message.timestamp = Clock::now();
+        
+        detail::MessageArena arena;
+        std::pmr::string str = utils::format(arena.resource(), message.format, args..., NamedArgument("__source", message.source));
+        
+        message.message = str;
         message.level = Message::Level::Error;
         detail::log(message);
     }
     
     template <typename ...Ts>
     void fatal(Message message, const Ts&... args) {
+        message.timestamp = Clock::now();
         std::string str = utils::format(message.format, args..., NamedArgument("__source", message.source));
         
         // Log error message
-        message.message = str;
-        message.level = Message::Level::Error;
-        detail::log(message);
+        if (deferred_formatting_enabled()) {
+            detail::log_deferred(Message::Level::Error, message, args...);
+        }
+        else {
+            message.message = str;
+            message.level = Message::Level::Error;
+            detail::log(message);
+        }
+        
+        // Ensure the message is written out before the exception is raised, in case it terminates the program
+        flush();
         
         throw std::runtime_error(str);
     }
     
+    namespace detail {
+        
+        // Used by the LOG_* macros, which take the level as a value
+        template <typename ...Ts>
+        void log_at(Message::Level level, Message message, const Ts&... args) {
+            switch (level) {
+                case Message::Level::Debug:
+                    debug(message, args...);
+                    break;
+                case Message::Level::Info:
+                    info(message, args...);
+                    break;
+                case Message::Level::Warning:
+                    warning(message, args...);
+                    break;
+                case Message::Level::Error:
+                    error(message, args...);
+                    break;
+            }
+        }
+        
+    }
+    
     template <typename T, typename ...Ts>
     std::shared_ptr<T> create_sink(Ts&&... args) {
         static_assert(std::is_base_of<Sink, T>::value, "type provided to create_sink must derive from Sink");
@@ -7,7 +7,10 @@
 #include "utils/constexpr.hpp"
 #include "utils/string.hpp"
 
-#include <utility> // std::move
+#include <utility> // std::move, std::forward
+#include <variant> // std::get_if, std::in_place_index
+#include <functional> // std::invoke
+#include <type_traits> // std::invoke_result_t, std::remove_cvref_t
 #include <stdexcept> // std::runtime_error
 #include <regex>
 
@@ -27,8 +30,8 @@ namespace utils {
     template <typename ...Ts>
     Response<E> Response<E>::NOT_OK(Ts&& ...args) {
         Response<E> e { };
-        e.m_error = { std::move(args)... };
-        return std::move(e);
+        e.m_error.emplace(std::forward<Ts>(args)...);
+        return e;
     }
     
     template <typename E>
@@ -37,56 +40,152 @@ namespace utils {
     }
     
     template <typename E>
-    const E& Response<E>::error() const {
-        if (!m_error.has_value()) {
-            throw std::runtime_error("error() called on Result that is ok!");
+    const E& Response<E>::error() const& {
+        if (m_error.has_value()) [[likely]] {
+            return *m_error;
         }
         
-        return m_error.value();
+        throw std::runtime_error("error() called on Result that is ok!");
+    }
+    
+    template <typename E>
+    E&& Response<E>::error() && {
+        if (m_error.has_value()) [[likely]] {
+            return std::move(*m_error);
+        }
+        
+        throw std::runtime_error("error() called on Result that is ok!");
     }
     
     // Result implementation
     
     template <typename T, typename E>
-    Result<T, E>::Result() = default;
+    template <std::size_t I, typename ...Ts>
+    Result<T, E>::Result(std::in_place_index_t<I> index, Ts&&... args) : m_storage(index, std::forward<Ts>(args)...) {
+    }
     
     template <typename T, typename E>
     template <typename ...Ts>
     Result<T, E> Result<T, E>::OK(Ts&&... args) {
-        Result<T, E> r { };
-        r.m_result = { std::move(args)... };
-        return std::move(r);
+        return Result<T, E>(std::in_place_index<0>, std::forward<Ts>(args)...);
     }
     
     template <typename T, typename E>
     template <typename ...Ts>
     Result<T, E> Result<T, E>::NOT_OK(Ts&&... args) {
-        Result<T, E> e { };
-        e.m_error = { std::move(args)... };
-        return std::move(e);
+        return Result<T, E>(std::in_place_index<1>, std::forward<Ts>(args)...);
     }
     
     template <typename T, typename E>
     bool Result<T, E>::ok() const {
-        return m_result.has_value();
+        return m_storage.index() == 0u;
     }
-
+    
+    // Accessors check the held alternative once, std::get would check it again
+    
+    template <typename T, typename E>
+    T& Result<T, E>::result() & {
+        if (ok()) [[likely]] {
+            return *std::get_if<0>(&m_storage);
+        }
+        
+        throw std::runtime_error("result() called on Result that is not ok!");
+    }
+    
+    template <typename T, typename E>
+    const T& Result<T, E>::result() const& {
+        if (ok()) [[likely]] {
+            return *std::get_if<0>(&m_storage);
+        }
+        
+        throw std::runtime_error("result() called on Result that is not ok!");
+    }
+    
     template <typename T, typename E>
-    T& Result<T, E>::result() {
-        if (!m_result.has_value()) {
-            throw std::runtime_error("result() called on Result that is not ok!");
+    T&& Result<T, E>::result() && {
+        if (ok()) [[likely]] {
+            return std::move(*std::get_if<0>(&m_storage));
         }
         
-        return m_result.value();
+        throw std::runtime_error("result() called on Result that is not ok!");
     }
     
     template <typename T, typename E>
-    const E& Result<T, E>::error() const {
-        if (!m_error.has_value()) {
-            throw std::runtime_error("error() called on Result that is ok!");
+    const E& Result<T, E>::error() const& {
+        if (!ok()) [[likely]] {
+            return *std::get_if<1>(&m_storage);
         }
         
-        return m_error.value();
+        throw std::runtime_error("error() called on Result that is ok!");
+    }
+    
+    template <typename T, typename E>
+    E&& Result<T, E>::error() && {
+        if (!ok()) [[likely]] {
+            return std::move(*std::get_if<1>(&m_storage));
+        }
+        
+        throw std::runtime_error("error() called on Result that is ok!");
+    }
+    
+    template <typename T, typename E>
+    template <typename Fn>
+    auto Result<T, E>::and_then(Fn&& fn) const& {
+        using R = std::remove_cvref_t<std::invoke_result_t<Fn, const T&>>;
+        if (ok()) {
+            return std::invoke(std::forward<Fn>(fn), *std::get_if<0>(&m_storage));
+        }
+        return R::NOT_OK(*std::get_if<1>(&m_storage));
+    }
+    
+    template <typename T, typename E>
+    template <typename Fn>
+    auto Result<T, E>::and_then(Fn&& fn) && {
+        using R = std::remove_cvref_t<std::invoke_result_t<Fn, T&&>>;
+        if (ok()) {
+            return std::invoke(std::forward<Fn>(fn), std::move(*std::get_if<0>(&m_storage)));
+        }
+        return R::NOT_OK(std::move(*std::get_if<1>(&m_storage)));
+    }
+    
+    template <typename T, typename E>
+    template <typename Fn>
+    auto Result<T, E>::transform(Fn&& fn) const& {
+        using U = std::remove_cvref_t<std::invoke_result_t<Fn, const T&>>;
+        if (ok()) {
+            return Result<U, E>::OK(std::invoke(std::forward<Fn>(fn), *std::get_if<0>(&m_storage)));
+        }
+        return Result<U, E>::NOT_OK(*std::get_if<1>(&m_storage));
+    }
+    
+    template <typename T, typename E>
+    template <typename Fn>
+    auto Result<T, E>::transform(Fn&& fn) && {
+        using U = std::remove_cvref_t<std::invoke_result_t<Fn, T&&>>;
+        if (ok()) {
+            return Result<U, E>::OK(std::invoke(std::forward<Fn>(fn), std::move(*std::get_if<0>(&m_storage))));
+        }
+        return Result<U, E>::NOT_OK(std::move(*std::get_if<1>(&m_storage)));
+    }
+    
+    template <typename T, typename E>
+    template <typename Fn>
+    auto Result<T, E>::or_else(Fn&& fn) const& {
+        using R = std::remove_cvref_t<std::invoke_result_t<Fn, const E&>>;
+        if (!ok()) {
+            return std::invoke(std::forward<Fn>(fn), *std::get_if<1>(&m_storage));
+        }
+        return R::OK(*std::get_if<0>(&m_storage));
+    }
+    
+    template <typename T, typename E>
+    template <typename Fn>
+    auto Result<T, E>::or_else(Fn&& fn) && {
+        using R = std::remove_cvref_t<std::invoke_result_t<Fn, E&&>>;
+        if (!ok()) {
+            return std::invoke(std::forward<Fn>(fn), std::move(*std::get_if<1>(&m_storage)));
+        }
+        return R::OK(std::move(*std::get_if<0>(&m_storage)));
     }
     
     // ParseResponse implementation
@@ -100,7 +199,7 @@ namespace utils {
     ParseResponse<E> ParseResponse<E>::OK(std::size_t num_characters_parsed) {
         ParseResponse<E> r { };
         r.m_offset = num_characters_parsed;
-        return std::move(r);
+        return r;
     }
     
     template <typename E>
@@ -108,8 +207,8 @@ namespace utils {
     ParseResponse<E> ParseResponse<E>::NOT_OK(std::size_t error_position, Ts&&... args) {
         ParseResponse<E> e { };
         e.m_offset = error_position;
-        e.Response<E>::m_error = { std::move(args)... };
-        return std::move(e);
+        e.Response<E>::m_error.emplace(std::forward<Ts>(args)...);
+        return e;
     }
     
     template <typename E>
@@ -117,39 +216,51 @@ namespace utils {
         return m_offset;
     }
     
-    // ParsedResult implementation
+    // ParseResult implementation
     
     template <typename T, typename E>
-    ParseResult<T, E>::ParseResult() : Result<T, E>(),
-                                       m_offset(0u) {
+    template <std::size_t I, typename ...Ts>
+    ParseResult<T, E>::ParseResult(std::size_t offset, std::in_place_index_t<I> index, Ts&&... args) : Result<T, E>(index, std::forward<Ts>(args)...),
+                                                                                                       m_offset(offset) {
     }
     
     template <typename T, typename E>
     template <typename ...Ts>
     ParseResult<T, E> ParseResult<T, E>::OK(std::size_t num_characters_parsed, Ts&& ...args) {
-        ParseResult<T, E> r { };
-        r.m_offset = num_characters_parsed;
-        r.Result<T, E>::m_result = { std::move(args)... };
-        return std::move(r);
+        return ParseResult<T, E>(num_characters_parsed, std::in_place_index<0>, std::forward<Ts>(args)...);
     }
     
     template <typename T, typename E>
     template <typename ...Ts>
     ParseResult<T, E> ParseResult<T, E>::NOT_OK(std::size_t error_position, Ts&& ... args) {
-        ParseResult<T, E> e { };
-        e.m_offset = error_position;
-        e.Result<T, E>::m_error = { std::move(args)... };
-        return std::move(e);
+        return ParseResult<T, E>(error_position, std::in_place_index<1>, std::forward<Ts>(args)...);
     }
-
-    template <typename T, typename E>
-    ParseResult<T, E>::~ParseResult() = default;
     
     template <typename T, typename E>
     std::size_t ParseResult<T, E>::offset() const {
         return m_offset;
     }
     
+    template <typename T, typename E>
+    template <typename Fn>
+    auto ParseResult<T, E>::transform(Fn&& fn) const& {
+        using U = std::remove_cvref_t<std::invoke_result_t<Fn, const T&>>;
+        if (this->ok()) {
+            return ParseResult<U, E>::OK(m_offset, std::invoke(std::forward<Fn>(fn), *std::get_if<0>(&this->m_storage)));
+        }
+        return ParseResult<U, E>::NOT_OK(m_offset, *std::get_if<1>(&this->m_storage));
+    }
+    
+    template <typename T, typename E>
+    template <typename Fn>
+    auto ParseResult<T, E>::transform(Fn&& fn) && {
+        using U = std::remove_cvref_t<std::invoke_result_t<Fn, T&&>>;
+        if (this->ok()) {
+            return ParseResult<U, E>::OK(m_offset, std::invoke(std::forward<Fn>(fn), std::move(*std::get_if<0>(&this->m_storage))));
+        }
+        return ParseResult<U, E>::NOT_OK(m_offset, std::move(*std::get_if<1>(&this->m_storage)));
+    }
+    
 }
 
 #endif // RESULT_TPP
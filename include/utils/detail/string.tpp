@@ -5,46 +5,816 @@
 #define STRING_TPP
 
 #include "utils/result.hpp"
+#include "utils/ascii.hpp"
 #include "utils/assert.hpp"
 #include "utils/tuple.hpp"
 
 #include <charconv> // std::to_chars
-#include <cmath> // std::log10
+#include <cmath> // std::signbit
+#include <limits> // std::numeric_limits
+#include <cstring> // std::memcpy, std::memset
+#include <algorithm> // std::min, std::copy
+#include <bit> // std::bit_width, std::countl_zero, std::endian
 
 namespace utils {
 
     namespace detail {
 
-        struct Identifier {
-            Identifier();
-            Identifier(std::size_t position);
-            Identifier(std::string_view name);
-            ~Identifier();
+        // Lookup tables for integer formatting
+        inline constexpr char decimal_digit_pairs[] = "00010203040506070809101112131415161718192021222324252627282930313233343536373839404142434445464748495051525354555657585960616263646566676869707172737475767778798081828384858687888990919293949596979899";
+        inline constexpr char hexadecimal_digits[] = "0123456789abcdef";
+        inline constexpr char binary_nibbles[] = "0000000100100011010001010110011110001001101010111100110111101111"; // Binary representation of each 4-bit value
+        inline constexpr std::uint64_t powers_of_10[] = { 1u, 10u, 100u, 1000u, 10000u, 100000u, 1000000u, 10000000u, 100000000u, 1000000000u, 10000000000u, 100000000000u, 1000000000000u, 10000000000000u, 100000000000000u, 1000000000000000u, 10000000000000000u, 100000000000000000u, 1000000000000000000u, 10000000000000000000u };
+        
+        // Returns the number of decimal digits required to represent 'value'
+        constexpr std::size_t count_decimal_digits(std::uint64_t value) {
+            // The number of significant bits approximates log10(value) (1233 / 4096 ~= log10(2)), which is off by at most one and corrected with a single comparison
+            // Setting the lowest bit only changes the result for 0, which requires 1 digit
+            value |= 1u;
+            std::size_t approximation = ((64u - std::countl_zero(value)) * 1233u) >> 12u;
+            return approximation + 1u - (value < powers_of_10[approximation]);
+        }
+        
+        // Writes the decimal digits of 'value' backwards, ending at 'end', and returns a pointer to the first digit
+        template <typename U>
+        char* write_decimal_digits(U value, char* end) {
+            while (value >= 100u) {
+                end -= 2;
+                std::memcpy(end, decimal_digit_pairs + (value % 100u) * 2u, 2u);
+                value /= 100u;
+            }
             
-            bool operator==(const Identifier& other) const;
+            if (value >= 10u) {
+                end -= 2;
+                std::memcpy(end, decimal_digit_pairs + value * 2u, 2u);
+            }
+            else {
+                *--end = static_cast<char>('0' + value);
+            }
             
-            enum class Type {
-                Auto = 0,
-                Position,
-                Name,
-            } type;
+            return end;
+        }
+        
+        // Writes the decimal digits of 'value' backwards, ending at 'end', with 'separator' inserted between every group of 3 digits
+        template <typename U>
+        char* write_decimal_digits(U value, char* end, char separator) {
+            while (value >= 1000u) {
+                U group = value % 1000u;
+                value /= 1000u;
+                
+                end -= 3;
+                end[0] = static_cast<char>('0' + group / 100u);
+                std::memcpy(end + 1, decimal_digit_pairs + (group % 100u) * 2u, 2u);
+                *--end = separator;
+            }
             
-            // This layout has the same size as std::variant<std::size_t, std::string>
-            // Prefer this way so that accessing the underlying identifier is easier
-            std::size_t position;
-            std::string_view name;
-        };
+            return write_decimal_digits(value, end);
+        }
+        
+        // Parsing 8 digits at a time relies on loading characters into an integer in little endian order
+        inline constexpr bool swar_available = std::endian::native == std::endian::little;
+        
+        // Returns whether all 8 characters (loaded in little endian order) are decimal digits
+        inline bool is_eight_digits(std::uint64_t chunk) {
+            // Each byte must be in the range 0x30 ('0') - 0x39 ('9'), adding 0x06 pushes any byte above 0x39 out of the 0x3_ range
+            return ((chunk & 0xF0F0F0F0F0F0F0F0ull) | (((chunk + 0x0606060606060606ull) & 0xF0F0F0F0F0F0F0F0ull) >> 4u)) == 0x3333333333333333ull;
+        }
+        
+        // Converts 8 decimal digits (loaded in little endian order) to their value
+        inline std::uint32_t parse_eight_digits(std::uint64_t chunk) {
+            // Digits are combined in pairs, then the pairs into groups of four, then both halves, each using a single multiplication
+            chunk -= 0x3030303030303030ull;
+            chunk = (chunk * 10u) + (chunk >> 8u);
+            chunk = (((chunk & 0x000000FF000000FFull) * (100u + (1000000ull << 32u))) + (((chunk >> 16u) & 0x000000FF000000FFull) * (1u + (10000ull << 32u)))) >> 32u;
+            return static_cast<std::uint32_t>(chunk);
+        }
+        
+        // Accounts for the outcome of parsing the next field of a bulk parse
+        inline void record_field(bool success, BulkParseResult& result) {
+            if (!success) {
+                if (result.num_errors++ == 0u) {
+                    result.first_error = result.count;
+                }
+            }
+            ++result.count;
+        }
+        
+        // Returns the character at index 'i', or the null character if 'i' is out of bounds
+        constexpr char char_at(std::string_view in, std::size_t i) {
+            return i < in.length() ? in[i] : '\0';
+        }
+        
+        // Vectorized implementation of find_first_of(...), selected at runtime based on the instruction sets supported by the CPU (AVX2 / SSE2 / NEON, with a scalar fallback)
+        std::size_t find_first_of(const char* data, std::size_t length, std::string_view characters);
+        
+        // Returns the position of the first occurrence of 'delimiter' in 'in', starting at 'offset', or the length of 'in' if there is none (or 'delimiter' is empty)
+        // Vectorized for both single and multi-character delimiters
+        std::size_t find_delimiter(std::string_view in, std::size_t offset, std::string_view delimiter);
+        
+        // Returns the position of the first occurrence of any of 'characters' (at most 4) in 'in', starting at 'offset', or the length of 'in' if none are found
+        // Used to skip over runs of literal characters when parsing format strings
+        constexpr std::size_t find_first_of(std::string_view in, std::size_t offset, std::string_view characters) {
+            if (std::is_constant_evaluated()) {
+                while (offset < in.length() && characters.find(in[offset]) == std::string_view::npos) {
+                    ++offset;
+                }
+                return offset;
+            }
+            
+            if (offset >= in.length()) {
+                return in.length();
+            }
+            
+            return offset + find_first_of(in.data() + offset, in.length() - offset, characters);
+        }
+        
+        constexpr Identifier::Identifier() : type(Type::Auto),
+                                             position(std::numeric_limits<std::size_t>::max()),
+                                             name() {
+        }
+        
+        constexpr Identifier::Identifier(std::size_t position) : type(Type::Position),
+                                                                 position(position),
+                                                                 name() {
+        }
         
-        char nibble_to_hexadecimal(const char nibble[4]);
+        constexpr Identifier::Identifier(std::string_view name) : type(Type::Name),
+                                                                  position(std::numeric_limits<std::size_t>::max()),
+                                                                  name(name) {
+        }
         
         // Returns the number of characters read
-        std::size_t parse_identifier(std::string_view in, Identifier& out);
+        constexpr std::size_t parse_identifier(std::string_view in, Identifier& out) {
+            std::size_t offset = 0;
+
+            if (ascii::is_digit(char_at(in, offset))) {
+                std::size_t position = 0u;
+
+                // Positional placeholders must only contain numbers
+                while (ascii::is_digit(char_at(in, offset))) {
+                    position = position * 10u + static_cast<std::size_t>(in[offset] - '0');
+                    ++offset;
+                }
+
+                out = Identifier(position);
+            }
+            else if (ascii::is_alpha(char_at(in, offset)) || char_at(in, offset) == '_') {
+                ++offset;
+
+                // Named placeholders follow the same identifier rules as standard C/C++ identifiers
+                while (ascii::is_alphanumeric(char_at(in, offset)) || char_at(in, offset) == '_') {
+                    ++offset;
+                }
+
+                out = Identifier(in.substr(0, offset));
+            }
+
+            return offset;
+        }
         
         // Returns the index of the first invalid character
         std::size_t parse_format_spec(std::string_view in, FormatSpec& out, bool nested = false);
+        
+        // Specifiers containing nested format strings ('format' specifier, case-insensitive) are parsed differently
+        constexpr bool is_format_specifier(std::string_view name) {
+            constexpr std::string_view format = "format";
+            if (name.length() != format.length()) {
+                return false;
+            }
+            
+            for (std::size_t i = 0u; i < name.length(); ++i) {
+                char c = name[i];
+                if (c >= 'A' && c <= 'Z') {
+                    c = static_cast<char>(c - 'A' + 'a');
+                }
+                
+                if (c != format[i]) {
+                    return false;
+                }
+            }
+            
+            return true;
+        }
+        
+        constexpr std::size_t scan_specifier_name(std::string_view in) {
+            std::size_t i = 0;
+
+            // Specifier names follow the same rules as standard C/C++ identifiers
+            while (ascii::is_alpha(char_at(in, i)) || (char_at(in, i) == '_') || (i && ascii::is_digit(char_at(in, i)))) {
+                ++i;
+            }
+            
+            return i;
+        }
+        
+        // Returns the number of characters in the specifier value, including the closing brace ']'
+        constexpr std::size_t scan_specifier_value(std::string_view in, bool is_format) {
+            std::size_t length = in.length();
+            std::size_t i = 0;
+            
+            if (is_format) {
+                bool processing_placeholder = false;
+                
+                while (i < length) {
+                    if (processing_placeholder) {
+                        if (in[i] == '}') {
+                            if (i + 1 == length) {
+                                break;
+                            }
+                            
+                            if (in[i + 1] == '}') {
+                                // Skip escaped closing brace '}}'
+                                ++i;
+                            }
+                            else {
+                                processing_placeholder = false;
+                            }
+                        }
+                        // Do not escape format specifier braces '[' and ']' when processing a nested placeholder
+                    }
+                    else {
+                        if (in[i] == '{') {
+                            if (i + 1 == length) {
+                                break;
+                            }
+                            
+                            if (in[i + 1] == '{') {
+                                // Skip escaped opening brace '{{'
+                                ++i;
+                            }
+                            else {
+                                processing_placeholder = true;
+                            }
+                        }
+                        else if (in[i] == '[') {
+                            if (i + 1 == length) {
+                                return length;
+                            }
+                            
+                            if (in[i + 1] != '[') {
+                                // Unterminated / unescaped opening braces are not allowed
+                                return i;
+                            }
+                            
+                            // Skip escaped opening brace '[['
+                            ++i;
+                        }
+                        else if (in[i] == ']') {
+                            if (i + 1 == length || in[i + 1] != ']') {
+                                break;
+                            }
+                            
+                            // Skip escaped closing brace ']]'
+                            ++i;
+                        }
+                    }
+                    
+                    ++i;
+                }
+            }
+            else {
+                while (i < length) {
+                    if (in[i] == '[') {
+                        if (i + 1 == length || in[i + 1] != '[') {
+                            // Unterminated / unescaped opening braces are not allowed
+                            return i;
+                        }
+    
+                        // Skip escaped opening brace '[['
+                        ++i;
+                    }
+                    else if (in[i] == ']') {
+                        if (i + 1 == length || in[i + 1] != ']') {
+                            break;
+                        }
+    
+                        // Skip escaped closing brace ']]'
+                        ++i;
+                    }
+    
+                    ++i;
+                }
+            }
+            
+            // Skip closing brace ']'
+            return i + 1;
+        }
+        
+        constexpr std::size_t scan_format_spec(std::string_view in, bool nested) {
+            // Note: function assumes input string does not contain a leading formatting group separator ':'
+            std::size_t length = in.length();
+            std::size_t i = 0;
+            
+            char terminator = nested ? '|' : '}';
+
+            while (i < length) {
+                if (in[i] == terminator) {
+                    // Finished parsing format spec
+                    break;
+                }
+
+                if (in[i] == ':') {
+                    // Skip formatting group separator
+                    ++i;
+                    continue;
+                }
+
+                if (in[i] == '|') {
+                    // Skip nested formatting spec separator
+                    ++i;
+
+                    i += scan_format_spec(in.substr(i), true);
+
+                    // After parsing a nested formatting spec, the terminator character is expected to be '|'
+                    if (char_at(in, i) != '|') {
+                        return i;
+                    }
+                    
+                    // Skip nested formatting spec terminator
+                    ++i;
+                }
+                else {
+                    // Parse format specifiers
+                    while (true) {
+                        std::size_t name_length = scan_specifier_name(in.substr(i));
+                        std::string_view name = in.substr(i, name_length);
+                        i += name_length;
+                        
+                        if (char_at(in, i) != '=') {
+                            // Specifier name and value must be separated by '='
+                            return i;
+                        }
+
+                        // Skip separator '='
+                        ++i;
+                        
+                        if (char_at(in, i) != '[') {
+                            // Specifier values must be enclosed in braces '[' and ']'
+                            return i;
+                        }
+                        
+                        // Skip opening brace '['
+                        ++i;
+                        
+                        i += scan_specifier_value(in.substr(i), is_format_specifier(name));
+                        if (i > length) {
+                            // Unterminated specifier value
+                            return length;
+                        }
+                        
+                        if (char_at(in, i) == ',') {
+                            // Skip format specifier separator
+                            ++i;
+                            continue;
+                        }
+                        else if (char_at(in, i) == terminator || char_at(in, i) == ':') {
+                            // End of format spec || new format group
+                            break;
+                        }
+                        else {
+                            // Invalid character
+                            return i;
+                        }
+                    }
+                }
+            }
+
+            return i;
+        }
+        
+        // Splits a format spec that consists of a single specifier list into names and values, appending them to the specifier table of 'table'
+        // Returns the number of specifiers, or 0 if the spec must be parsed when formatted (formatting groups, nested specs, values that require unescaping, duplicate specifiers, or a full table)
+        // Note: 'spec' must be a validated format spec that references the characters of 'format'
+        constexpr std::size_t split_format_spec(std::string_view format, std::string_view spec, FormatSegmentTable& table) {
+            std::size_t length = spec.length();
+            std::size_t first = table.num_specifiers;
+            std::size_t count = first;
+            std::size_t i = 0;
+            
+            while (i < length) {
+                std::size_t name_length = scan_specifier_name(spec.substr(i));
+                std::string_view name = spec.substr(i, name_length);
+                i += name_length;
+                
+                if (name.empty() || char_at(spec, i) != '=' || char_at(spec, i + 1u) != '[') {
+                    // Formatting group separator ':' or nested spec '|'
+                    return 0u;
+                }
+                
+                // Skip separator '=' and opening brace '['
+                i += 2u;
+                
+                // Includes the closing brace ']'
+                std::size_t value_length = scan_specifier_value(spec.substr(i), is_format_specifier(name));
+                std::string_view value = spec.substr(i, value_length - 1u);
+                i += value_length;
+                
+                if (value.find_first_of("[]") != std::string_view::npos) {
+                    // Escaped braces are unescaped into separate storage
+                    return 0u;
+                }
+                
+                for (std::size_t j = first; j < count; ++j) {
+                    if (ascii::iequals(name, format.substr(table.specifiers[j].name_offset, table.specifiers[j].name_length))) {
+                        // Duplicate specifiers are reported when formatted
+                        return 0u;
+                    }
+                }
+                
+                if (count == FormatSegmentTable::capacity || name.length() > std::numeric_limits<std::uint8_t>::max()) {
+                    return 0u;
+                }
+                
+                table.specifiers[count++] = {
+                    .name_offset = static_cast<std::uint16_t>(name.data() - format.data()),
+                    .value_offset = static_cast<std::uint16_t>(value.data() - format.data()),
+                    .value_length = static_cast<std::uint16_t>(value.length()),
+                    .name_length = static_cast<std::uint8_t>(name.length())
+                };
+                
+                if (i < length && spec[i] != ',') {
+                    return 0u;
+                }
+                
+                // Skip format specifier separator ','
+                ++i;
+            }
+            
+            table.num_specifiers = static_cast<std::uint8_t>(count);
+            return count - first;
+        }
+        
+        // Format string errors are raised through these functions
+        // They are intentionally not constexpr: reaching one while parsing a format string at compile time results in a compilation error that names the problem
+        [[noreturn]] void unterminated_placeholder_error(std::size_t position, std::source_location source);
+        [[noreturn]] void unescaped_closing_brace_error(std::size_t position, std::source_location source);
+        [[noreturn]] void invalid_character_error(char c, std::size_t position, std::source_location source);
+        [[noreturn]] void heterogeneous_placeholders_error(std::source_location source);
+        [[noreturn]] void missing_argument_error(std::size_t placeholder, std::size_t position, std::source_location source);
+        [[noreturn]] void missing_named_argument_error(std::string_view name, std::size_t position, std::source_location source);
+        [[noreturn]] void not_enough_arguments_error(std::size_t expected, std::size_t received, std::source_location source);
+        [[noreturn]] void argument_order_error(std::size_t index, std::source_location source);
+        
+        // Parses format string 'fmt', invoking 'on_literal' for every run of literal characters and 'on_placeholder' for every placeholder (in order)
+        // Callback signatures:
+        //   - on_literal(std::string_view literal)
+        //   - on_placeholder(const Identifier& identifier, std::string_view spec, std::size_t position), where 'spec' is the (unparsed) format spec and 'position' is the index of the placeholder opening brace
+        // Raises an error on unescaped / unterminated braces, invalid placeholders, and placeholders of mixed types
+        // Can be evaluated at compile time, provided both callbacks can be
+        template <typename LiteralCallback, typename PlaceholderCallback>
+        constexpr void parse_format_string(std::string_view fmt, std::source_location source, LiteralCallback&& on_literal, PlaceholderCallback&& on_placeholder) {
+            std::size_t length = fmt.length();
+            std::size_t last_read_position = 0u;
+            std::size_t i = 0u;
+
+            std::optional<Identifier::Type> type { };
+
+            while (true) {
+                // Skip to the next opening / closing brace, literal characters in between are appended in bulk
+                i = find_first_of(fmt, i, "{}");
+                if (i == length) {
+                    break;
+                }
+                
+                if (fmt[i] == '{') {
+                    if (i + 1 == length) {
+                        unterminated_placeholder_error(i, source);
+                    }
+                    else if (fmt[i + 1] == '{') {
+                        // Escaped opening brace '{{'
+                        on_literal(fmt.substr(last_read_position, i - last_read_position + 1u)); // Include the first opening brace
+
+                        ++i;
+                        last_read_position = i + 1u; // Skip to the next character after the second brace
+                    }
+                    else {
+                        if (i != last_read_position) {
+                            on_literal(fmt.substr(last_read_position, i - last_read_position)); // Do not include opening brace
+                        }
+
+                        std::size_t position = i;
+
+                        // Skip placeholder opening brace '{'
+                        ++i;
+
+                        Identifier identifier { };
+                        i += parse_identifier(fmt.substr(i), identifier);
+                        if (i == length) {
+                            unterminated_placeholder_error(position, source);
+                        }
+
+                        if (fmt[i] != ':' && fmt[i] != '}') {
+                            // Expecting format spec separator ':' or placeholder closing brace '}'
+                            invalid_character_error(fmt[i], i, source);
+                        }
+
+                        if (!type) {
+                            // The identifier of the first placeholder dictates the type of format string
+                            type = identifier.type;
+                        }
+                        else {
+                            // Verify format string homogeneity - all placeholders must be of the same type
+                            bool homogeneous = (*type == Identifier::Type::Auto && identifier.type == Identifier::Type::Auto) || (*type != Identifier::Type::Auto && identifier.type != Identifier::Type::Auto);
+                            if (!homogeneous) {
+                                heterogeneous_placeholders_error(source);
+                            }
+                        }
+
+                        std::string_view spec { };
+                        if (fmt[i] == ':') {
+                            // Skip format spec separator ':'
+                            ++i;
+                            
+                            std::size_t offset = i;
+                            i += scan_format_spec(fmt.substr(i), false);
+                            if (i >= length || fmt[i] != '}') {
+                                invalid_character_error(char_at(fmt, i), i, source);
+                            }
+                            
+                            spec = fmt.substr(offset, i - offset);
+                        }
+
+                        on_placeholder(identifier, spec, position);
+
+                        // Skip placeholder closing brace '}'
+                        last_read_position = ++i;
+                        continue;
+                    }
+                }
+                else { // if (fmt[i] == '}') {
+                    if (i + 1 < length && fmt[i + 1] == '}') {
+                        // Escaped closing brace '}}'
+                        on_literal(fmt.substr(last_read_position, i - last_read_position + 1u)); // Include the first closing brace
+
+                        ++i;
+                        last_read_position = i + 1u; // Skip to the next character after the second brace
+                    }
+                    else {
+                        unescaped_closing_brace_error(i, source);
+                    }
+                }
+
+                ++i;
+            }
+
+            if (last_read_position < length) {
+                // Append any remaining characters
+                on_literal(fmt.substr(last_read_position));
+            }
+        }
+        
+    }
+    
+    template <typename ...Ts>
+    consteval FormatString<Ts...>::FormatString(const char* format, std::source_location source) : format(format),
+                                                                                                   source(source),
+                                                                                                   table { } {
+        constexpr std::array<bool, sizeof...(Ts)> named_arguments { is_named_argument<Ts>::value... };
+        
+        // Check: arguments for positional placeholders must come before any arguments for named placeholders
+        std::size_t num_positional_arguments = 0u;
+        bool has_named_arguments = false;
+        
+        for (std::size_t i = 0u; i < named_arguments.size(); ++i) {
+            if (named_arguments[i]) {
+                has_named_arguments = true;
+            }
+            else {
+                if (has_named_arguments) {
+                    detail::argument_order_error(i, source);
+                }
+                
+                ++num_positional_arguments;
+            }
+        }
+        
+        // Offsets into the format string are stored in 16 bits
+        bool fits = this->format.length() <= std::numeric_limits<std::uint16_t>::max();
+        
+        std::size_t num_segments = 0u;
+        std::size_t argument_index = 0u; // Used only for auto-numbered format strings
+        
+        detail::parse_format_string(this->format, source, [&](std::string_view literal) {
+            if (!fits || num_segments == detail::FormatSegmentTable::capacity) {
+                fits = false;
+                return;
+            }
+            
+            table.segments[num_segments++] = {
+                .type = detail::FormatSegment::Type::Literal,
+                .name_length = 0u,
+                .argument = 0u,
+                .position = 0u,
+                .offset = static_cast<std::uint16_t>(literal.data() - this->format.data()),
+                .length = static_cast<std::uint16_t>(literal.length()),
+                .first_specifier = 0u,
+                .num_specifiers = 0u
+            };
+            
+            table.length = static_cast<std::uint16_t>(table.length + literal.length());
+        }, [&](const detail::Identifier& identifier, std::string_view spec, std::size_t position) {
+            std::size_t argument = 0u;
+            
+            switch (identifier.type) {
+                case detail::Identifier::Type::Auto:
+                    // Checked against the number of arguments once the whole format string has been parsed
+                    table.auto_numbered = true;
+                    argument = argument_index++;
+                    break;
+                case detail::Identifier::Type::Position:
+                    if (identifier.position >= num_positional_arguments) {
+                        detail::missing_argument_error(identifier.position, position, source);
+                    }
+                    argument = identifier.position;
+                    break;
+                case detail::Identifier::Type::Name:
+                    // Names of NamedArgument arguments are only known at runtime
+                    if (!has_named_arguments) {
+                        detail::missing_named_argument_error(identifier.name, position, source);
+                    }
+                    
+                    if (identifier.name.length() > std::numeric_limits<std::uint8_t>::max()) {
+                        fits = false;
+                    }
+                    break;
+            }
+            
+            if (!fits || num_segments == detail::FormatSegmentTable::capacity) {
+                fits = false;
+                return;
+            }
+            
+            // Format specs are split into specifiers here, so that formatting does not need to parse them again
+            std::size_t first_specifier = table.num_specifiers;
+            std::size_t num_specifiers = detail::split_format_spec(this->format, spec, table);
+            
+            table.segments[num_segments++] = {
+                .type = identifier.type == detail::Identifier::Type::Name ? detail::FormatSegment::Type::Named : detail::FormatSegment::Type::Indexed,
+                .name_length = static_cast<std::uint8_t>(identifier.name.length()),
+                .argument = static_cast<std::uint16_t>(argument),
+                .position = static_cast<std::uint16_t>(position),
+                .offset = static_cast<std::uint16_t>(spec.empty() ? 0u : spec.data() - this->format.data()),
+                .length = static_cast<std::uint16_t>(spec.length()),
+                .first_specifier = static_cast<std::uint8_t>(first_specifier),
+                .num_specifiers = static_cast<std::uint8_t>(num_specifiers)
+            };
+        });
+        
+        if (argument_index > num_positional_arguments) {
+            detail::not_enough_arguments_error(argument_index, num_positional_arguments, source);
+        }
+        
+        table.size = static_cast<std::uint8_t>(num_segments);
+        table.valid = fits;
+    }
+    
+    template <typename ...Ts>
+    FormatString<Ts...>::FormatString(const std::string& format, std::source_location source) : format(format),
+                                                                                                source(source) {
+    }
+    
+    template <typename ...Ts>
+    FormatString<Ts...>::FormatString(std::string_view format, std::source_location source) : format(format),
+                                                                                              source(source) {
+    }
+    
+    // FormatBuffer functions are defined inline, as they are called for every formatted value
+    
+    inline FormatBuffer::FormatBuffer(char* data, std::size_t size, std::size_t capacity) : m_data(data),
+                                                                                            m_size(size),
+                                                                                            m_capacity(capacity) {
+    }
+    
+    inline FormatBuffer::~FormatBuffer() = default;
+    
+    inline void FormatBuffer::push_back(char c) {
+        if (m_size == m_capacity) {
+            grow(m_size + 1u);
+        }
+        
+        m_data[m_size++] = c;
+    }
+    
+    inline void FormatBuffer::append(const char* value, std::size_t length) {
+        while (length) {
+            if (m_size + length > m_capacity) {
+                grow(m_size + length);
+            }
+            
+            // Buffers that flush their contents may not be able to hold all characters at once
+            std::size_t count = std::min(length, m_capacity - m_size);
+            std::memcpy(m_data + m_size, value, count);
+            
+            m_size += count;
+            value += count;
+            length -= count;
+        }
+    }
+    
+    inline void FormatBuffer::append(std::string_view value) {
+        append(value.data(), value.length());
+    }
+    
+    inline void FormatBuffer::append(std::size_t count, char c) {
+        while (count) {
+            if (m_size + count > m_capacity) {
+                grow(m_size + count);
+            }
+            
+            std::size_t length = std::min(count, m_capacity - m_size);
+            std::memset(m_data + m_size, c, length);
+            
+            m_size += length;
+            count -= length;
+        }
+    }
+    
+    inline char* FormatBuffer::extend(std::size_t length) {
+        if (m_size + length > m_capacity) {
+            grow(m_size + length);
+            
+            if (m_size + length > m_capacity) {
+                // Buffers that flush their contents may not be able to provide enough contiguous storage
+                return nullptr;
+            }
+        }
+        
+        char* storage = m_data + m_size;
+        m_size += length;
+        return storage;
+    }
+    
+    inline void FormatBuffer::reserve(std::size_t capacity) {
+        if (capacity > m_capacity) {
+            grow(capacity);
+        }
+    }
+    
+    inline std::size_t FormatBuffer::size() const {
+        return m_size;
+    }
+    
+    inline std::size_t FormatBuffer::capacity() const {
+        return m_capacity;
+    }
+    
+    inline char* FormatBuffer::data() {
+        return m_data;
+    }
+    
+    namespace detail {
+        
+        template <typename String>
+        StringBuffer<String>::StringBuffer(String& out) : FormatBuffer(out.data(), out.size(), out.size()),
+                                                          m_string(out),
+                                                          m_offset(out.size()) {
+        }
+        
+        template <typename String>
+        StringBuffer<String>::~StringBuffer() {
+            // Trim any unused characters
+            m_string.resize(m_size);
+        }
+        
+        template <typename String>
+        void StringBuffer<String>::grow(std::size_t capacity) {
+            // Grow geometrically with respect to the number of characters appended so far
+            // Strings may be reserved up front to be much larger than the formatted result, and resizing to the full capacity would zero-fill all of it on every call
+            std::size_t minimum = std::max(capacity - m_offset, (std::size_t) 64u);
+            m_string.resize(std::max(capacity, std::min(m_string.capacity(), m_offset + minimum * 2u)));
+            m_data = m_string.data();
+            m_capacity = m_string.size();
+        }
+        
+        template <typename OutputIt>
+        IteratorBuffer<OutputIt>::IteratorBuffer(OutputIt out) : FormatBuffer(m_storage, 0u, sizeof(m_storage)),
+                                                                 m_out(out) {
+        }
+        
+        template <typename OutputIt>
+        IteratorBuffer<OutputIt>::~IteratorBuffer() = default;
+        
+        template <typename OutputIt>
+        OutputIt IteratorBuffer<OutputIt>::out() {
+            m_out = std::copy(m_data, m_data + m_size, m_out);
+            m_size = 0u;
+            return m_out;
+        }
+        
+        template <typename OutputIt>
+        void IteratorBuffer<OutputIt>::grow(std::size_t) {
+            // Flush buffered characters through the iterator
+            m_out = std::copy(m_data, m_data + m_size, m_out);
+            m_size = 0u;
+        }
+        
+    }
+    
+    namespace detail {
 
         template <typename T>
         bool is_reserved_argument(const NamedArgument<T>& arg) {
+
             if (arg.name.length() < 2) {
                 return false;
             }
@@ -53,9 +823,69 @@ namespace utils {
             return arg.name[0] == '_' && arg.name[1] == '_';
         }
         
-        // Performs various validation checks on function arguments
+        template <std::size_t N>
         template <typename Tuple>
-        void validate_arguments(const Tuple& tuple, bool is_auto_numbered) {
+        NamedArgumentIndex<N>::NamedArgumentIndex(const Tuple& tuple) : m_entries(),
+                                                                        m_first(npos),
+                                                                        m_duplicate(npos) {
+            utils::apply([this]<typename T>(const T& arg, std::size_t index) {
+                if constexpr (is_named_argument<T>::value) {
+                    std::size_t slot = hash(arg.name) & (capacity - 1u);
+                    
+                    while (m_entries[slot].argument != npos) {
+                        if (m_entries[slot].name == arg.name) {
+                            // Arguments are inserted in order, report the duplicate whose first occurrence comes earliest in the argument list
+                            if (m_first == npos || m_entries[slot].argument < m_entries[m_first].argument) {
+                                m_first = slot;
+                                m_duplicate = index;
+                            }
+                            return;
+                        }
+                        
+                        slot = (slot + 1u) & (capacity - 1u);
+                    }
+                    
+                    m_entries[slot] = { arg.name, index };
+                }
+            }, tuple);
+        }
+
+        template <std::size_t N>
+        std::size_t NamedArgumentIndex<N>::find(std::string_view name) const {
+            std::size_t slot = hash(name) & (capacity - 1u);
+            
+            while (m_entries[slot].argument != npos) {
+                if (m_entries[slot].name == name) {
+                    return m_entries[slot].argument;
+                }
+                
+                slot = (slot + 1u) & (capacity - 1u);
+            }
+            
+            return npos;
+        }
+
+        template <std::size_t N>
+        void NamedArgumentIndex<N>::validate() const {
+            if (m_first != npos) {
+                throw std::runtime_error(utils::format("invalid argument at position {} - named arguments must be unique (argument for placeholder '{}' first encountered at argument position {})", m_duplicate, m_entries[m_first].name, m_entries[m_first].argument));
+            }
+        }
+        
+        template <std::size_t N>
+        std::size_t NamedArgumentIndex<N>::hash(std::string_view name) {
+            // FNV-1a
+            std::uint32_t value = 2166136261u;
+            for (char c : name) {
+                value ^= static_cast<unsigned char>(c);
+                value *= 16777619u;
+            }
+            return value;
+        }
+
+        // Performs various validation checks on function arguments
+        template <typename Tuple, std::size_t N>
+        void validate_arguments(const Tuple& tuple, const NamedArgumentIndex<N>& names, bool is_auto_numbered) {
             if (is_auto_numbered) {
                 // Check: argument list must not contain any NamedArgument types (aside from builtin ones)
                 utils::apply([]<typename T, std::size_t I>(const T& value) {
@@ -68,11 +898,8 @@ namespace utils {
             }
             else {
                 // Format string contains a mix of positional and named placeholders
-                std::size_t num_positional_arguments = 0u;
-                constexpr std::size_t num_arguments = std::tuple_size<Tuple>::value;
-        
                 // Check: arguments for positional placeholders must come before any arguments for named placeholders
-                utils::apply([&num_positional_arguments, positional_arguments_parsed = false]<typename T>(const T&, std::size_t index) mutable {
+                utils::apply([positional_arguments_parsed = false]<typename T>(const T&, std::size_t index) mutable {
                     if constexpr (is_named_argument<T>::value) {
                         if (!positional_arguments_parsed) {
                             positional_arguments_parsed = true;
@@ -84,30 +911,131 @@ namespace utils {
                             throw std::runtime_error(utils::format("invalid argument at position {} - arguments for positional placeholders must come before arguments for named placeholders", index));
                         }
         
-                        ++num_positional_arguments;
                     }
                 }, tuple);
                 
                 // Check: two NamedArgument<T> arguments should not reference the same named placeholder
-                utils::apply_for([&tuple, num_arguments]<typename T>(const T& outer, std::size_t i) {
-                    ASSERT(is_named_argument<T>::value, "argument is not of type NamedArgument<T>");
+                names.validate();
+            }
+        }
         
-                    if constexpr (is_named_argument<T>::value) {
-                        utils::apply_for([&outer, i]<typename U>(const U& inner, std::size_t j) {
-                            ASSERT(is_named_argument<U>::value, "argument is not of type NamedArgument<U>");
+        void format_no_args(std::string_view fmt, std::source_location source, FormatBuffer& out);
         
-                            if constexpr (is_named_argument<U>::value) {
-                                if (outer.name == inner.name) {
-                                    throw std::runtime_error(utils::format("invalid argument at position {} - named arguments must be unique (argument for placeholder '{}' first encountered at argument position {})", j, inner.name, i));
-                                }
-                            }
-                        }, tuple, i + 1u, num_arguments);
+        // Formatters that write directly into the output buffer provide format_to(value, out)
+        // Formatters that only provide format(value) (such as user-defined formatters) are supported through an intermediate std::string
+        template <typename F, typename T>
+        void format_argument(F& formatter, const T& value, FormatBuffer& out) {
+            if constexpr (requires { formatter.format_to(value, out); }) {
+                formatter.format_to(value, out);
+            }
+            else {
+                out.append(formatter.format(value));
+            }
+        }
+        
+        // Formats 'value' into a new std::string, used to implement Formatter<T>::format(value) in terms of Formatter<T>::format_to(value, out)
+        template <typename F, typename T>
+        std::string format_to_string(const F& formatter, const T& value) {
+            std::string result;
+            
+            {
+                StringBuffer buffer(result);
+                formatter.format_to(value, buffer);
+            }
+            
+            return result;
+        }
+
+        // Formats the argument referenced by placeholder 'identifier' and appends the result to 'out'
+        // Argument 'index' is only used for auto-numbered placeholders, 'position' is only used for error messages
+        template <typename Tuple, std::size_t N>
+        void format_placeholder(const Identifier& identifier, const FormatSpec& spec, std::size_t index, std::size_t position, std::size_t num_arguments, std::source_location source, const Tuple& tuple, const NamedArgumentIndex<N>& names, FormatBuffer& out) {
+            switch (identifier.type) {
+                case Identifier::Type::Auto: {
+                    // utils::apply is a noop is the argument index exceeds the length of the tuple
+                    // Validating that there are enough arguments provided is handled by the caller
+                    utils::apply([&spec, &out]<typename T>(const T& value) {
+                        // builtin arguments are specified via NamedArgument types, and should not be considered as a part of the user-specified argument list
+                        if constexpr (!is_named_argument<T>::value) {
+                            Formatter<T> formatter { };
+                            formatter.parse(spec);
+                            format_argument(formatter, value, out);
+                        }
+                    }, tuple, index);
+                    break;
+                }
+                case Identifier::Type::Position: {
+                    if (identifier.position >= num_arguments) {
+                        missing_argument_error(identifier.position, position, source);
                     }
-                }, tuple, num_positional_arguments, num_arguments);
+
+                    utils::apply([&spec, &out]<typename T>(const T& value) {
+                        Formatter<T> formatter { };
+                        formatter.parse(spec);
+                        format_argument(formatter, value, out);
+                    }, tuple, identifier.position);
+                    break;
+                }
+                case Identifier::Type::Name: {
+                    std::size_t argument = names.find(identifier.name);
+                    if (argument == NamedArgumentIndex<N>::npos) {
+                        missing_named_argument_error(identifier.name, position, source);
+                    }
+                    
+                    utils::apply([&spec, &out]<typename T>(const T& arg) {
+                        if constexpr (is_named_argument<T>::value) {
+                            Formatter<typename T::type> formatter { };
+                            formatter.parse(spec);
+                            format_argument(formatter, arg.value, out);
+                        }
+                    }, tuple, argument);
+                    break;
+                }
+            }
+        }
+        
+        inline void load_format_spec(std::string_view format, std::span<const FormatSpecifier> specifiers, FormatSpec& out) {
+            for (const FormatSpecifier& specifier : specifiers) {
+                out.append_specifier(format.substr(specifier.name_offset, specifier.name_length), format.substr(specifier.value_offset, specifier.value_length));
             }
         }
         
-        std::string format_no_args(std::string_view fmt, std::source_location source);
+        // Substitutes arguments into a format string that was parsed and validated when the FormatString was constructed
+        template <typename Tuple, std::size_t N>
+        void format_segments(std::string_view fmt, const FormatSegmentTable& table, std::size_t num_arguments, std::source_location source, const Tuple& tuple, const NamedArgumentIndex<N>& names, FormatBuffer& out) {
+            out.reserve(out.size() + table.length);
+            
+            // Nested formatting groups (and specifier values that require unescaping) are allocated from the stack
+            alignas(FormatSpec) char storage[4u * sizeof(FormatSpec)];
+            std::pmr::monotonic_buffer_resource arena(storage, sizeof(storage));
+            
+            for (std::size_t i = 0u; i < table.size; ++i) {
+                const FormatSegment& segment = table.segments[i];
+                
+                if (segment.type == FormatSegment::Type::Literal) {
+                    out.append(fmt.data() + segment.offset, segment.length);
+                    continue;
+                }
+
+                FormatSpec spec(&arena);
+                if (segment.num_specifiers) {
+                    // Specifier names and values were split out of the format string at compile time and are referenced as-is
+                    load_format_spec(fmt, std::span(table.specifiers).subspan(segment.first_specifier, segment.num_specifiers), spec);
+                }
+                else if (segment.length) {
+                    // Format specs with formatting groups, nested specs, or escaped values were validated at compile time, but are parsed at runtime
+                    parse_format_spec(fmt.substr(segment.offset, segment.length), spec);
+                }
+                
+                if (segment.type == FormatSegment::Type::Indexed) {
+                    // Auto-numbered placeholders were resolved to argument indices at compile time
+                    format_placeholder(Identifier(segment.argument), spec, 0u, segment.position, num_arguments, source, tuple, names, out);
+                }
+                else {
+                    format_placeholder(Identifier(fmt.substr(segment.position + 1u, segment.name_length)), spec, 0u, segment.position, num_arguments, source, tuple, names, out);
+                }
+            }
+        }
 
     }
     
@@ -115,20 +1043,8 @@ namespace utils {
     
     template <String T, String U>
     [[nodiscard]] bool icasecmp(const T& first, const U& second) {
-        std::string_view a = first;
-        std::string_view b = second;
-        
-        if (a.length() != b.length()) {
-            return false;
-        }
-        
-        for (std::size_t i = 0u; i < a.length(); ++i) {
-            if (std::tolower(a[i]) != std::tolower(b[i])) {
-                return false;
-            }
-        }
-        
-        return true;
+        // Only ASCII characters are folded, std::tolower is locale-dependent and comparatively expensive
+        return ascii::iequals(std::string_view(first), std::string_view(second));
     }
 
     template <String T, String U>
@@ -149,6 +1065,92 @@ namespace utils {
         return true;
     }
     
+    inline SplitView::Iterator::Iterator() : m_in(),
+                                             m_delimiter(),
+                                             m_position(std::string_view::npos),
+                                             m_end(std::string_view::npos) {
+    }
+    
+    inline SplitView::Iterator::Iterator(std::string_view in, std::string_view delimiter) : m_in(in),
+                                                                                            m_delimiter(delimiter),
+                                                                                            m_position(0u),
+                                                                                            m_end(detail::find_delimiter(in, 0u, delimiter)) {
+    }
+    
+    inline std::string_view SplitView::Iterator::operator*() const {
+        return m_in.substr(m_position, m_end - m_position);
+    }
+    
+    inline SplitView::Iterator& SplitView::Iterator::operator++() {
+        if (m_end == m_in.length()) {
+            // Last component
+            m_position = std::string_view::npos;
+            m_end = std::string_view::npos;
+        }
+        else {
+            m_position = m_end + m_delimiter.length();
+            m_end = detail::find_delimiter(m_in, m_position, m_delimiter);
+        }
+        return *this;
+    }
+    
+    inline SplitView::Iterator SplitView::Iterator::operator++(int) {
+        Iterator copy = *this;
+        ++(*this);
+        return copy;
+    }
+    
+    inline bool SplitView::Iterator::operator==(const Iterator& other) const {
+        return m_in.data() == other.m_in.data() && m_position == other.m_position;
+    }
+    
+    inline bool SplitView::Iterator::operator==(std::default_sentinel_t) const {
+        return m_position == std::string_view::npos;
+    }
+    
+    inline SplitView::SplitView() : m_in(),
+                                    m_delimiter() {
+    }
+    
+    inline SplitView::SplitView(std::string_view in, std::string_view delimiter) : m_in(in),
+                                                                                   m_delimiter(delimiter) {
+    }
+    
+    inline SplitView::Iterator SplitView::begin() const {
+        return { m_in, m_delimiter };
+    }
+    
+    inline std::default_sentinel_t SplitView::end() const {
+        return std::default_sentinel;
+    }
+    
+    inline SplitView split_view(std::string_view in, std::string_view delimiter) {
+        return { in, delimiter };
+    }
+    
+    namespace detail {
+        
+        // Raised when a specifier-related function is called on a formatting group list
+        [[noreturn]] void formatting_group_access_error(std::string_view function);
+        
+    }
+    
+    inline const FormatSpec::SpecifierView* FormatSpec::find(std::string_view name) const {
+        for (std::size_t i = 0u; i < m_size; ++i) {
+            if (icasecmp(m_specifiers[i].name, name)) {
+                return m_specifiers + i;
+            }
+        }
+        return nullptr;
+    }
+    
+    inline bool FormatSpec::has_specifier(std::string_view key) const {
+        if (m_type == Type::FormattingGroupList) {
+            detail::formatting_group_access_error("has_specifier");
+        }
+        return find(key) != nullptr;
+    }
+    
     template <typename ...Ts>
     FormatSpec::SpecifierView FormatSpec::get_specifier(std::string_view first, std::string_view second, Ts... rest) const {
         constexpr std::size_t argument_count = sizeof...(Ts) + 2u; // Include 'first' and 'second' specifiers
@@ -158,11 +1160,15 @@ namespace utils {
         std::size_t index = argument_count; // Initially set to invalid
         std::size_t valid_specifier_count = 0u;
 
+        if (m_type == Type::FormattingGroupList) {
+            detail::formatting_group_access_error("get_specifier");
+        }
+        
         utils::apply([this, &specifiers, &index, &valid_specifier_count](std::string_view name, std::size_t i) {
             specifiers[i].name = name;
-            if (has_specifier(name)) {
+            if (const SpecifierView* specifier = find(name)) {
                 index = i;
-                specifiers[i].value = get_specifier(name);
+                specifiers[i].value = specifier->value;
                 ++valid_specifier_count;
             }
         }, std::make_tuple(first, second, std::string_view(rest)...));
@@ -206,63 +1212,230 @@ namespace utils {
                         // Do not add a trailing comma
                         capacity += 2u;
                     }
-                    ++count;
+                    ++count;
+                }
+            }
+
+            std::string error;
+            error.reserve(capacity);
+            
+            error += "ambiguous format specification access - value found for more than one of the following specifiers: ";
+
+            for (std::size_t i = 0u, count = 0u; i < argument_count; ++i) {
+                if (!specifiers[i].value.empty()) {
+                    error += specifiers[i].name;
+                    if (count != valid_specifier_count) {
+                        // Do not add a trailing comma
+                        error += ", ";
+                    }
+                    ++count;
+                }
+            }
+            
+            throw std::runtime_error(error);
+        }
+        
+        return specifiers[index];
+    }
+    
+    template <typename ...Ts>
+    bool FormatSpec::has_specifier(std::string_view first, std::string_view second, Ts... rest) const {
+        return has_specifier(first) || has_specifier(second) || (has_specifier(rest) || ...);
+    }
+    
+    template <typename T>
+    NamedArgument<T>::NamedArgument(std::string_view name, const T& value) : name(name),
+                                                                             value(value) {
+        static_assert(!is_named_argument<T>::value, "NamedArgument type must not be NamedArgument");
+    }
+
+    template <typename T>
+    NamedArgument<T>::~NamedArgument() = default;
+    
+    namespace detail {
+        
+        template <typename ...Ts>
+        void format_into(FormatBuffer& out, const FormatString<Ts...>& str, const Ts&... args) {
+            std::string_view fmt = str.format;
+            std::source_location source = str.source;
+            
+            if (fmt.empty()) {
+                return;
+            }
+            
+            if constexpr (sizeof...(Ts)) {
+                // Arguments are referenced (not copied) for the duration of the call
+                std::tuple<const Ts&...> tuple = std::tie(args...);
+                
+                // Named placeholders are resolved through an index of argument names, built once per call
+                NamedArgumentIndex<num_named_arguments<Ts...>> names(tuple);
+                
+                // 'source' is overridden by the implementation to reference external function calls
+                utils::apply([&source]<typename T>(const T& arg) {
+                    if constexpr (std::is_same<T, NamedArgument<std::source_location>>::value) {
+                        if (icasecmp(arg.name, "__source")) {
+                            source = arg.value;
+                        }
+                    }
+                }, tuple);
+                
+                // Reserved arguments are provided automatically by the implementation and should not be considered part of the user-specified args
+                std::size_t num_arguments = sizeof...(Ts);
+                utils::apply([&num_arguments]<typename T>(const T& arg) {
+                    if constexpr (is_named_argument<T>::value) {
+                        if (is_reserved_argument(arg)) {
+                            --num_arguments;
+                        }
+                    }
+                }, tuple);
+                
+                if (str.table.valid) {
+                    if constexpr ((is_named_argument<Ts>::value || ...)) {
+                        // Argument types were validated at compile time, but the names of NamedArgument arguments are only known at runtime
+                        validate_arguments(tuple, names, str.table.auto_numbered);
+                    }
+                    
+                    format_segments(fmt, str.table, num_arguments, source, tuple, names, out);
+                    return;
+                }
+                
+                if (num_arguments == 0) {
+                    // No user arguments provided to format
+                    format_no_args(fmt, source, out);
+                    return;
+                }
+                
+                bool validated = false;
+                std::size_t argument_index = 0u; // Used only for auto-numbered format strings
+                
+                // Nested formatting groups (and specifier values that require unescaping) are allocated from the stack
+                alignas(FormatSpec) char storage[4u * sizeof(FormatSpec)];
+                std::pmr::monotonic_buffer_resource arena(storage, sizeof(storage));
+                
+                parse_format_string(fmt, source, [&out](std::string_view literal) {
+                    out.append(literal);
+                }, [&](const Identifier& identifier, std::string_view format_spec, std::size_t position) {
+                    if (!validated) {
+                        // The identifier of the first placeholder dictates the type of format string
+                        validate_arguments(tuple, names, identifier.type == Identifier::Type::Auto);
+                        validated = true;
+                    }
+                    
+                    FormatSpec spec(&arena);
+                    if (!format_spec.empty()) {
+                        parse_format_spec(format_spec, spec);
+                    }
+                    
+                    if (identifier.type == Identifier::Type::Auto) {
+                        // An exception for missing arguments is raised below (after parsing the whole format string)
+                        format_placeholder(identifier, spec, argument_index++, position, num_arguments, source, tuple, names, out);
+                    }
+                    else {
+                        format_placeholder(identifier, spec, 0u, position, num_arguments, source, tuple, names, out);
+                    }
+                });
+                
+                if (argument_index > num_arguments) {
+                    not_enough_arguments_error(argument_index, num_arguments, source);
                 }
             }
-
-            std::string error;
-            error.reserve(capacity);
-            
-            error += "ambiguous format specification access - value found for more than one of the following specifiers: ";
-
-            for (std::size_t i = 0u, count = 0u; i < argument_count; ++i) {
-                if (!specifiers[i].value.empty()) {
-                    error += specifiers[i].name;
-                    if (count != valid_specifier_count) {
-                        // Do not add a trailing comma
-                        error += ", ";
+            else {
+                if (str.table.valid) {
+                    // Placeholders without arguments are rejected at compile time, the format string only contains literals
+                    out.reserve(out.size() + str.table.length);
+                    
+                    for (std::size_t i = 0u; i < str.table.size; ++i) {
+                        out.append(fmt.data() + str.table.segments[i].offset, str.table.segments[i].length);
                     }
-                    ++count;
+                    
+                    return;
                 }
+                
+                // No arguments provided to format
+                format_no_args(fmt, source, out);
             }
-            
-            throw std::runtime_error(error);
         }
         
-        return specifiers[index];
     }
     
     template <typename ...Ts>
-    bool FormatSpec::has_specifier(std::string_view first, std::string_view second, Ts... rest) const {
-        return has_specifier(first) || has_specifier(second) || (has_specifier(rest) || ...);
+    std::string format(FormatString<std::type_identity_t<Ts>...> str, const Ts&... args) {
+        std::string result;
+        
+        {
+            // The buffer trims the string to the number of characters written when it goes out of scope
+            detail::StringBuffer buffer(result);
+            detail::format_into(buffer, str, args...);
+        }
+        
+        return result;
     }
     
-    template <typename T>
-    NamedArgument<T>::NamedArgument(std::string_view name, const T& value) : name(name),
-                                                                             value(value) {
-        static_assert(!is_named_argument<T>::value, "NamedArgument type must not be NamedArgument");
+    template <typename ...Ts>
+    void format_to(FormatBuffer& out, FormatString<std::type_identity_t<Ts>...> str, const Ts&... args) {
+        detail::format_into(out, str, args...);
+    }
+    
+    template <typename ...Ts>
+    void format_to(std::string& out, FormatString<std::type_identity_t<Ts>...> str, const Ts&... args) {
+        detail::StringBuffer buffer(out);
+        detail::format_into(buffer, str, args...);
     }
-
-    template <typename T>
-    NamedArgument<T>::~NamedArgument() = default;
     
     template <typename ...Ts>
-    std::string format(const FormatString& str, const Ts&... args) {
-        std::string_view fmt = str.format;
-        std::source_location source = str.source;
+    std::pmr::string format(std::pmr::memory_resource* resource, FormatString<std::type_identity_t<Ts>...> str, const Ts&... args) {
+        std::pmr::string result(resource);
         
-        if (fmt.empty()) {
-            return "";
+        {
+            // The buffer trims the string to the number of characters written when it goes out of scope
+            detail::StringBuffer buffer(result);
+            detail::format_into(buffer, str, args...);
         }
         
-        std::size_t length = fmt.length();
-        std::size_t last_read_position = 0u;
-        std::size_t i = 0u;
+        return result;
+    }
+    
+    template <typename ...Ts>
+    void format_to(std::pmr::string& out, FormatString<std::type_identity_t<Ts>...> str, const Ts&... args) {
+        detail::StringBuffer buffer(out);
+        detail::format_into(buffer, str, args...);
+    }
+    
+    template <std::output_iterator<char> OutputIt, typename ...Ts>
+    OutputIt format_to(OutputIt out, FormatString<std::type_identity_t<Ts>...> str, const Ts&... args) {
+        detail::IteratorBuffer<OutputIt> buffer(out);
+        detail::format_into(buffer, str, args...);
+        return buffer.out();
+    }
+    
+    template <typename ...Ts>
+    FormatToResult format_to_n(char* out, std::size_t n, FormatString<std::type_identity_t<Ts>...> str, const Ts&... args) {
+        detail::FixedBuffer buffer(out, n);
+        detail::format_into(buffer, str, args...);
+        return { out + buffer.written(), buffer.count() };
+    }
+    
+    template <typename ...Ts>
+    std::size_t formatted_size(FormatString<std::type_identity_t<Ts>...> str, const Ts&... args) {
+        // Characters are counted, but discarded
+        detail::FixedBuffer buffer(nullptr, 0u);
+        detail::format_into(buffer, str, args...);
+        return buffer.count();
+    }
+    
+    template <typename ...Ts>
+    void format_to(FormatBuffer& out, const CompiledFormat& fmt, const Ts&... args) {
+        std::source_location source = fmt.m_source;
+        std::size_t num_placeholders = fmt.m_placeholders.size();
         
-        std::string out;
+        out.reserve(out.size() + fmt.m_length);
         
         if constexpr (sizeof...(Ts)) {
-            std::tuple<typename std::decay<const Ts>::type...> tuple = std::make_tuple(args...);
+            // Arguments are referenced (not copied) for the duration of the call
+            std::tuple<const Ts&...> tuple = std::tie(args...);
+            
+            // Named placeholders are resolved through an index of argument names, built once per call
+            detail::NamedArgumentIndex<detail::num_named_arguments<Ts...>> names(tuple);
             
             // 'source' is overridden by the implementation to reference external function calls
             utils::apply([&source]<typename T>(const T& arg) {
@@ -283,148 +1456,68 @@ namespace utils {
                 }
             }, tuple);
             
-            if (num_arguments == 0) {
-                // No user arguments provided to format
-                return std::move(detail::format_no_args(fmt, source));
+            if (num_placeholders) {
+                if (num_arguments == 0) {
+                    throw std::runtime_error(utils::format("invalid format string - missing argument for placeholder at position {} ({})", fmt.m_placeholders.front().position, source));
+                }
+                
+                detail::validate_arguments(tuple, names, fmt.m_type == detail::Identifier::Type::Auto);
+                
+                // All placeholders of an auto-numbered format string are known ahead of time, verify there are enough arguments before formatting anything
+                if (fmt.m_type == detail::Identifier::Type::Auto && num_placeholders > num_arguments) {
+                    detail::not_enough_arguments_error(num_placeholders, num_arguments, source);
+                }
             }
             
-            std::optional<detail::Identifier::Type> type { };
-            std::size_t argument_index = 0u; // Used only for auto-numbered format strings
-            
-            while (i < length) {
-                if (fmt[i] == '{') {
-                    if (i + 1 == length) {
-                        throw std::runtime_error(utils::format("unterminated placeholder opening brace at position {} - opening brace literals must be escaped as '}}' ({})", i, source));
-                    }
-                    else if (fmt[i + 1] == '{') {
-                        // Escaped opening brace '{{'
-                        out.append(fmt, last_read_position, i - last_read_position + 1u); // Include the first opening brace
-                        
-                        ++i;
-                        last_read_position = i + 1u; // Skip to the next character after the second brace
-                    }
-                    else {
-                        out.append(fmt, last_read_position, i - last_read_position); // Do not include opening brace
-                        
-                        // Skip placeholder opening brace '{'
-                        i++;
-                        
-                        detail::Identifier identifier { };
-                        i += parse_identifier(fmt.substr(i), identifier);
-                        if (fmt[i] != ':' && fmt[i] != '}') {
-                            // Expecting format spec separator ':' or placeholder closing brace '}'
-                            throw std::runtime_error(utils::format("invalid character '{}' at position {} ({})", fmt[i], i, source));
-                        }
-                        
-                        if (!type) {
-                            // The identifier of the first placeholder dictates the type of format string
-                            type = identifier.type;
-                            detail::validate_arguments(tuple, identifier.type == detail::Identifier::Type::Auto);
-                        }
-                        else {
-                            // Verify format string homogeneity - all placeholders must be of the same type
-                            bool homogeneous = (*type == detail::Identifier::Type::Auto && identifier.type == detail::Identifier::Type::Auto) || (*type != detail::Identifier::Type::Auto && identifier.type != detail::Identifier::Type::Auto);
-                            if (!homogeneous) {
-                                throw std::runtime_error(utils::format("invalid format string - placeholder types must be homogeneous ({})", source));
-                            }
-                        }
-                        
-                        FormatSpec spec { };
-                        if (fmt[i] == ':') {
-                            // Skip format spec separator ':'
-                            ++i;
-                            
-                            i += detail::parse_format_spec(fmt.substr(i, length - i), spec);
-                            if (fmt[i] != '}') {
-                                throw std::runtime_error(utils::format("invalid character '{}' at position {} ({})", fmt[i], i, source));
-                            }
-                        }
-    
-                        // Format placeholder
-                        switch (*type) {
-                            case detail::Identifier::Type::Auto: {
-                                // utils::apply is a noop is the argument index exceeds the length of the tuple
-                                // An exception for this is raised below (after parsing the whole format string)
-                                utils::apply([&spec, &out]<typename T>(const T& value) {
-                                    // builtin arguments are specified via NamedArgument types, and should not be considered as a part of the user-specified argument list
-                                    if constexpr (!is_named_argument<T>::value) {
-                                        Formatter<T> formatter { };
-                                        formatter.parse(spec);
-                                        out.append(formatter.format(value));
-                                    }
-                                }, tuple, argument_index++);
-                                break;
-                            }
-                            case detail::Identifier::Type::Position: {
-                                if (identifier.position >= num_arguments) {
-                                    throw std::runtime_error(utils::format("invalid format string - missing argument for placeholder {} at position {} ()", identifier.position, i, source));
-                                }
-                                else {
-                                    utils::apply([&spec, &out]<typename T>(const T& value) {
-                                        Formatter<T> formatter { };
-                                        formatter.parse(spec);
-                                        out.append(formatter.format(value));
-                                    }, tuple, identifier.position);
-                                }
-                                break;
-                            }
-                            case detail::Identifier::Type::Name: {
-                                bool formatted = false;
-                                utils::apply([name = identifier.name, &formatted, &spec, &out]<typename T>(const T& arg) {
-                                    if constexpr (is_named_argument<T>::value) {
-                                        if (arg.name == name) {
-                                            Formatter<typename T::type> formatter { };
-                                            formatter.parse(spec);
-                                            out.append(formatter.format(arg.value));
-                                            formatted = true;
-                                        }
-                                    }
-                                }, tuple);
-                                
-                                if (!formatted) {
-                                    throw std::runtime_error(utils::format("invalid format string - missing NamedArgument for placeholder '{}' at position {} ({})", identifier.name, i, source));
-                                }
-                                break;
-                            }
-                        }
-                        
-                        // Skip placeholder closing brace '}'
-                        last_read_position = ++i;
-                    }
+            for (const CompiledFormat::Segment& segment : fmt.m_segments) {
+                if (segment.type == CompiledFormat::Segment::Type::Literal) {
+                    out.append(segment.literal);
                 }
-                else if (fmt[i] == '}') {
-                    if (i + 1 < length && fmt[i + 1] == '}') {
-                        // Escaped closing brace '}}'
-                        out.append(fmt, last_read_position, i - last_read_position + 1u); // Include the first opening brace
-                        
-                        ++i;
-                        last_read_position = i + 1u; // Skip to the next character after the second brace
-                    }
-                    else {
-                        throw std::runtime_error(utils::format("invalid placeholder closing brace at position {} - closing brace literals must be escaped as '}}}}' ({})", i, source));
-                    }
+                else {
+                    // Auto-numbered placeholders reference arguments in the order they appear in the format string
+                    const CompiledFormat::Placeholder& placeholder = fmt.m_placeholders[segment.placeholder];
+                    detail::format_placeholder(placeholder.identifier, placeholder.spec, segment.placeholder, placeholder.position, num_arguments, source, tuple, names, out);
                 }
-                
-                ++i;
             }
-            
-            if (*type == detail::Identifier::Type::Auto && argument_index > num_arguments) {
-                throw std::runtime_error(utils::format("not enough arguments provided to format(...) - expecting: {}, received: {} ({})", argument_index, num_arguments, source));
+        }
+        else {
+            if (num_placeholders) {
+                // format(...) was called with no arguments, so the existence of any placeholders is invalid
+                throw std::runtime_error(utils::format("invalid format string - missing argument for placeholder at position {} ({})", fmt.m_placeholders.front().position, source));
             }
             
-            if (i != last_read_position) {
-                // Append any remaining characters
-                out.append(fmt, last_read_position, i - last_read_position);
+            for (const CompiledFormat::Segment& segment : fmt.m_segments) {
+                out.append(segment.literal);
             }
-            
-            return std::move(out);
-        }
-        else {
-            // No arguments provided to format
-            return std::move(detail::format_no_args(fmt, source));
         }
     }
     
+    template <typename ...Ts>
+    void format_to(std::string& out, const CompiledFormat& fmt, const Ts&... args) {
+        detail::StringBuffer buffer(out);
+        format_to(buffer, fmt, args...);
+    }
+    
+    template <typename ...Ts>
+    std::string format(const CompiledFormat& fmt, const Ts&... args) {
+        std::string result;
+        format_to(result, fmt, args...);
+        return result;
+    }
+    
+    template <typename ...Ts>
+    void format_to(std::pmr::string& out, const CompiledFormat& fmt, const Ts&... args) {
+        detail::StringBuffer buffer(out);
+        format_to(buffer, fmt, args...);
+    }
+    
+    template <typename ...Ts>
+    std::pmr::string format(std::pmr::memory_resource* resource, const CompiledFormat& fmt, const Ts&... args) {
+        std::pmr::string result(resource);
+        format_to(result, fmt, args...);
+        return result;
+    }
+    
     template <typename T>
     IntegerFormatter<T>::IntegerFormatter() : FormatterBase(),
                                               representation(Representation::Decimal),
@@ -518,135 +1611,100 @@ namespace utils {
 
     template <typename T>
     std::string IntegerFormatter<T>::format(T value) const {
+        return std::move(detail::format_to_string(*this, value));
+    }
+    
+    template <typename T>
+    void IntegerFormatter<T>::format_to(T value, FormatBuffer& out) const {
         if (representation == Representation::Decimal) {
-            return to_decimal(value);
+            to_decimal(value, out);
         }
         else if (representation == Representation::Binary) {
-            return to_binary(value);
+            to_binary(value, out);
         }
         else { // if (representation == Representation::Hexadecimal) {
-            return to_hexadecimal(value);
+            to_hexadecimal(value, out);
         }
     }
 
     template <typename T>
-    std::string IntegerFormatter<T>::to_decimal(T value) const {
-        // Compute the minimum number of characters to hold the formatted value
-        std::size_t num_characters;
-
-        // +1 character for sign
+    void IntegerFormatter<T>::to_decimal(T value, FormatBuffer& out) const {
+        using U = typename std::make_unsigned<T>::type;
         
+        bool negative = false;
         if constexpr (std::is_signed<T>::value) {
-            if (value < 0) {
-                num_characters = (std::size_t) (std::log10(-value) + 1u) + 1u;
-            }
-            else {
-                if (value == 0) {
-                    // std::log10(0) = 0
-                    num_characters = 1;
-                }
-                else {
-                    num_characters = (std::size_t) (std::log10(value) + 1u) + (sign != Sign::NegativeOnly);
-                }
-            }
-        }
-        else {
-            if (value == 0) {
-                // std::log10(0) = 0
-                num_characters = 1;
-            }
-            else {
-                num_characters = (std::size_t) (std::log10(value) + 1u) + (sign != Sign::NegativeOnly);
-            }
-        }
-
-        bool _use_separator_character = use_separator_character && *use_separator_character;
-        std::uint8_t _group_size = 3u;
-
-        // Reserve capacity for separator characters (inserted between two groups)
-        std::size_t num_separator_characters = 0u;
-        if (_use_separator_character) {
-            num_separator_characters = num_characters / _group_size;
-
-            // Do not include a leading separator character if the number of characters is an even multiple of the group size
-            if (num_characters && num_characters % _group_size == 0) {
-                num_separator_characters -= 1u;
-            }
-        }
-
-        std::size_t capacity = std::max(num_characters, (std::size_t) width);
-        std::string result(capacity, fill_character);
-
-        std::size_t write_position;
-        switch (justification) {
-            case Justification::Left:
-                write_position = 0u;
-                break;
-            case Justification::Right:
-                write_position = capacity - num_characters;
-                break;
-            case Justification::Center:
-                write_position = (capacity - num_characters) / 2;
-                break;
+            negative = value < 0;
         }
-
-        char buffer[std::numeric_limits<T>::digits10 + (std::is_signed<T>::value ? 1 : 0)];
-        char* start = buffer;
-        char* end = buffer + sizeof(buffer) / sizeof(buffer[0]);
-        const auto& [ptr, error_code] = std::to_chars(start, end, value, 10);
-
-        if (value < 0) {
-            result[write_position++] = '-';
-            ++start; // Do not read negative sign from buffer
+        
+        // Negating in unsigned arithmetic is well-defined for std::numeric_limits<T>::min()
+        U magnitude = negative ? static_cast<U>(U(0) - static_cast<U>(value)) : static_cast<U>(value);
+        
+        char sign_character = '\0';
+        if (negative) {
+            sign_character = '-';
         }
         else {
             switch (sign) {
                 case Sign::Aligned:
-                    result[write_position++] = ' ';
+                    sign_character = ' ';
                     break;
                 case Sign::Both:
-                    result[write_position++] = '+';
+                    sign_character = '+';
                     break;
                 case Sign::NegativeOnly:
                 default:
                     break;
             }
         }
-
-        std::size_t num_characters_written = ptr - start;
-
+        
+        bool _use_separator_character = use_separator_character && *use_separator_character;
+        
+        std::size_t num_digits = detail::count_decimal_digits(magnitude);
+        std::size_t length = num_digits + (sign_character != '\0');
         if (_use_separator_character) {
-            std::size_t current = 3 - (num_characters_written % 3);
-            for (std::size_t i = 0u; i < num_characters_written; ++i, ++current) {
-                if (i && (current % 3) == 0u) {
-                    result[write_position++] = ',';
-                }
-
-                result[write_position++] = *(start + i);
-            }
+            // Separators are inserted between groups of 3 digits
+            length += (num_digits - 1u) / 3u;
+        }
+        
+        // Values that do not require justification are written directly into the output buffer
+        // +1 character for the digit not covered by std::numeric_limits<T>::digits10, +1 character for sign
+        char buffer[(std::numeric_limits<T>::digits10 + 1) + (std::numeric_limits<T>::digits10 + 1) / 3 + 1];
+        char* result = length >= width ? out.extend(length) : nullptr;
+        if (!result) {
+            result = buffer;
+        }
+        
+        if (_use_separator_character) {
+            detail::write_decimal_digits(magnitude, result + length, ',');
         }
         else {
-            // Copy contents directly
-            result.replace(write_position, num_characters_written, start, 0, num_characters_written);
+            detail::write_decimal_digits(magnitude, result + length);
+        }
+        
+        if (sign_character) {
+            result[0] = sign_character;
         }
         
-        return std::move(FormatterBase::format(result));
+        if (result == buffer) {
+            FormatterBase::format_to(buffer, length, out);
+        }
     }
 
     template <typename T>
-    std::string IntegerFormatter<T>::to_binary(T value) const {
-        std::size_t num_characters;
-
-        // Compute the minimum number of characters to hold the formatted value
-        if (value < 0) {
-            // Twos complement is used for formatting negative values, which by default uses as many digits as required by the system architecture
-            num_characters = sizeof(T) * CHAR_BIT;
-        }
-        else {
-            // The minimum number of digits required to format a binary number is log2(n) + 1
-            num_characters = (std::size_t) std::floor(std::log2(value)) + 1u;
+    void IntegerFormatter<T>::to_binary(T value, FormatBuffer& out) const {
+        using U = typename std::make_unsigned<T>::type;
+        
+        // Twos complement is used for formatting negative values
+        U bits = static_cast<U>(value);
+        
+        bool negative = false;
+        if constexpr (std::is_signed<T>::value) {
+            negative = value < 0;
         }
-
+        
+        // Compute the minimum number of characters to hold the formatted value
+        // Negative values use as many digits as required by the system architecture
+        std::size_t num_characters = negative ? sizeof(T) * CHAR_BIT : std::max(static_cast<std::size_t>(std::bit_width(bits)), (std::size_t) 1u);
         std::size_t num_padding_characters = 0u;
 
         // The number of characters can be overridden by a user-specified 'digits' value
@@ -658,320 +1716,176 @@ namespace utils {
                 num_characters = _digits;
             }
             else {
-                // Append leading padding characters to reach the desired number of digits
                 num_padding_characters = _digits - num_characters;
             }
         }
-
-        bool _use_separator_character = false;
-        std::uint8_t _group_size = 0u;
-
-        if (use_separator_character) {
-            if (*use_separator_character) {
-                if (group_size) {
-                    _group_size = *group_size;
-
-                    if (*group_size) {
-                        _use_separator_character = true;
-                    }
-                    else {
-                        // Group size explicitly provided as 0, use of separator character is disabled
-                        _use_separator_character = false;
-                    }
-                }
-                else {
-                    // Group size is 4 by default (if not specified)
-                    _group_size = 4u;
-                    _use_separator_character = true;
-                }
-            }
-            else {
-                // Use of separator character explicitly disabled
-                _use_separator_character = false;
-            }
-        }
-        else {
-            // Use of separator character is disabled by default
-            _use_separator_character = false;
+        
+        // Use of separator character is disabled by default, group size is 4 by default (if not specified)
+        // Group size explicitly provided as 0 disables the use of separator character
+        std::size_t _group_size = 0u;
+        if (use_separator_character && *use_separator_character) {
+            _group_size = group_size ? *group_size : 4u;
         }
-
-        // Reserve capacity for separator characters (inserted between two groups)
-        std::size_t num_separator_characters = 0u;
-        if (_use_separator_character) {
-            num_separator_characters = num_characters / _group_size;
-
-            // Do not include a leading separator character if the number of characters is an even multiple of the group size
-            // Example: 0b'0000 should be 0b0000
-            if (num_characters && num_characters % _group_size == 0) {
-                num_separator_characters -= 1u;
-            }
+        
+        std::size_t num_digits = num_characters + num_padding_characters;
+        std::size_t length = num_digits;
+        if (_group_size && num_digits) {
+            // Separators are inserted between two groups
+            length += (num_digits - 1u) / _group_size;
         }
-
-        std::size_t length = num_characters + num_padding_characters + num_separator_characters;
         if (use_base_prefix) {
             // +2 characters for base prefix '0b'
             length += 2u;
         }
 
-        std::size_t capacity = std::max(length, (std::size_t) width);
-        std::string result(capacity, fill_character);
-
-        std::size_t write_position;
-        switch (justification) {
-            case Justification::Left:
-                write_position = 0u;
-                break;
-            case Justification::Right:
-                write_position = capacity - length;
-                break;
-            case Justification::Center:
-                write_position = (capacity - length) / 2;
-                break;
-        }
-
-        // Convert value to binary
-        char buffer[sizeof(T) * CHAR_BIT] { 0 };
-        char* end = buffer;
-        for (int i = 0; i < (int) num_characters; ++i, ++end) {
-            int bit = (value >> (num_characters - 1 - i)) & 1;
-            *end = (char) (48 + bit); // 48 is the ASCII code for '0'
-        }
-
-        if (use_base_prefix) {
-            result[write_position++] = '0';
-            result[write_position++] = 'b';
+        // Values that do not require justification are written directly into the output buffer
+        // Digits and separator characters are each bounded by the maximum value of 'digits' (255), +2 characters for base prefix
+        char buffer[std::max(sizeof(T) * CHAR_BIT, (std::size_t) 255u) * 2u + 2u];
+        char* result = length >= width ? out.extend(length) : nullptr;
+        if (!result) {
+            result = buffer;
         }
+        
+        // Digits are written backwards, starting from the least significant bit
+        char* end = result + length;
+        char padding_character = negative ? '1' : '0';
 
-        if (_use_separator_character) {
-            std::size_t current = 0u;
-
-            for (std::size_t i = 0u; i < num_padding_characters; ++i, ++current) {
-                if (current && (num_characters - current) % _group_size == 0u) {
-                    result[write_position++] = '\'';
-                }
-
-                result[write_position++] = value < 0 ? '1' : '0';
-            }
-
-            for (char* start = buffer; start != end; ++start, ++current) {
-                if (current && (num_characters - current) % _group_size == 0u) {
-                    result[write_position++] = '\'';
+        if (_group_size) {
+            std::size_t remaining = _group_size;
+            
+            for (std::size_t i = 0u; i < num_digits; ++i, --remaining) {
+                if (!remaining) {
+                    *--end = '\'';
+                    remaining = _group_size;
                 }
-
-                result[write_position++] = *start;
+                
+                *--end = i < num_characters ? static_cast<char>('0' + ((bits >> i) & 1u)) : padding_character;
             }
         }
         else {
-            for (std::size_t i = 0u; i < num_padding_characters; ++i) {
-                result[write_position++] = value < 0 ? '1' : '0';
+            std::size_t i = 0u;
+            
+            // Convert 4 bits at a time
+            for (; i + 4u <= num_characters; i += 4u) {
+                end -= 4;
+                std::memcpy(end, detail::binary_nibbles + ((bits >> i) & 0xfu) * 4u, 4u);
             }
-
-            // Copy contents directly
-            std::size_t num_characters_written = end - buffer;
-            result.replace(write_position, num_characters_written, buffer, 0, num_characters_written);
+            
+            for (; i < num_characters; ++i) {
+                *--end = static_cast<char>('0' + ((bits >> i) & 1u));
+            }
+            
+            end -= num_padding_characters;
+            std::memset(end, padding_character, num_padding_characters);
         }
 
-        return std::move(result);
+        if (use_base_prefix) {
+            result[0] = '0';
+            result[1] = 'b';
+        }
+        
+        if (result == buffer) {
+            FormatterBase::format_to(buffer, length, out);
+        }
     }
 
     template <typename T>
-    std::string IntegerFormatter<T>::to_hexadecimal(T value) const {
-        std::size_t num_characters;
-
-        // Compute the minimum number of characters to hold the formatted value
-        if (value < 0) {
-            // Twos complement is used for formatting negative values, which by default uses as many digits as required by the system architecture
-            num_characters = sizeof(T) * CHAR_BIT / 4;
-        }
-        else {
-            // The minimum number of digits required to format a binary number is log2(n) + 1
-            // Each hexadecimal character represents 4 bits
-            num_characters = (std::size_t) std::floor(std::log2(value) / 4) + 1u;
+    void IntegerFormatter<T>::to_hexadecimal(T value, FormatBuffer& out) const {
+        using U = typename std::make_unsigned<T>::type;
+        
+        // Twos complement is used for formatting negative values
+        U bits = static_cast<U>(value);
+        
+        bool negative = false;
+        if constexpr (std::is_signed<T>::value) {
+            negative = value < 0;
         }
-
+        
+        // Compute the minimum number of characters to hold the formatted value
+        // Negative values use as many digits as required by the system architecture, each hexadecimal character represents 4 bits
+        std::size_t num_characters = negative ? sizeof(T) * CHAR_BIT / 4u : std::max((static_cast<std::size_t>(std::bit_width(bits)) + 3u) / 4u, (std::size_t) 1u);
         std::size_t num_padding_characters = 0u;
 
         // The number of characters can be overridden by a user-specified 'digits' value
         // If the desired number of digits is smaller than the required number of digits, remove digits starting from the front (most significant) bits
-        // If the desired number of digits is larger than the required number of digits, append digits to the front (1 for negative integers, 0 for positive integers)
+        // If the desired number of digits is larger than the required number of digits, append digits to the front (f for negative integers, 0 for positive integers)
         if (digits) {
             std::uint8_t _digits = *digits;
             if (num_characters >= _digits) {
                 num_characters = _digits;
             }
             else {
-                // Append leading padding characters to reach the desired number of digits
                 num_padding_characters = _digits - num_characters;
             }
         }
-
-        bool _use_separator_character = false;
-        std::uint8_t _group_size = 0u;
-
-        if (use_separator_character) {
-            if (*use_separator_character) {
-                if (group_size) {
-                    _group_size = *group_size;
-
-                    if (*group_size) {
-                        _use_separator_character = true;
-                    }
-                    else {
-                        // Group size explicitly provided as 0, use of separator character is disabled
-                        _use_separator_character = false;
-                    }
-                }
-                else {
-                    // Group size is 4 by default (if not specified)
-                    _group_size = 4u;
-                    _use_separator_character = true;
-                }
-            }
-            else {
-                // Use of separator character explicitly disabled
-                _use_separator_character = false;
-            }
-        }
-        else {
-            // Use of separator character is disabled by default
-            _use_separator_character = false;
+        
+        // Use of separator character is disabled by default, group size is 4 by default (if not specified)
+        // Group size explicitly provided as 0 disables the use of separator character
+        std::size_t _group_size = 0u;
+        if (use_separator_character && *use_separator_character) {
+            _group_size = group_size ? *group_size : 4u;
         }
-
-        // Reserve capacity for separator characters (inserted between two groups)
-        std::size_t num_separator_characters = 0u;
-        if (_use_separator_character) {
-            num_separator_characters = (num_characters + num_padding_characters) / _group_size;
-
-            // Do not include a leading separator character if the number of characters is an even multiple of the group size
-            // Example: 0b'0000 should be 0b0000
-            if ((num_characters + num_padding_characters) % _group_size == 0) {
-                num_separator_characters -= 1u;
-            }
+        
+        std::size_t num_digits = num_characters + num_padding_characters;
+        std::size_t length = num_digits;
+        if (_group_size && num_digits) {
+            // Separators are inserted between two groups
+            length += (num_digits - 1u) / _group_size;
         }
-
-        std::size_t length = num_characters + num_padding_characters + num_separator_characters;
-
         if (use_base_prefix) {
             // +2 characters for base prefix '0x'
             length += 2u;
         }
 
-        std::size_t capacity = std::max(length, (std::size_t) width);
-        std::string result(capacity, fill_character);
-
-        std::size_t write_position;
-        switch (justification) {
-            case Justification::Left:
-                write_position = 0u;
-                break;
-            case Justification::Right:
-                write_position = capacity - length;
-                break;
-            case Justification::Center:
-                write_position = (capacity - length) / 2;
-                break;
-        }
-
-        // Convert value to binary
-        std::size_t num_characters_binary = num_characters * 4u;
-        char buffer[sizeof(T) * CHAR_BIT] { '0' };
-        char* end = buffer;
-        for (int i = 0; i < (int) num_characters_binary; ++i, ++end) {
-            int bit = (value >> (num_characters_binary - 1 - i)) & 1;
-            *end = (char) (48 + bit); // 48 is the ASCII code for '0'
-        }
-
-        if (use_base_prefix) {
-            result[write_position++] = '0';
-            result[write_position++] = 'x';
-        }
-
-        char nibble[4] = { '0' };
-
-        // Convert binary representation to hexadecimal
-        // Pad first group binary representation if necessary, as this group might not be the same size as the rest
-        // Example: 0b01001 has two groups (000)1 and 1001
-        std::size_t num_groups = num_characters_binary / 4u;
-        std::size_t remainder = num_characters_binary % 4u;
-        std::size_t num_padding_characters_binary = 0u;
-
-        if (remainder) {
-            // Number of binary characters does not equally divide into a hexadecimal representation, first group will require padding characters
-            num_groups += 1u;
-            num_padding_characters_binary = 4u - remainder;
+        // Values that do not require justification are written directly into the output buffer
+        // Digits and separator characters are each bounded by the maximum value of 'digits' (255), +2 characters for base prefix
+        char buffer[std::max(sizeof(T) * CHAR_BIT / 4u, (std::size_t) 255u) * 2u + 2u];
+        char* result = length >= width ? out.extend(length) : nullptr;
+        if (!result) {
+            result = buffer;
         }
+        
+        // Digits are written backwards, starting from the least significant nibble
+        char* end = result + length;
+        char padding_character = negative ? 'f' : '0';
 
-        if (_use_separator_character) {
-            std::size_t current = 0u;
-
-            // Append any extra padding characters
-            for (std::size_t i = 0u; i < num_padding_characters; ++i, ++current) {
-                if (current && (num_characters - current) % _group_size == 0u) {
-                    result[write_position++] = '\'';
-                }
-
-                result[write_position++] = value < 0 ? 'f' : '0';
-            }
-
-            char* ptr = buffer;
-            for (std::size_t group = 0; group < num_groups; ++group, ++current) {
-                // Insert separator
-                if (current && (num_characters - current) % _group_size == 0u) {
-                    result[write_position++] = '\'';
-                }
-
-                // Convert binary to hexadecimal
-                int i = 0;
-
-                // Append any necessary padding characters to the front of the nibble
-                if (num_padding_characters_binary) {
-                    for (; i < num_padding_characters_binary; ++i) {
-                        nibble[i] = value < 0 ? '1' : '0';
-                    }
-                    // Padding is only applicable to the first group
-                    num_padding_characters_binary = 0u;
-                }
-
-                while (i != 4) {
-                    nibble[i++] = *ptr++;
+        if (_group_size) {
+            std::size_t remaining = _group_size;
+            
+            for (std::size_t i = 0u; i < num_digits; ++i, --remaining) {
+                if (!remaining) {
+                    *--end = '\'';
+                    remaining = _group_size;
                 }
-                result[write_position++] = detail::nibble_to_hexadecimal(nibble);
+                
+                *--end = i < num_characters ? detail::hexadecimal_digits[(bits >> (i * 4u)) & 0xfu] : padding_character;
             }
         }
         else {
-            for (std::size_t i = 0u; i < num_padding_characters; ++i) {
-                result[write_position++] = value < 0 ? 'f' : '0';
-            }
-
-            char* ptr = buffer;
-            for (std::size_t group = 0; group < num_groups; ++group) {
-                // Convert binary to hexadecimal
-                int i = 0;
-
-                // Append any necessary padding characters to the front of the nibble
-                if (num_padding_characters_binary) {
-                    for (; i < num_padding_characters_binary; ++i) {
-                        nibble[i] = value < 0 ? '1' : '0';
-                    }
-                    // Padding is only applicable to the first group
-                    num_padding_characters_binary = 0u;
-                }
-
-                while (i != 4) {
-                    nibble[i++] = *ptr++;
-                }
-                result[write_position++] = detail::nibble_to_hexadecimal(nibble);
+            for (std::size_t i = 0u; i < num_characters; ++i) {
+                *--end = detail::hexadecimal_digits[(bits >> (i * 4u)) & 0xfu];
             }
+            
+            end -= num_padding_characters;
+            std::memset(end, padding_character, num_padding_characters);
         }
 
-        return std::move(result);
+        if (use_base_prefix) {
+            result[0] = '0';
+            result[1] = 'x';
+        }
+        
+        if (result == buffer) {
+            FormatterBase::format_to(buffer, length, out);
+        }
     }
 
     template <typename T>
     FloatingPointFormatter<T>::FloatingPointFormatter() : FormatterBase(),
                                                           representation(Representation::Fixed),
                                                           sign(Sign::NegativeOnly),
-                                                          precision(std::numeric_limits<T>::digits10) {
+                                                          precision(std::numeric_limits<T>::digits10),
+                                                          use_separator_character(false) {
         static_assert(is_floating_point_type<T>::value, "value must be a floating point type");
     }
 
@@ -991,6 +1905,12 @@ namespace utils {
             else if (icasecmp(value, "scientific")) {
                 representation = Representation::Scientific;
             }
+            else if (icasecmp(value, "shortest")) {
+                representation = Representation::Shortest;
+            }
+            else if (icasecmp(value, "general")) {
+                representation = Representation::General;
+            }
         }
 
         if (spec.has_specifier("sign")) {
@@ -1031,11 +1951,18 @@ namespace utils {
 
     template <typename T>
     std::string FloatingPointFormatter<T>::format(T value) const {
-        std::size_t length = 0u;
-        std::size_t read_offset = 0u;
-
-        // Sign character
-        length += value < 0 ? 1u : unsigned(sign != Sign::NegativeOnly);
+        return std::move(detail::format_to_string(*this, value));
+    }
+    
+    template <typename T>
+    void FloatingPointFormatter<T>::format_to(T value, FormatBuffer& out) const {
+        if (representation == Representation::Shortest || representation == Representation::General) {
+            to_shortest(value, out);
+            return;
+        }
+        
+        // Do not read negative sign from buffer, as it is written separately
+        std::size_t read_offset = value < 0 ? 1u : 0u;
 
         int num_significant_figures = std::numeric_limits<T>::digits10 + 1;
         if (precision) {
@@ -1063,21 +1990,16 @@ namespace utils {
         const auto& [ptr, error_code] = std::to_chars(start, end, value, format_flags, conversion_precision);
 
         std::size_t num_characters_written = ptr - (start + read_offset);
-        length += num_characters_written;
-
-        // Additional precision
-        length += std::max(0, num_significant_figures - conversion_precision);
 
         std::size_t decimal_position = num_characters_written;
         if (use_separator_character) {
             char* decimal = std::find(start + read_offset, ptr, '.');
             decimal_position = decimal - (start + read_offset);
-
-            // Separators get inserted every 3 characters up until the position of the decimal point
-            length += (decimal_position - 1) / 3;
         }
 
-        std::string result(length, fill_character);
+        // Formatted value is written to the stack before being justified into the output buffer
+        // Separators get inserted every 3 characters up until the position of the decimal point, additional precision is bounded by the maximum value of 'precision' (255)
+        char result[sizeof(buffer) + sizeof(buffer) / 3u + 256u];
         std::size_t write_position = 0;
 
         if (value < 0) {
@@ -1147,7 +2069,81 @@ namespace utils {
             }
         }
 
-        return std::move(FormatterBase::format(result));
+        FormatterBase::format_to(result, write_position, out);
+    }
+    
+    template <typename T>
+    void FloatingPointFormatter<T>::to_shortest(T value, FormatBuffer& out) const {
+        // The shortest representation is bounded by: sign, significant digits, decimal point, 'e', exponent sign, exponent digits (at most 4), and leading zeros for small values in general notation ("0.000")
+        constexpr std::size_t max_length = 1u + std::numeric_limits<T>::max_digits10 + 1u + 2u + 4u + 4u;
+        
+        char sign_character = '\0';
+        if (!std::signbit(value)) {
+            if (sign == Sign::Aligned) {
+                sign_character = ' ';
+            }
+            else if (sign == Sign::Both) {
+                sign_character = '+';
+            }
+        }
+        
+        // Negative sign is written by std::to_chars
+        auto convert = [this, sign_character, value](char* first, char* last) -> char* {
+            if (sign_character) {
+                *first++ = sign_character;
+            }
+            
+            if (representation == Representation::General) {
+                return std::to_chars(first, last, value, std::chars_format::general).ptr;
+            }
+            return std::to_chars(first, last, value).ptr;
+        };
+        
+        if (!use_separator_character && FormatterBase::width == 0u) {
+            // No justification necessary, value is converted directly into the storage of the output buffer
+            out.reserve(out.size() + max_length);
+            if (out.capacity() - out.size() >= max_length) {
+                char* start = out.data() + out.size();
+                (void) out.extend(convert(start, start + max_length) - start);
+                return;
+            }
+        }
+        
+        char buffer[max_length];
+        std::size_t length = convert(buffer, buffer + max_length) - buffer;
+        
+        if (!use_separator_character) {
+            FormatterBase::format_to(buffer, length, out);
+            return;
+        }
+        
+        // Separators get inserted every 3 characters up until the end of the integer portion of the value
+        // Values in scientific notation contain at most one integer digit, and do not require separators
+        char result[max_length + max_length / 3u];
+        std::size_t write_position = 0u;
+        
+        std::size_t i = 0u;
+        while (i < length && (buffer[i] < '0' || buffer[i] > '9')) {
+            // Sign
+            result[write_position++] = buffer[i++];
+        }
+        
+        std::size_t num_integer_digits = 0u;
+        while (i + num_integer_digits < length && buffer[i + num_integer_digits] >= '0' && buffer[i + num_integer_digits] <= '9') {
+            ++num_integer_digits;
+        }
+        
+        for (std::size_t digit = 0u; digit < num_integer_digits; ++digit) {
+            if (digit && (num_integer_digits - digit) % 3u == 0u) {
+                result[write_position++] = ',';
+            }
+            result[write_position++] = buffer[i++];
+        }
+        
+        std::memcpy(result + write_position, buffer + i, length - i);
+        write_position += length - i;
+        
+        FormatterBase::format_to(result, write_position, out);
     }
     
     template <typename T, typename U>
@@ -1180,39 +2176,33 @@ namespace utils {
     
     template <typename T, typename U>
     std::string Formatter<std::pair<T, U>>::format(const std::pair<T, U>& value) const {
-        std::string first = m_formatters.first.format(value.first);
-        std::string second = m_formatters.second.format(value.second);
+        return std::move(detail::format_to_string(*this, value));
+    }
+    
+    template <typename T, typename U>
+    void Formatter<std::pair<T, U>>::format_to(const std::pair<T, U>& value, FormatBuffer& out) const {
+        if (FormatterBase::width == 0u) {
+            // No justification necessary, elements are written directly into the output buffer
+            write(value, out);
+            return;
+        }
         
+        std::string result;
+        {
+            detail::StringBuffer buffer(result);
+            write(value, buffer);
+        }
+        FormatterBase::format_to(result.data(), result.length(), out);
+    }
+    
+    template <typename T, typename U>
+    void Formatter<std::pair<T, U>>::write(const std::pair<T, U>& value, FormatBuffer& out) const {
         // Format: { first, second }
-        
-        // 2 characters for container opening / closing braces { }
-        // 2 characters for leading space before the first element and trailing space after the last element
-        // 2 characters for comma + space in between characters
-        std::size_t length = 6 + first.length() + second.length();
-        std::string result(length, fill_character);
-        
-        std::size_t write_position = 0;
-        
-        result[write_position++] = '{';
-        result[write_position++] = ' ';
-        
-        // First
-        length = first.length();
-        result.replace(write_position, length, first, 0, length);
-        write_position += length;
-        
-        result[write_position++] = ',';
-        result[write_position++] = ' ';
-        
-        // Second
-        length = second.length();
-        result.replace(write_position, length, second, 0, length);
-        write_position += length;
-        
-        result[write_position++] = ' ';
-        result[write_position++] = '}';
-        
-        return std::move(FormatterBase::format(result));
+        out.append("{ ");
+        detail::format_argument(m_formatters.first, value.first, out);
+        out.append(", ");
+        detail::format_argument(m_formatters.second, value.second, out);
+        out.append(" }");
     }
     
     // std::tuple
@@ -1251,125 +2241,146 @@ namespace utils {
     
     template <typename ...Ts>
     std::string Formatter<std::tuple<Ts...>>::format(const std::tuple<Ts...>& value) const {
-        constexpr std::size_t num_elements = sizeof...(Ts);
-        if constexpr (num_elements == 0) {
-            return "{ }";
+        return std::move(detail::format_to_string(*this, value));
+    }
+    
+    template <typename ...Ts>
+    void Formatter<std::tuple<Ts...>>::format_to(const std::tuple<Ts...>& value, FormatBuffer& out) const {
+        if constexpr (sizeof...(Ts) == 0) {
+            out.append("{ }");
+            return;
         }
         
-        std::vector<std::string> elements { };
-        elements.reserve(num_elements);
+        if (FormatterBase::width == 0u) {
+            // No justification necessary, elements are written directly into the output buffer
+            write(value, out);
+            return;
+        }
         
+        std::string result;
+        {
+            detail::StringBuffer buffer(result);
+            write(value, buffer);
+        }
+        FormatterBase::format_to(result.data(), result.length(), out);
+    }
+    
+    template <typename ...Ts>
+    void Formatter<std::tuple<Ts...>>::write(const std::tuple<Ts...>& value, FormatBuffer& out) const {
         // Format: { first, second, ... }
+        out.append("{ ");
         
-        // 2 characters for container opening / closing braces { }
-        // 2 characters for leading space before the first element and trailing space after the last element
-        // 2 characters for comma + space between two elements (per element - 1)
-        std::size_t length = 4 + (sizeof...(Ts) - 1) * 2;
-        
-        // Cache formatted values and their lengths
-        utils::apply([&elements, &length, &formatters = m_formatters]<typename T, std::size_t I>(const T& value) {
-            elements.emplace_back(std::get<I>(formatters).format(value));
-            length += elements.back().length();
-        }, value);
-        
-        std::string result(length, fill_character);
-        std::size_t write_position = 0;
-
-        result[write_position++] = '{';
-        result[write_position++] = ' ';
-        
-        for (std::size_t i = 0u; i < num_elements; ++i) {
-            length = elements[i].length();
-            result.replace(write_position, length, elements[i], 0, length);
-            write_position += length;
-
+        utils::apply([&out, &formatters = m_formatters]<typename T, std::size_t I>(const T& value) {
             // Elements are formatted into a comma-separated list
-            if (i != num_elements - 1) {
-                // Do not insert a trailing comma
-                result[write_position++] = ',';
-                result[write_position++] = ' ';
+            if constexpr (I != 0) {
+                out.append(", ");
             }
-        }
-        
-        result[write_position++] = ' ';
-        result[write_position++] = '}';
+            detail::format_argument(std::get<I>(formatters), value, out);
+        }, value);
         
-        return std::move(FormatterBase::format(result));
+        out.append(" }");
     }
     
-    template <typename T>
-    Formatter<std::vector<T>>::Formatter() : FormatterBase(),
-                                             m_formatter() {
+    template <Container C>
+    Formatter<C>::Formatter() : ContainerFormatterBase(),
+                                m_formatter() {
     }
     
-    template <typename T>
-    Formatter<std::vector<T>>::~Formatter() = default;
+    template <Container C>
+    Formatter<C>::~Formatter() = default;
     
-    template <typename T>
-    void Formatter<std::vector<T>>::parse(const utils::FormatSpec& spec) {
+    template <Container C>
+    void Formatter<C>::parse(const utils::FormatSpec& spec) {
         if (spec.type() == FormatSpec::Type::SpecifierList) {
-            FormatterBase::parse(spec);
+            ContainerFormatterBase::parse(spec);
+            
+            if constexpr (is_floating_point_type<T>::value) {
+                // Specifiers that only apply to floating point values are forwarded to the elements, {:representation=[shortest]} is equivalent to {::representation=[shortest]}
+                // Justification, width, and fill character continue to apply to the container as a whole
+                alignas(std::max_align_t) char storage[256];
+                std::pmr::monotonic_buffer_resource arena(storage, sizeof(storage));
+                FormatSpec elements(&arena);
+                
+                for (std::string_view name : { "representation", "sign", "precision" }) {
+                    if (spec.has_specifier(name)) {
+                        elements.set_specifier(name, spec.get_specifier(name));
+                    }
+                }
+                
+                if (spec.has_specifier("use_separator", "useseparator", "use_separator_character", "useseparatorcharacter")) {
+                    FormatSpec::SpecifierView specifier = spec.get_specifier("use_separator", "useseparator", "use_separator_character", "useseparatorcharacter");
+                    elements.set_specifier(specifier.name, specifier.value);
+                }
+                
+                if (!elements.empty()) {
+                    m_formatter.parse(elements);
+                }
+            }
         }
         else {
             if (spec.has_group(0)) {
                 const FormatSpec& group = spec.get_group(0);
-                ASSERT(group.type() == FormatSpec::Type::SpecifierList, "invalid std::vector format spec - formatting group 0 must be a specifier list");
-                FormatterBase::parse(group);
+                ASSERT(group.type() == FormatSpec::Type::SpecifierList, "invalid container format spec - formatting group 0 must be a specifier list");
+                ContainerFormatterBase::parse(group);
             }
             if (spec.has_group(1)) {
+                // The second formatting group is applied to every element
                 m_formatter.parse(spec.get_group(1));
             }
         }
     }
     
-    template <typename T>
-    std::string Formatter<std::vector<T>>::format(const std::vector<T>& value) const {
-        if (value.empty()) {
-            return "[ ]";
+    template <Container C>
+    std::string Formatter<C>::format(const C& value) const {
+        return std::move(detail::format_to_string(*this, value));
+    }
+    
+    template <Container C>
+    void Formatter<C>::format_to(const C& value, FormatBuffer& out) const {
+        if (std::begin(value) == std::end(value)) {
+            out.append("[ ]");
+            return;
         }
         
-        std::size_t num_elements = value.size();
-        std::vector<std::string> elements;
-        elements.reserve(num_elements);
-        
-        // Format: [ 1, 2, 3, ... ]
-        
-        // 2 characters for container opening / closing brackets [ ]
-        // 2 characters for leading space before the first element and trailing space after the last element
-        // 2 characters for comma + space between two elements (per element - 1)
-        std::size_t length = 4 + (num_elements - 1) * 2;
-        for (const T& element : value) {
-            elements.emplace_back(m_formatter.format(element));
-            length += elements.back().length();
+        if (FormatterBase::width == 0u) {
+            // No justification necessary, elements are written directly into the output buffer
+            write(value, out);
+            return;
         }
         
-        std::string result(length, fill_character);
-        std::size_t write_position = 0;
-        
-        result[write_position++] = '[';
-        result[write_position++] = ' ';
+        std::string result;
+        {
+            detail::StringBuffer buffer(result);
+            write(value, buffer);
+        }
+        FormatterBase::format_to(result.data(), result.length(), out);
+    }
+    
+    template <Container C>
+    void Formatter<C>::write(const C& value, FormatBuffer& out) const {
+        // Format: [ 1, 2, 3, ... ]
+        out.append("[ ");
         
-        for (std::size_t i = 0; i < num_elements; ++i) {
-            length = elements[i].length();
-            result.replace(write_position, length, elements[i], 0, length);
-            write_position += length;
-            
+        std::size_t count = 0u;
+        for (auto iter = std::begin(value); iter != std::end(value); ++iter, ++count) {
             // Elements are formatted into a comma-separated list
-            if (i != num_elements - 1) {
-                // Do not insert a trailing comma
-                result[write_position++] = ',';
-                result[write_position++] = ' ';
+            if (count) {
+                out.append(", ");
             }
+            
+            if (max_elements && count == *max_elements) {
+                out.append(truncation_marker);
+                break;
+            }
+            
+            detail::format_argument(m_formatter, *iter, out);
         }
         
-        result[write_position++] = ' ';
-        result[write_position++] = ']';
-        
-        return std::move(FormatterBase::format(result));
+        out.append(" ]");
     }
     
     template <typename K, typename V, typename H, typename P, typename A>
-    Formatter<std::unordered_map<K, V, H, P, A>>::Formatter() : FormatterBase(),
+    Formatter<std::unordered_map<K, V, H, P, A>>::Formatter() : ContainerFormatterBase(),
                                                                 m_key_formatter(),
                                                                 m_value_formatter() {
     }
@@ -1381,13 +2392,13 @@ namespace utils {
     void Formatter<std::unordered_map<K, V, H, P, A>>::parse(const FormatSpec& spec) {
         if (spec.type() == FormatSpec::Type::SpecifierList) {
             // A format spec consisting of a list of specifiers is applied globally to the unordered map
-            FormatterBase::parse(spec);
+            ContainerFormatterBase::parse(spec);
         }
         else {
             if (spec.has_group(0)) {
                 const FormatSpec& group = spec.get_group(0);
                 ASSERT(group.type() == FormatSpec::Type::SpecifierList, "invalid std::unordered_map format spec - formatting group 0 must be a specifier list");
-                FormatterBase::parse(group);
+                ContainerFormatterBase::parse(group);
             }
             if (spec.has_group(1)) {
                 // The second formatting group is applied to the map key type
@@ -1402,79 +2413,61 @@ namespace utils {
     
     template <typename K, typename V, typename H, typename P, typename A>
     std::string Formatter<std::unordered_map<K, V, H, P, A>>::format(const T& value) const {
+        return std::move(detail::format_to_string(*this, value));
+    }
+    
+    template <typename K, typename V, typename H, typename P, typename A>
+    void Formatter<std::unordered_map<K, V, H, P, A>>::format_to(const T& value, FormatBuffer& out) const {
         if (value.empty()) {
-            return "{ }";
+            out.append("{ }");
+            return;
         }
         
-        std::size_t num_elements = value.size();
-
-        // Format elements
-        std::vector<std::pair<std::string, std::string>> elements;
-        elements.reserve(num_elements);
-        for (auto iter = std::begin(value); iter != std::end(value); ++iter) {
-            elements.emplace_back(m_key_formatter.format(iter->first), m_value_formatter.format(iter->second));
+        if (FormatterBase::width == 0u) {
+            // No justification necessary, elements are written directly into the output buffer
+            write(value, out);
+            return;
         }
-
-        // Format: { { key: value }, { key: value }, ... }
-        
-        // 2 characters for container opening / closing braces { }
-        // 2 characters for leading space before the first element and trailing space after the last element
         
-        // 2 characters for element opening / closing braces { } (per element)
-        // 2 characters for leading space before the element key and trailing space after the element value (per element)
-        // 2 characters for comma + space between element key and value (per element)
-        // 2 characters for comma + space between two elements (per element - 1)
-        std::size_t length = 4 + (num_elements * 6) + (num_elements - 1) * 2;
-        for (const std::pair<std::string, std::string>& element : elements) {
-            length += element.first.length();
-            length += element.second.length();
+        std::string result;
+        {
+            detail::StringBuffer buffer(result);
+            write(value, buffer);
         }
-
-        std::string result(length, fill_character);
-        std::size_t write_position = 0;
-
-        result[write_position++] = '{';
-        result[write_position++] = ' ';
-
-        for (std::size_t i = 0u; i < num_elements; ++i) {
-            // Element format: { key: value }
-            const std::pair<std::string, std::string>& element = elements[i];
-            
-            result[write_position++] = '{';
-            result[write_position++] = ' ';
-            
-            // Key
-            length = element.first.length();
-            result.replace(write_position, length, element.first, 0, length);
-            write_position += length;
-
-            result[write_position++] = ':';
-            result[write_position++] = ' ';
-            
-            // Value
-            length = element.second.length();
-            result.replace(write_position, length, element.second, 0, length);
-            write_position += length;
-            
-            result[write_position++] = ' ';
-            result[write_position++] = '}';
-            
+        FormatterBase::format_to(result.data(), result.length(), out);
+    }
+    
+    template <typename K, typename V, typename H, typename P, typename A>
+    void Formatter<std::unordered_map<K, V, H, P, A>>::write(const T& value, FormatBuffer& out) const {
+        // Format: { { key: value }, { key: value }, ... }
+        out.append("{ ");
+        
+        std::size_t count = 0u;
+        for (auto iter = std::begin(value); iter != std::end(value); ++iter, ++count) {
             // Elements are formatted into a comma-separated list
-            if (i != num_elements - 1) {
-                // Do not insert a trailing comma
-                result[write_position++] = ',';
-                result[write_position++] = ' ';
+            if (count) {
+                out.append(", ");
+            }
+            
+            if (max_elements && count == *max_elements) {
+                out.append(truncation_marker);
+                break;
             }
+            
+            // Element format: { key: value }
+            out.append("{ ");
+            detail::format_argument(m_key_formatter, iter->first, out);
+            out.append(": ");
+            detail::format_argument(m_value_formatter, iter->second, out);
+            out.append(" }");
         }
-
-        result[write_position++] = ' ';
-        result[write_position++] = '}';
-
-        return std::move(FormatterBase::format(result));
+        
+        out.append(" }");
     }
     
     template <typename K, typename H, typename E, typename A>
-    Formatter<std::unordered_set<K, H, E, A>>::Formatter() : Formatter<K>() {
+    Formatter<std::unordered_set<K, H, E, A>>::Formatter() : ContainerFormatterBase(),
+                                                             m_formatter() {
     }
     
     template <typename K, typename H, typename E, typename A>
@@ -1483,74 +2476,69 @@ namespace utils {
     template <typename K, typename H, typename E, typename A>
     void Formatter<std::unordered_set<K, H, E, A>>::parse(const utils::FormatSpec& spec) {
         if (spec.type() == FormatSpec::Type::SpecifierList) {
-            // A format spec consisting of a list of specifiers is applied globally to the unordered map
-            FormatterBase::parse(spec);
+            // A format spec consisting of a list of specifiers is applied globally to the unordered set
+            ContainerFormatterBase::parse(spec);
         }
         else {
             if (spec.has_group(0)) {
                 const FormatSpec& group = spec.get_group(0);
-                ASSERT(group.type() == FormatSpec::Type::SpecifierList, "invalid std::unordered_map format spec - formatting group 0 must be a specifier list");
-                FormatterBase::parse(group);
+                ASSERT(group.type() == FormatSpec::Type::SpecifierList, "invalid std::unordered_set format spec - formatting group 0 must be a specifier list");
+                ContainerFormatterBase::parse(group);
             }
             if (spec.has_group(1)) {
                 // The second formatting group is applied to the underlying set type
-                Formatter<K>::parse(spec.get_group(1));
+                m_formatter.parse(spec.get_group(1));
             }
         }
     }
     
     template <typename K, typename H, typename E, typename A>
     std::string Formatter<std::unordered_set<K, H, E, A>>::format(const T& value) const {
+        return std::move(detail::format_to_string(*this, value));
+    }
+    
+    template <typename K, typename H, typename E, typename A>
+    void Formatter<std::unordered_set<K, H, E, A>>::format_to(const T& value, FormatBuffer& out) const {
         if (value.empty()) {
-            return "{ }";
+            out.append("{ }");
+            return;
         }
         
-        std::size_t num_elements = value.size();
-
-        // Format elements
-        std::vector<std::string> elements;
-        elements.reserve(num_elements);
-        
-        for (const K& element : value) {
-            elements.emplace_back(Formatter<K>::format(element));
+        if (FormatterBase::width == 0u) {
+            // No justification necessary, elements are written directly into the output buffer
+            write(value, out);
+            return;
         }
         
+        std::string result;
+        {
+            detail::StringBuffer buffer(result);
+            write(value, buffer);
+        }
+        FormatterBase::format_to(result.data(), result.length(), out);
+    }
+    
+    template <typename K, typename H, typename E, typename A>
+    void Formatter<std::unordered_set<K, H, E, A>>::write(const T& value, FormatBuffer& out) const {
         // Format: { value, ... }
+        out.append("{ ");
         
-        // 2 characters for container opening / closing braces { }
-        // 2 characters for leading space before the first element and trailing space after the last element
-        // 2 characters for comma + space between two elements (per element - 1)
-        std::size_t length = 4 + (num_elements - 1) * 2;
-        for (const std::string& element : elements) {
-            length += element.length();
-        }
-
-        std::string result(length, Formatter<K>::fill_character);
-        std::size_t write_position = 0;
-
-        result[write_position++] = '{';
-        result[write_position++] = ' ';
-
-        for (std::size_t i = 0u; i < num_elements; ++i) {
-            // Element format: { key: value }
-            const std::string& element = elements[i];
-
-            length = element.length();
-            result.replace(write_position, length, element, 0, length);
-            write_position += length;
-            
+        std::size_t count = 0u;
+        for (auto iter = std::begin(value); iter != std::end(value); ++iter, ++count) {
             // Elements are formatted into a comma-separated list
-            if (i != num_elements - 1) {
-                // Do not insert a trailing comma
-                result[write_position++] = ',';
-                result[write_position++] = ' ';
+            if (count) {
+                out.append(", ");
+            }
+            
+            if (max_elements && count == *max_elements) {
+                out.append(truncation_marker);
+                break;
             }
+            
+            detail::format_argument(m_formatter, *iter, out);
         }
-
-        result[write_position++] = ' ';
-        result[write_position++] = '}';
-
-        return std::move(FormatterBase::format(result));
+        
+        out.append(" }");
     }
     
     template <typename T>
@@ -1558,6 +2546,11 @@ namespace utils {
         return Formatter<T>::format(value.value);
     }
     
+    template <typename T>
+    void Formatter<NamedArgument<T>>::format_to(const NamedArgument<T>& value, FormatBuffer& out) const {
+        detail::format_argument(static_cast<const Formatter<T>&>(*this), value.value, out);
+    }
+    
 }
 
 #endif // STRING_TPP
@@ -0,0 +1,57 @@
+
+#pragma once
+
+#ifndef TRACE_TPP
+#define TRACE_TPP
+
+#include "utils/logging.hpp"
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+    #define UTILS_TRACE_RDTSC 1
+    #if defined(_MSC_VER)
+        #include <intrin.h> // __rdtsc
+    #else
+        #include <x86intrin.h> // __rdtsc
+    #endif
+#endif
+
+namespace utils {
+    namespace trace {
+        namespace detail {
+            
+            // Checked by spans before reading the timestamp counter
+            inline std::atomic<bool> enabled { false };
+            
+            inline std::uint64_t read_ticks() {
+                #if defined(UTILS_TRACE_RDTSC)
+                    return __rdtsc();
+                #else
+                    return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+                #endif
+            }
+            
+        }
+        
+        // Spans are constructed and destroyed on hot paths, and are defined inline so that disabled spans only cost a scope push / pop and a relaxed load
+        
+        inline ScopedSpan::ScopedSpan(std::string_view name, std::source_location source) : m_name(name.empty() ? std::string_view(source.function_name()) : name),
+                                                                                            m_source(source),
+                                                                                            m_begin(0u),
+                                                                                            m_recording(detail::enabled.load(std::memory_order_relaxed)) {
+            logging::detail::push_scope_view(m_name);
+            if (m_recording) {
+                m_begin = detail::read_ticks();
+            }
+        }
+        
+        inline ScopedSpan::~ScopedSpan() {
+            if (m_recording) {
+                detail::record(m_name, m_source, m_begin, detail::read_ticks());
+            }
+            logging::pop_scope();
+        }
+        
+    }
+}
+
+#endif // TRACE_TPP
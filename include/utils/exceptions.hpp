@@ -11,7 +11,7 @@ namespace utils {
     
     struct FormattedError : public std::runtime_error {
         template <typename ...Ts>
-        FormattedError(std::string_view fmt, const Ts&... args);
+        FormattedError(FormatString<std::type_identity_t<Ts>...> fmt, const Ts&... args);
     };
     
 }
@@ -2,13 +2,89 @@
 #ifndef FILESYSTEM_HPP
 #define FILESYSTEM_HPP
 
+#include "utils/platform.hpp"
+
 #include <string> // std::string
+#include <string_view> // std::string_view
 #include <filesystem> // std::filesystem
+#include <memory> // std::unique_ptr
+#include <cstdint> // std::uint8_t
 
 namespace utils {
-    
+
+    // Loads the contents of the file in text mode: line endings are normalized to '\n' (on Windows), and the contents always end with a newline (unless empty)
+    // The file is read with a single read and normalized in place
     std::string load(const std::filesystem::path& path);
-    
+
+    // Loads the contents of the file as-is, with a single read
+    std::string load_binary(const std::filesystem::path& path);
+
+    namespace detail {
+        class ReadableFile;
+    }
+
+    // Read-only memory mapping of an entire file, which avoids copying the contents into a separately allocated buffer
+    // Pages are read in on first access, the access pattern is passed on to the operating system as a hint for read-ahead
+    class MappedFile {
+        public:
+            enum class Access : std::uint8_t {
+                Sequential = 0,
+                Random
+            };
+
+            // Throws if the file cannot be opened or mapped
+            explicit MappedFile(const std::filesystem::path& path, Access access = Access::Sequential);
+            ~MappedFile();
+
+            MappedFile(const MappedFile& other) = delete;
+            MappedFile& operator=(const MappedFile& other) = delete;
+
+            MappedFile(MappedFile&& other) noexcept;
+            MappedFile& operator=(MappedFile&& other) noexcept;
+
+            // Valid for the lifetime of the mapping
+            [[nodiscard]] std::string_view contents() const;
+            [[nodiscard]] std::size_t size() const;
+            [[nodiscard]] bool empty() const;
+
+        private:
+            void unmap();
+
+            const char* m_data; // Empty files are not mapped
+            std::size_t m_size;
+
+            #if defined(PLATFORM_WINDOWS)
+                void* m_mapping; // HANDLE of the file mapping object
+            #endif
+    };
+
+    // Reads a file in fixed-size chunks and yields its lines as views into the chunk buffer
+    // Only the (partial) line at the end of a chunk is moved to the front of the buffer before the next chunk is read, lines are never copied individually
+    class FileReader {
+        public:
+            // Throws if the file cannot be opened
+            explicit FileReader(const std::filesystem::path& path, std::size_t chunk_size = 64u * 1024u);
+            ~FileReader();
+
+            // Returns false once all lines have been read, throws if reading from the file fails
+            // 'line' does not include the line terminator ('\n' or "\r\n"), and remains valid until the next call
+            // Lines longer than the chunk size grow the buffer
+            bool next_line(std::string_view& line);
+
+        private:
+            // Reads the next chunk into the buffer, after any unprocessed data, returns false at the end of the file
+            bool fill();
+
+            std::unique_ptr<detail::ReadableFile> m_file;
+
+            std::unique_ptr<char[]> m_buffer;
+            std::size_t m_capacity;
+            std::size_t m_chunk_size;
+            std::size_t m_position; // Start of the first unprocessed character
+            std::size_t m_size; // End of the valid data in the buffer
+            bool m_eof;
+    };
+
 }
 
 #endif // FILESYSTEM_HPP
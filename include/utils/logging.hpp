@@ -15,6 +15,12 @@
 #include <functional> // std::function
 #include <span> // std::span
 #include <mutex> // std::mutex
+#include <memory_resource> // std::pmr::memory_resource
+#include <cstdint> // std::uint8_t, std::uint32_t
+#include <vector> // std::vector
+#include <atomic> // std::atomic
+#include <memory> // std::unique_ptr, std::shared_ptr
+#include <chrono> // std::chrono::milliseconds, std::chrono::seconds
 
 #if defined(PLATFORM_WINDOWS)
     #include <Windows.h>
@@ -22,6 +28,12 @@
     #include <unistd.h> // pid_t
 #endif
 
+// Messages below this level are removed at compile time (0: debug, 1: info, 2: warning, 3: error)
+// Calls to the logging functions of removed levels return immediately, without checking sink levels or formatting their arguments
+#ifndef UTILS_LOG_MIN_LEVEL
+    #define UTILS_LOG_MIN_LEVEL 0
+#endif
+
 namespace utils {
     
     namespace logging {
@@ -42,8 +54,13 @@ namespace utils {
             
             std::string_view format;
             std::source_location source;
-            Timestamp timestamp;
-            std::string message;
+            // Set when the message is logged, after it has passed level filtering
+            // Converted to a calendar date / time only by sinks that reference it
+            Clock::time_point timestamp;
+            
+            // Formatted message content
+            // Note: references storage from the thread-local message arena, which is only valid while the message is being processed by sinks
+            std::string_view message;
             
             std::thread::id thread_id;
             
@@ -53,10 +70,116 @@ namespace utils {
                 pid_t process_id;
             #endif
             
-            // Scope that this message was logged from
-            std::span<std::string> scope;
+            // Scope that this message was logged from (outermost first)
+            std::span<const std::string_view> scope;
         };
         
+        namespace detail {
+            
+            // Provides access to a thread-local monotonic arena used for the storage of formatted messages
+            // Memory allocated from the arena is released all at once when the outermost MessageArena on the thread goes out of scope
+            // Released memory is kept by the thread for reuse, so logging does not allocate from the global heap in steady state
+            class MessageArena {
+                public:
+                    MessageArena();
+                    ~MessageArena();
+                    
+                    MessageArena(const MessageArena& other) = delete;
+                    MessageArena& operator=(const MessageArena& other) = delete;
+                    
+                    [[nodiscard]] std::pmr::memory_resource* resource() const;
+            };
+            
+            // Layout of binary log files (all values are stored in native byte order):
+            //   header: magic ("UTILSLOG"), u32 version
+            //   records: u8 record type, u32 size (number of bytes that follow), contents
+            //
+            // Format records describe a log statement, and precede the first message record that references them:
+            //   u32 id, u32 line, u32 column, string format, string filename, string function name
+            //
+            // Message records:
+            //   u32 format id, u8 level, i64 timestamp (nanoseconds since the Unix epoch), u64 thread ID, u32 process ID,
+            //   u8 scope depth, string name (for each scope), u8 argument count, arguments
+            //
+            // Arguments are stored as a u8 argument type followed by:
+            //   - arithmetic types, pointers: raw value bytes
+            //   - strings: u32 length followed by characters (no null terminator)
+            //   - named arguments: string name, followed by the (unnamed) argument
+            
+            inline constexpr std::string_view binary_log_magic = "UTILSLOG";
+            inline constexpr std::uint32_t binary_log_version = 1u;
+            
+            // Upper bound on the number of arguments of a message logged in deferred mode, shared with the decoder
+            inline constexpr std::size_t max_deferred_arguments = 12u;
+            
+            enum class RecordType : std::uint8_t {
+                Format = 1,
+                Message,
+            };
+            
+            enum class ArgumentType : std::uint8_t {
+                Char = 0,
+                Int8,
+                UInt8,
+                Int16,
+                UInt16,
+                Int32,
+                UInt32,
+                Int64,
+                UInt64,
+                Float,
+                Double,
+                Pointer,
+                String,
+                Named,
+            };
+            
+            // Serialized message record
+            struct BinaryRecord {
+                Message::Level level;
+                std::uint32_t format_id;
+                std::string_view data;
+            };
+            
+            // Sink format string compiled into a sequence of literals and message fields, with the formatter of each field parsed ahead of time
+            // Only the fields referenced by the format string are evaluated when a message is rendered
+            class SinkLayout {
+                public:
+                    // Throws an exception if the format string is invalid or references an unknown placeholder
+                    explicit SinkLayout(std::string format);
+                    ~SinkLayout();
+                    
+                    SinkLayout(const SinkLayout& other) = delete;
+                    SinkLayout& operator=(const SinkLayout& other) = delete;
+                    
+                    [[nodiscard]] std::string_view format() const;
+                    void render(const Message& message, FormatBuffer& out) const;
+                    
+                private:
+                    struct Field;
+                    
+                    // Parses the formatter of 'field' from the format spec of the field
+                    template <typename T>
+                    static void parse_field(Field& field);
+                    
+                    template <typename T>
+                    static void render_field(const Field& field, const T& value, FormatBuffer& out);
+                    
+                    // Literals and format specs of the fields reference the characters of the format string
+                    std::string m_format;
+                    std::vector<Field> m_fields;
+            };
+            
+            // Lines rendered for a single message, shared between sinks with identical layouts
+            class RenderCache;
+            
+            // Buffers the output of a FileSink and writes it out on a background thread
+            class FileWriter;
+            
+        }
+        
+        class Logger;
+        
         template <typename ...Ts>
         void info(Message message, const Ts&... args);
         
@@ -73,9 +196,118 @@ namespace utils {
         template <typename ...Ts>
         void fatal(Message message, const Ts&... args);
         
+        // Per-call-site limits on the number of messages that are logged, for protecting throughput (and disk) during log storms
+        // Limiters hold atomic state and are meant to be declared static at a single call site, which the LOG_* macros below do automatically
+        // should_log() is checked after the level of the message, but before the message is formatted or timestamped
+        
+        // Logs the first message, and every Nth message after it
+        class EveryN {
+            public:
+                explicit EveryN(std::uint64_t n);
+                ~EveryN();
+                
+                [[nodiscard]] bool should_log();
+                
+            private:
+                std::uint64_t m_n;
+                std::atomic<std::uint64_t> m_count;
+        };
+        
+        // Logs only the first N messages
+        class FirstN {
+            public:
+                explicit FirstN(std::uint64_t n);
+                ~FirstN();
+                
+                [[nodiscard]] bool should_log();
+                
+            private:
+                std::uint64_t m_n;
+                std::atomic<std::uint64_t> m_count;
+        };
+        
+        // Token bucket that holds up to 'burst' messages, and is refilled at a rate of one message per 'interval'
+        // Implemented as a generic cell rate algorithm, which tracks the bucket with a single timestamp
+        class RateLimit {
+            public:
+                explicit RateLimit(std::chrono::nanoseconds interval, std::uint32_t burst = 1u);
+                ~RateLimit();
+                
+                [[nodiscard]] bool should_log();
+                
+                // Returns the number of messages rejected since the last call
+                [[nodiscard]] std::uint64_t take_suppressed();
+                
+            private:
+                std::int64_t m_interval; // Nanoseconds
+                std::int64_t m_tolerance; // Nanoseconds a message may arrive ahead of schedule
+                std::atomic<std::int64_t> m_next; // Time at which the bucket holds a single message
+                std::atomic<std::uint64_t> m_suppressed;
+        };
+        
+        // Collapses repeated messages: a message is rejected if it follows the previous message from the same call site within 'window'
+        // Arguments are not compared (they are not formatted yet), so messages from the same call site are considered repeats of each other
+        class Deduplicator {
+            public:
+                explicit Deduplicator(std::chrono::nanoseconds window = std::chrono::seconds(1));
+                ~Deduplicator();
+                
+                [[nodiscard]] bool should_log();
+                
+                // Returns the number of messages rejected since the last call
+                [[nodiscard]] std::uint64_t take_suppressed();
+                
+            private:
+                std::int64_t m_window; // Nanoseconds
+                std::atomic<std::int64_t> m_last; // Time of the previous message
+                std::atomic<std::uint64_t> m_suppressed;
+        };
+        
         // Scopes are thread local
         void push_scope(std::string name);
-        void pop_scope();
+        void pop_scope(); // Pops the innermost scope, regardless of how it was pushed
+        
+        namespace detail {
+            
+            // Pushes a scope without copying its name, which must remain valid until the scope is popped
+            void push_scope_view(std::string_view name);
+            
+        }
+        
+        // In asynchronous mode, messages are formatted on the calling thread and pushed into a bounded lock-free queue
+        // The queue is drained by background threads, which format messages according to the format of each sink and write them out
+        
+        // Determines what happens to a message that is logged while the queue is full
+        enum class OverflowPolicy {
+            Block = 0, // Wait until there is room in the queue
+            DropNewest, // Discard the message being logged
+            OverwriteOldest, // Discard the oldest message in the queue to make room
+        };
+        
+        // 'capacity' is rounded up to the next power of two
+        // Enabling asynchronous mode while it is already enabled restarts it with the new configuration
+        // Messages are written in order only if there is a single background thread
+        // Messages logged concurrently with enabling / disabling asynchronous mode are not lost: a message that could not be enqueued before the queue was stopped (including by a thread blocked on a full queue) is written out synchronously by the logging thread
+        void enable_async(std::size_t capacity = 8192u, OverflowPolicy policy = OverflowPolicy::Block, std::size_t num_workers = 1u);
+        
+        // Writes out all pending messages and stops the background threads, logging is synchronous afterwards
+        void disable_async();
+        
+        // Blocks until all messages logged before the call have been written out, then flushes all sinks
+        void flush();
+        
+        // Returns the number of messages discarded because the queue was full
+        [[nodiscard]] std::size_t get_dropped_message_count();
+        
+        // In deferred mode, messages are not formatted when logged
+        // The format string, source location, timestamp, and arguments of each message are serialized into a compact binary record instead, which is written out as-is by binary sinks (BinaryFileSink)
+        // Records are turned back into text offline by the utils-logdecode tool
+        // Arithmetic types, characters, pointers, and strings are stored as raw bytes, arguments of any other type are formatted (with default format specifiers) when logged and stored as strings
+        // Note: text sinks do not receive messages logged in deferred mode, and records are written out synchronously in asynchronous mode
+        // Note: messages support at most detail::max_deferred_arguments (12) arguments, which is checked at compile time
+        void enable_deferred_formatting();
+        void disable_deferred_formatting();
+        [[nodiscard]] bool deferred_formatting_enabled();
         
         
         // Sinks are inherently thread-safe
@@ -104,6 +336,10 @@ namespace utils {
                 virtual ~Sink();
                 
                 void log(const Message& data);
+                
+                // Writes out the binary record of a message logged in deferred mode, ignored by sinks that do not support binary records
+                void log(const detail::BinaryRecord& record);
+                
                 virtual void flush();
                 
                 void set_format(const std::string& format);
@@ -112,6 +348,8 @@ namespace utils {
                 void set_level(Message::Level level);
                 [[nodiscard]] Message::Level get_level() const;
                 
+                [[nodiscard]] bool is_enabled() const;
+                
                 [[nodiscard]] std::string_view get_name() const;
                 [[nodiscard]] std::string_view get_format() const;
                 
@@ -119,25 +357,86 @@ namespace utils {
                 void disable();
 
             private:
+                friend class Logger;
+                
                 virtual void log(std::string_view message, const Message& data) = 0;
+                virtual void write(const detail::BinaryRecord& record);
+                
+                // Renders 'data' through 'cache', so that sinks with identical layouts format each message only once
+                void log(const Message& data, detail::RenderCache& cache);
+                
+                [[nodiscard]] bool accepts(Message::Level level) const;
                 
                 std::string m_name;
-                Message::Level m_level;
+                
+                // Read by logging threads without holding the lock
+                std::atomic<Message::Level> m_level;
+                
                 std::mutex m_lock;
-                std::string m_format;
-                bool m_enabled;
+                std::unique_ptr<detail::SinkLayout> m_layout;
+                std::atomic<bool> m_enabled;
         };
         
+        // Determines when data written to a FileSink is forced to disk (fdatasync)
+        enum class SyncPolicy {
+            Never = 0, // Left to the operating system
+            OnFlush, // When the sink is flushed
+            Always, // After every block of messages is written out
+        };
+        
+        // Messages are appended to an in-memory buffer, which is written out by a background thread once it fills up or once it has been pending for longer than the flush interval
+        // Writing to the file, rotating it, and syncing it to disk happen on the background thread, the logging thread only blocks if the background thread falls behind
         class FileSink : public Sink {
             public:
+                struct Options {
+                    Options();
+                    
+                    // Only std::ios::trunc is considered, the file is appended to otherwise
+                    std::ios::openmode open_mode;
+                    
+                    std::size_t buffer_size; // Size (in bytes) at which the buffer is handed off to be written out
+                    std::chrono::milliseconds flush_interval; // Maximum amount of time a message is kept in the buffer
+                    
+                    // The file is rotated once it grows beyond 'max_file_size' bytes or once it has been open for longer than 'rotation_interval' (0 disables either)
+                    // Rotated files are renamed to <stem>.<index><extension>, with larger indices for more recent files
+                    std::size_t max_file_size;
+                    std::chrono::seconds rotation_interval;
+                    std::size_t max_rotated_files; // Older rotated files are removed (0 keeps all files)
+                    
+                    // Invoked on the background thread with the path of each rotated file (for example, to compress it)
+                    std::function<void(const std::filesystem::path&)> on_rotate;
+                    
+                    SyncPolicy sync;
+                };
+                
                 FileSink(const std::filesystem::path& filepath, std::ios::openmode open_mode, std::optional<std::string> format = { }, Message::Level level = Message::Level::Info);
+                FileSink(const std::filesystem::path& filepath, Options options, std::optional<std::string> format = { }, Message::Level level = Message::Level::Info);
                 ~FileSink() override;
                 
             private:
                 void log(std::string_view message, const Message& data) override;
                 void flush() override;
                 
+                std::unique_ptr<detail::FileWriter> m_writer;
+        };
+        
+        // Writes binary records of messages logged in deferred mode, messages that are logged normally are ignored
+        // Records are buffered in memory and written out once the buffer fills up, or when the sink is flushed
+        class BinaryFileSink : public Sink {
+            public:
+                explicit BinaryFileSink(const std::filesystem::path& filepath, Message::Level level = Message::Level::Info);
+                ~BinaryFileSink() override;
+                
+            private:
+                void log(std::string_view message, const Message& data) override;
+                void write(const detail::BinaryRecord& record) override;
+                void flush() override;
+                
                 std::ofstream m_file;
+                std::string m_buffer;
+                
+                // Format records that have already been written to the file, indexed by format ID
+                std::vector<bool> m_formats;
         };
         
         void set_default_format(std::string format);
@@ -160,12 +459,63 @@ namespace utils {
         
         void parse(const FormatSpec& spec);
         std::string format(logging::Message::Level level) const;
+        void format_to(logging::Message::Level level, FormatBuffer& out) const;
         
         bool uppercase;
     };
     
 }
 
+// Throttled logging, where LEVEL is one of Debug, Info, Warning, or Error (ex. LOG_EVERY_N(Warning, 1000, "queue is full ({} elements)", size))
+// Each macro invocation declares its own limiter
+
+// Logs the first message, and every Nth message after it
+#define LOG_EVERY_N(LEVEL, N, ...)                                                                                                                     \
+    do {                                                                                                                                               \
+        static utils::logging::EveryN utils_log_limiter { N };                                                                                         \
+        if (utils::logging::detail::is_enabled(utils::logging::Message::Level::LEVEL) && utils_log_limiter.should_log()) {                             \
+            utils::logging::detail::log_at(utils::logging::Message::Level::LEVEL, __VA_ARGS__);                                                        \
+        }                                                                                                                                              \
+    }                                                                                                                                                  \
+    while (false)
+
+// Logs only the first N messages
+#define LOG_FIRST_N(LEVEL, N, ...)                                                                                                                     \
+    do {                                                                                                                                               \
+        static utils::logging::FirstN utils_log_limiter { N };                                                                                         \
+        if (utils::logging::detail::is_enabled(utils::logging::Message::Level::LEVEL) && utils_log_limiter.should_log()) {                             \
+            utils::logging::detail::log_at(utils::logging::Message::Level::LEVEL, __VA_ARGS__);                                                        \
+        }                                                                                                                                              \
+    }                                                                                                                                                  \
+    while (false)
+
+// Logs at most one message per INTERVAL (a std::chrono::duration), the number of rejected messages is logged along with the next message that passes
+#define LOG_EVERY(LEVEL, INTERVAL, ...)                                                                                                                \
+    do {                                                                                                                                               \
+        static utils::logging::RateLimit utils_log_limiter { INTERVAL };                                                                               \
+        if (utils::logging::detail::is_enabled(utils::logging::Message::Level::LEVEL) && utils_log_limiter.should_log()) {                             \
+            if (std::uint64_t utils_log_suppressed = utils_log_limiter.take_suppressed()) {                                                            \
+                utils::logging::detail::log_at(utils::logging::Message::Level::LEVEL, "{} messages were suppressed", utils_log_suppressed);            \
+            }                                                                                                                                          \
+            utils::logging::detail::log_at(utils::logging::Message::Level::LEVEL, __VA_ARGS__);                                                        \
+        }                                                                                                                                              \
+    }                                                                                                                                                  \
+    while (false)
+
+// Suppresses messages that follow the previous message within WINDOW (a std::chrono::duration)
+// Once there is a gap of at least WINDOW between messages, the number of repeats is logged before the next message
+#define LOG_DEDUPLICATED(LEVEL, WINDOW, ...)                                                                                                           \
+    do {                                                                                                                                               \
+        static utils::logging::Deduplicator utils_log_limiter { WINDOW };                                                                              \
+        if (utils::logging::detail::is_enabled(utils::logging::Message::Level::LEVEL) && utils_log_limiter.should_log()) {                             \
+            if (std::uint64_t utils_log_suppressed = utils_log_limiter.take_suppressed()) {                                                            \
+                utils::logging::detail::log_at(utils::logging::Message::Level::LEVEL, "... previous message repeated {} times", utils_log_suppressed); \
+            }                                                                                                                                          \
+            utils::logging::detail::log_at(utils::logging::Message::Level::LEVEL, __VA_ARGS__);                                                        \
+        }                                                                                                                                              \
+    }                                                                                                                                                  \
+    while (false)
+
 // Template definitions.
 #include "utils/detail/logging.tpp"
 
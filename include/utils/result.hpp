@@ -7,6 +7,7 @@
 #include <string> // std::string
 #include <string_view> // std::string_view
 #include <optional> // std::optional
+#include <variant> // std::variant, std::in_place_index_t
 
 namespace utils {
     
@@ -22,14 +23,18 @@ namespace utils {
             static Response<E> NOT_OK(Ts&&... args);
             
             [[nodiscard]] bool ok() const;
-            [[nodiscard]] const E& error() const;
+            
+            [[nodiscard]] const E& error() const&;
+            [[nodiscard]] E&& error() &&;
             
         protected:
             Response();
             
             std::optional<E> m_error;
     };
-
+    
+    // Result holds either a value or an error in a single storage slot (no space is reserved for the alternative that is not held)
+    // Result is trivially copyable (and returned in registers, when small enough) whenever both T and E are
     template <typename T, typename E>
     class Result {
         public:
@@ -41,17 +46,42 @@ namespace utils {
             
             [[nodiscard]] bool ok() const;
             
-            [[nodiscard]] T& result();
-            [[nodiscard]] const E& error() const;
+            // Rvalue overloads allow the value / error to be moved out of temporary results (ex. T value = parse(...).result())
+            [[nodiscard]] T& result() &;
+            [[nodiscard]] const T& result() const&;
+            [[nodiscard]] T&& result() &&;
+            
+            [[nodiscard]] const E& error() const&;
+            [[nodiscard]] E&& error() &&;
+            
+            // Monadic operations, which forward the value / error to 'fn' (moving it out of rvalue results instead of copying it)
+            
+            // Invokes 'fn' with the value, which must return a Result with the same error type, or propagates the error
+            template <typename Fn>
+            auto and_then(Fn&& fn) const&;
+            template <typename Fn>
+            auto and_then(Fn&& fn) &&;
+            
+            // Returns a Result containing the value returned by invoking 'fn' with the value, or propagates the error
+            template <typename Fn>
+            auto transform(Fn&& fn) const&;
+            template <typename Fn>
+            auto transform(Fn&& fn) &&;
+            
+            // Invokes 'fn' with the error, which must return a Result with the same value type, or propagates the value
+            template <typename Fn>
+            auto or_else(Fn&& fn) const&;
+            template <typename Fn>
+            auto or_else(Fn&& fn) &&;
         
         protected:
-            Result();
+            // Constructs the value (index 0) or error (index 1) in place
+            template <std::size_t I, typename ...Ts>
+            explicit Result(std::in_place_index_t<I> index, Ts&&... args);
             
-            std::optional<T> m_result;
-            std::optional<E> m_error;
+            std::variant<T, E> m_storage;
     };
     
-    
     // ParseResponse/ParseResult types are specialized types for returning the result of parsing a string, following the same pattern as the Response/Result counter types
     // Member function offset() returns the number of characters parsed on success or index of failed character on failure
     
@@ -80,12 +110,17 @@ namespace utils {
             template <typename ...Ts>
             static ParseResult<T, E> NOT_OK(std::size_t error_position, Ts&&... args);
 
-            ~ParseResult();
-            
             [[nodiscard]] std::size_t offset() const;
             
+            // Same as Result::transform, but also preserves the offset
+            template <typename Fn>
+            auto transform(Fn&& fn) const&;
+            template <typename Fn>
+            auto transform(Fn&& fn) &&;
+            
         private:
-            ParseResult();
+            template <std::size_t I, typename ...Ts>
+            ParseResult(std::size_t offset, std::in_place_index_t<I> index, Ts&&... args);
             
             std::size_t m_offset;
     };
@@ -5,19 +5,74 @@
 #define STRING_HPP
 
 #include "utils/concepts.hpp"
+#include "utils/result.hpp"
 
-#include <string> // std::string
+#include <string> // std::string, std::pmr::string
 #include <source_location> // std::source_location
 #include <stdexcept> // std::runtime_error
-#include <variant> // std::variant
 #include <optional> // std::optional
 #include <filesystem> // std::filesystem::path
 #include <thread> // std::thread
+#include <array> // std::array
+#include <cstdint> // std::uint8_t, std::uint16_t
+#include <iterator> // std::output_iterator, std::default_sentinel_t
+#include <ranges> // std::ranges::view_interface
+#include <span> // std::span
+#include <bit> // std::bit_ceil
+#include <memory> // std::unique_ptr
+#include <memory_resource> // std::pmr::memory_resource, std::pmr::monotonic_buffer_resource
 
 namespace utils {
     
     // Returns a vector containing the result of splitting 'in' by 'delimiter'.
+    // Every delimiter separates two (possibly empty) components, an empty delimiter does not split the input.
     [[nodiscard]] std::vector<std::string_view> split(std::string_view in, std::string_view delimiter);
+    
+    // Range over the components of 'in' split by 'delimiter', the same components as split(...) are yielded lazily without being stored
+    // Note: components reference the characters of 'in', which must outlive the view
+    class SplitView : public std::ranges::view_interface<SplitView> {
+        public:
+            class Iterator {
+                public:
+                    using value_type = std::string_view;
+                    using difference_type = std::ptrdiff_t;
+                    using iterator_concept = std::forward_iterator_tag;
+                    using iterator_category = std::input_iterator_tag; // Components are returned by value
+                    
+                    Iterator();
+                    Iterator(std::string_view in, std::string_view delimiter);
+                    
+                    std::string_view operator*() const;
+                    
+                    Iterator& operator++();
+                    Iterator operator++(int);
+                    
+                    bool operator==(const Iterator& other) const;
+                    bool operator==(std::default_sentinel_t) const;
+                    
+                private:
+                    std::string_view m_in;
+                    std::string_view m_delimiter;
+                    std::size_t m_position; // Start of the current component, std::string_view::npos once all components have been visited
+                    std::size_t m_end; // End of the current component (position of the next delimiter, or the end of the input)
+            };
+            
+            SplitView();
+            SplitView(std::string_view in, std::string_view delimiter);
+            
+            [[nodiscard]] Iterator begin() const;
+            [[nodiscard]] std::default_sentinel_t end() const;
+            
+        private:
+            std::string_view m_in;
+            std::string_view m_delimiter;
+    };
+    
+    [[nodiscard]] SplitView split_view(std::string_view in, std::string_view delimiter);
+    
+    // Writes the components of 'in' split by 'delimiter' into 'out', returns the number of components written
+    // If there are more components than 'out' can hold, the last element receives the remainder of the input (unsplit)
+    std::size_t split_into(std::string_view in, std::string_view delimiter, std::span<std::string_view> out);
 
     // Trim off all whitespace characters on either side of 'in'.
     [[nodiscard]] std::string_view trim(std::string_view in);
@@ -30,7 +85,7 @@ namespace utils {
     [[nodiscard]] bool operator==(const T& first, const U& second);
 
     // from_string for fundamental types (wrapper around std::from_chars)
-    // Returns the number of characters processed, throws on invalid argument
+    // Returns the number of characters processed, throws on invalid input (including values that are out of range of the target type)
 
     std::size_t from_string(std::string_view in, unsigned char& out);
     std::size_t from_string(std::string_view in, short& out);
@@ -47,6 +102,48 @@ namespace utils {
     std::size_t from_string(std::string_view in, double& out);
     std::size_t from_string(std::string_view in, long double& out);
     
+    enum class ParseError : std::uint8_t {
+        Empty = 0, // Input does not contain any non-whitespace characters
+        InvalidArgument, // Input does not start with a valid number
+        OutOfRange, // Value cannot be represented by the target type
+    };
+    
+    // Non-throwing variants of from_string, available for the same fundamental types (ex. from_string<int>("42"))
+    // On success, offset() returns the number of characters processed (including leading whitespace, signs, and base prefixes)
+    // On failure, offset() returns the position of the first character that could not be parsed
+    template <typename T>
+    [[nodiscard]] ParseResult<T, ParseError> from_string(std::string_view in);
+    
+    struct BulkParseResult {
+        std::size_t count; // Number of fields processed, each of which was written to the corresponding element of the output
+        std::size_t num_errors; // Number of fields that could not be parsed, which are set to T { }
+        std::size_t first_error; // Index of the first field that could not be parsed, equal to 'count' if all fields were parsed successfully
+    };
+    
+    // Parses each element of 'in' into the corresponding element of 'out', stopping once either is exhausted
+    // Unlike from_string(in), fields must consist of exactly one number (surrounded by optional whitespace)
+    // Decimal integers are parsed eight digits at a time, with a fallback to the general implementation for other representations
+    template <typename T>
+    BulkParseResult from_string(std::span<const std::string_view> in, std::span<T> out);
+    
+    // Parses consecutive 'delimiter'-separated fields of 'buffer' into 'out', stopping once either is exhausted
+    // A trailing delimiter at the end of 'buffer' does not start a new field
+    template <typename T>
+    BulkParseResult parse_column(std::string_view buffer, char delimiter, std::span<T> out);
+    
+    class FormatSpec;
+    
+    namespace detail {
+        struct FormatSpecifier;
+        
+        std::size_t parse_format_spec(std::string_view in, FormatSpec& out, bool nested);
+        
+        // Fills 'out' with specifiers that were split out of format string 'format' at compile time
+        inline void load_format_spec(std::string_view format, std::span<const FormatSpecifier> specifiers, FormatSpec& out);
+    }
+    
+    // Specifier names and values reference the characters of the format string the spec was parsed from, which must outlive it
+    // Only values that require unescaping, nested formatting groups, and specifiers beyond the first few are allocated from the arena of the spec
     class FormatSpec {
         public:
             enum class Type {
@@ -60,10 +157,18 @@ namespace utils {
                 std::string_view value;
             };
             
+            // The arena of the spec is allocated on first use
             FormatSpec();
+            
+            // Allocates from 'resource' instead of an arena owned by the spec, which allows callers to provide (stack) storage up front
+            // Note: 'resource' must outlive the spec
+            explicit FormatSpec(std::pmr::memory_resource* resource);
+            
+            // Copies are deep and own all of their specifiers
             FormatSpec(const FormatSpec& other);
             FormatSpec(FormatSpec&& other) noexcept;
             FormatSpec& operator=(const FormatSpec& other);
+            FormatSpec& operator=(FormatSpec&& other) noexcept;
             ~FormatSpec();
             
             Type type() const;
@@ -75,13 +180,11 @@ namespace utils {
             
             // Methods for specifier lists
             
-            void set_specifier(std::string_view name, std::string value);
+            // 'name' and 'value' are copied into the arena of the spec
+            void set_specifier(std::string_view name, std::string_view value);
             
-            std::string& operator[](std::string_view name);
             std::string_view operator[](std::string_view name) const;
 
-            std::string& get_specifier(std::string_view name);
-            
             template <typename ...Ts>
             SpecifierView get_specifier(std::string_view first, std::string_view second, Ts... rest) const;
             std::string_view get_specifier(std::string_view name) const;
@@ -101,30 +204,42 @@ namespace utils {
             bool has_group(std::size_t index) const;
             
         private:
-            struct Specifier {
-                Specifier(std::string name, std::string value = "");
-                ~Specifier();
-
-                Specifier& operator=(std::string other);
-                
-                [[nodiscard]] bool operator==(const Specifier& other) const;
-                [[nodiscard]] bool operator!=(const Specifier& other) const;
-                
-                std::string name;
-                std::string value;
-            };
+            friend std::size_t detail::parse_format_spec(std::string_view in, FormatSpec& out, bool nested);
+            friend void detail::load_format_spec(std::string_view format, std::span<const detail::FormatSpecifier> specifiers, FormatSpec& out);
+            
+            // Number of specifiers that are stored in line, a spec for any of the builtin formatters does not use more than this
+            static constexpr std::size_t inline_capacity = 8u;
             
-            using SpecifierList = std::vector<Specifier>;
-            using FormattingGroupList = std::vector<FormatSpec*>;
+            std::pmr::memory_resource* arena();
             
-            // Conversion from specifier list to formatting group list
-            explicit FormatSpec(SpecifierList&& specifiers);
+            // Returns the specifier with the given name (case-insensitive), or nullptr if the spec does not contain it
+            const SpecifierView* find(std::string_view name) const;
             
-            // A spec can either be a mapping of key - value pairs (specifier name / value) or a nested specification group
-            // Specifiers are stored in a std::vector instead of std::unordered map as the number of formatting specifiers is expected to be relatively small
-            // The spec starts out as std::monostate to avoid unnecessary allocations
-            std::variant<std::monostate, SpecifierList, FormattingGroupList> m_spec;
+            // Appends a specifier that references external characters, without checking for duplicates
+            void append_specifier(std::string_view name, std::string_view value);
+            
+            // Returns a view of 'value' copied into the arena
+            std::string_view copy(std::string_view value);
+            
+            // Grows the list of formatting groups to hold 'capacity' groups
+            void reserve_groups(std::size_t capacity);
+            
+            // Resets the spec to an empty specifier list, memory already allocated from the arena is not reclaimed
+            void clear();
+            
+            std::unique_ptr<std::pmr::monotonic_buffer_resource> m_arena; // Only allocated for specs that are not provided a memory resource
+            std::pmr::memory_resource* m_resource;
+            
+            // A spec can either be a mapping of key - value pairs (specifier name / value) or a list of nested specification groups
+            // Specifiers start out in line (in 'm_inline') and spill into the arena
+            // Formatting groups are always allocated from the arena, groups that were not specified are null
+            SpecifierView* m_specifiers;
+            FormatSpec** m_groups;
+            std::size_t m_size;
+            std::size_t m_capacity;
             Type m_type;
+            
+            SpecifierView m_inline[inline_capacity];
     };
     
     template <typename T>
@@ -146,21 +261,338 @@ namespace utils {
     struct is_named_argument<NamedArgument<T>> : std::true_type {
     };
 
+    // Output sink for formatted text
+    // Formatters write directly into the storage of the buffer, which is extended (or flushed) on demand by the underlying buffer implementation
+    class FormatBuffer {
+        public:
+            FormatBuffer(const FormatBuffer& other) = delete;
+            FormatBuffer& operator=(const FormatBuffer& other) = delete;
+            
+            void push_back(char c);
+            void append(const char* value, std::size_t length);
+            void append(std::string_view value);
+            
+            // Appends 'count' copies of character 'c'
+            void append(std::size_t count, char c);
+            
+            // Returns storage for 'length' characters at the end of the buffer, which the caller must fill in
+            // Returns nullptr if the buffer is not able to provide contiguous storage for 'length' characters, in which case nothing is written
+            [[nodiscard]] char* extend(std::size_t length);
+            
+            // Ensures the buffer can hold at least 'capacity' characters without growing
+            // Note: buffers that flush their contents (instead of extending their storage) may treat this as a hint
+            void reserve(std::size_t capacity);
+            
+            // Returns the number of characters in the current storage of the buffer
+            [[nodiscard]] std::size_t size() const;
+            [[nodiscard]] std::size_t capacity() const;
+            [[nodiscard]] char* data();
+            
+        protected:
+            FormatBuffer(char* data, std::size_t size, std::size_t capacity);
+            virtual ~FormatBuffer();
+            
+            // Called when the buffer does not have enough room to hold 'capacity' characters
+            // Implementations must either extend the storage of the buffer or flush its contents, leaving room for at least one more character
+            virtual void grow(std::size_t capacity) = 0;
+            
+            char* m_data;
+            std::size_t m_size;
+            std::size_t m_capacity;
+    };
+    
+    namespace detail {
+        
+        // Appends characters to the end of a string, which is resized to the number of characters written when the buffer is destroyed
+        // 'String' is a std::basic_string<char> with any allocator (std::string, std::pmr::string)
+        template <typename String>
+        class StringBuffer final : public FormatBuffer {
+            public:
+                explicit StringBuffer(String& out);
+                ~StringBuffer() override;
+                
+            private:
+                void grow(std::size_t capacity) override;
+                
+                String& m_string;
+                std::size_t m_offset; // Length of the string before any characters were appended
+        };
+        
+        // Writes at most 'capacity' characters to a fixed (caller-owned) region of memory, characters past the end are discarded but still counted
+        class FixedBuffer final : public FormatBuffer {
+            public:
+                FixedBuffer(char* out, std::size_t capacity);
+                ~FixedBuffer() override;
+                
+                // Returns the total number of characters written to the buffer (including discarded characters)
+                [[nodiscard]] std::size_t count() const;
+                
+                // Returns the number of characters written to the caller-owned region of memory
+                [[nodiscard]] std::size_t written() const;
+                
+            private:
+                void grow(std::size_t capacity) override;
+                
+                char* m_out;
+                std::size_t m_limit;
+                std::size_t m_count; // Number of characters flushed from the buffer
+                char m_scratch[64]; // Storage for discarded characters
+        };
+        
+        // Writes characters through an output iterator, flushing them in chunks
+        template <typename OutputIt>
+        class IteratorBuffer final : public FormatBuffer {
+            public:
+                explicit IteratorBuffer(OutputIt out);
+                ~IteratorBuffer() override;
+                
+                // Flushes any remaining characters and returns an iterator past the last character written
+                OutputIt out();
+                
+            private:
+                void grow(std::size_t capacity) override;
+                
+                OutputIt m_out;
+                char m_storage[256];
+        };
+        
+    }
+    
+    namespace detail {
+
+        struct Identifier {
+            constexpr Identifier();
+            constexpr Identifier(std::size_t position);
+            constexpr Identifier(std::string_view name);
+            constexpr ~Identifier() = default;
+
+            bool operator==(const Identifier& other) const;
+
+            enum class Type {
+                Auto = 0,
+                Position,
+                Name,
+            } type;
+
+            // This layout has the same size as std::variant<std::size_t, std::string>
+            // Prefer this way so that accessing the underlying identifier is easier
+            std::size_t position;
+            std::string_view name;
+        };
+        
+        // Compact representation of a format string segment, built for format strings that are parsed at compile time
+        // Offsets are relative to the start of the format string
+        struct FormatSegment {
+            enum class Type : std::uint8_t {
+                Literal = 0,
+                Indexed, // Auto-numbered / positional placeholder, references the argument at index 'argument'
+                Named // Named placeholder, references the argument with the name that follows the placeholder opening brace
+            } type;
+            
+            std::uint8_t name_length;
+            std::uint16_t argument;
+            std::uint16_t position; // Position of the placeholder opening brace in the format string, used for error messages
+            std::uint16_t offset; // Literal: start of the literal, placeholder: start of the format spec
+            std::uint16_t length; // Literal: length of the literal, placeholder: length of the format spec (0 for placeholders without one)
+            
+            // Placeholder: range of the specifiers of the format spec in the specifier table
+            // Only format specs that consist of a single specifier list are split into specifiers at compile time, specs with formatting groups, nested specs, or values that require unescaping are parsed when formatted (0 specifiers)
+            std::uint8_t first_specifier;
+            std::uint8_t num_specifiers;
+        };
+        
+        // Name and value of a format specifier, split out of a format spec at compile time
+        // Offsets are relative to the start of the format string
+        struct FormatSpecifier {
+            std::uint16_t name_offset;
+            std::uint16_t value_offset;
+            std::uint16_t value_length;
+            std::uint8_t name_length;
+        };
+        
+        struct FormatSegmentTable {
+            // Format strings that require more segments than this are parsed again when formatted
+            static constexpr std::size_t capacity = 32u;
+            
+            std::array<FormatSegment, capacity> segments;
+            std::uint8_t size = 0u;
+            
+            // Format specs whose specifiers do not fit are parsed when formatted
+            std::array<FormatSpecifier, capacity> specifiers;
+            std::uint8_t num_specifiers = 0u;
+            
+            std::uint16_t length = 0u; // Total length of all literal segments, used to reserve space for the result
+            
+            // Set only if the format string was parsed at compile time and fits in the table
+            bool valid = false;
+            bool auto_numbered = false;
+        };
+
+        // Maps the names of NamedArgument arguments to their position in the argument list
+        // Built once per call to format(...), named placeholders are resolved with a single hash table lookup instead of comparing against every argument name
+        template <std::size_t N>
+        class NamedArgumentIndex {
+            public:
+                static constexpr std::size_t npos = static_cast<std::size_t>(-1);
+
+                template <typename Tuple>
+                explicit NamedArgumentIndex(const Tuple& tuple);
+                ~NamedArgumentIndex() = default;
+
+                // Returns the position of the argument with the given name, or npos if no such argument exists
+                [[nodiscard]] std::size_t find(std::string_view name) const;
+
+                // Throws an exception if two arguments share the same name
+                void validate() const;
+
+            private:
+                // Open addressing with linear probing, the table is kept at most half full
+                static constexpr std::size_t capacity = std::bit_ceil(2u * N);
+
+                struct Entry {
+                    std::string_view name;
+                    std::size_t argument = npos; // npos for empty slots
+                };
+
+                [[nodiscard]] static std::size_t hash(std::string_view name);
+
+                std::array<Entry, capacity> m_entries;
+
+                // Tracks the first pair of arguments that share the same name (npos if all names are unique)
+                std::size_t m_first; // Slot of the first occurrence
+                std::size_t m_duplicate; // Position of the duplicate argument
+        };
+
+        // Returns the number of NamedArgument types in Ts
+        template <typename ...Ts>
+        inline constexpr std::size_t num_named_arguments = (std::size_t(is_named_argument<Ts>::value) + ... + 0u);
+
+    }
+
+    template <typename ...Ts>
     struct FormatString {
+        // String literals are parsed and validated against the types of the format arguments at compile time
+        // Errors (unterminated / unescaped braces, placeholders of mixed types, missing arguments, etc.) are reported as compilation errors
         // Purposefully not marked as explicit
+        consteval FormatString(const char* format, std::source_location source = std::source_location::current());
+        
+        // Format strings that are not known at compile time are parsed and validated when formatted
         FormatString(const std::string& format, std::source_location source = std::source_location::current());
         FormatString(std::string_view format, std::source_location source = std::source_location::current());
-        FormatString(const char* format, std::source_location source = std::source_location::current());
-        ~FormatString();
+        
+        constexpr ~FormatString() = default;
         
         std::string_view format;
         std::source_location source;
+        detail::FormatSegmentTable table;
     };
     
+    // A format string that has been parsed ahead of time into literal segments and placeholders
+    // Formatting with a CompiledFormat only performs argument substitution, which avoids re-parsing format strings that are used repeatedly
+    // Note: the compiled format references the characters of the original format string, which must outlive it
+    class CompiledFormat {
+        public:
+            // Throws an exception if the format string is invalid
+            explicit CompiledFormat(std::string_view format, std::source_location source = std::source_location::current());
+            ~CompiledFormat();
+
+            [[nodiscard]] std::string_view format() const;
+            [[nodiscard]] std::source_location source() const;
+
+            // Returns the number of placeholders in the format string
+            [[nodiscard]] std::size_t size() const;
+            [[nodiscard]] bool empty() const;
+
+        private:
+            template <typename ...Ts>
+            friend void format_to(FormatBuffer& out, const CompiledFormat& fmt, const Ts&... args);
+
+            struct Placeholder {
+                detail::Identifier identifier;
+                FormatSpec spec;
+                std::size_t position; // Position of the placeholder opening brace in the format string, used for error messages
+            };
+
+            struct Segment {
+                enum class Type {
+                    Literal = 0,
+                    Placeholder
+                } type;
+
+                std::string_view literal;
+                std::size_t placeholder; // Index into the placeholder list
+            };
+
+            std::string_view m_format;
+            std::source_location m_source;
+
+            std::vector<Segment> m_segments;
+            std::vector<Placeholder> m_placeholders;
+
+            // All placeholders in a format string have the same type (auto-numbered or positional / named)
+            detail::Identifier::Type m_type;
+
+            // Total length of all literal segments, used to reserve space for the result
+            std::size_t m_length;
+    };
+
+    [[nodiscard]] CompiledFormat compile_format(std::string_view format, std::source_location source = std::source_location::current());
+
     // Function throws exception if a placeholder does not have an argument specified
+    // std::type_identity_t excludes the format string from template argument deduction, argument types are deduced from 'args'
+    template <typename ...Ts>
+    std::string format(FormatString<std::type_identity_t<Ts>...> str, const Ts&... args);
+
+    // Only performs argument substitution, the format string has already been validated when the CompiledFormat was constructed
+    template <typename ...Ts>
+    std::string format(const CompiledFormat& fmt, const Ts&... args);
+    
+    // Allocates the result (and any intermediate storage) from 'resource' instead of the global heap
+    template <typename ...Ts>
+    std::pmr::string format(std::pmr::memory_resource* resource, FormatString<std::type_identity_t<Ts>...> str, const Ts&... args);
+    
+    template <typename ...Ts>
+    std::pmr::string format(std::pmr::memory_resource* resource, const CompiledFormat& fmt, const Ts&... args);
+    
+    // Writes the result into 'out'
+    template <typename ...Ts>
+    void format_to(FormatBuffer& out, FormatString<std::type_identity_t<Ts>...> str, const Ts&... args);
+    
+    template <typename ...Ts>
+    void format_to(FormatBuffer& out, const CompiledFormat& fmt, const Ts&... args);
+    
+    // Appends the result to the end of 'out', reusing its capacity
+    template <typename ...Ts>
+    void format_to(std::string& out, FormatString<std::type_identity_t<Ts>...> str, const Ts&... args);
+    
+    template <typename ...Ts>
+    void format_to(std::string& out, const CompiledFormat& fmt, const Ts&... args);
+    
+    // Appends the result to the end of 'out', additional storage is allocated from the memory resource of 'out'
     template <typename ...Ts>
-    std::string format(const FormatString& str, const Ts&... args);
+    void format_to(std::pmr::string& out, FormatString<std::type_identity_t<Ts>...> str, const Ts&... args);
     
+    template <typename ...Ts>
+    void format_to(std::pmr::string& out, const CompiledFormat& fmt, const Ts&... args);
+    
+    // Writes the result through output iterator 'out', returns an iterator past the last character written
+    template <std::output_iterator<char> OutputIt, typename ...Ts>
+    OutputIt format_to(OutputIt out, FormatString<std::type_identity_t<Ts>...> str, const Ts&... args);
+    
+    struct FormatToResult {
+        char* out; // Pointer past the last character written
+        std::size_t size; // Length of the (untruncated) result
+    };
+    
+    // Writes at most 'n' characters of the result to 'out'
+    // Note: the result is not null-terminated
+    template <typename ...Ts>
+    FormatToResult format_to_n(char* out, std::size_t n, FormatString<std::type_identity_t<Ts>...> str, const Ts&... args);
+    
+    // Returns the length of the result, without storing it
+    template <typename ...Ts>
+    [[nodiscard]] std::size_t formatted_size(FormatString<std::type_identity_t<Ts>...> str, const Ts&... args);
+
     // Section: Formatters
     
     struct FormatterBase {
@@ -172,6 +604,7 @@ namespace utils {
         // Applies justification and color
         std::string format(const char* value, std::size_t length) const;
         std::string format(const std::string& value) const;
+        void format_to(const char* value, std::size_t length, FormatBuffer& out) const;
         
         enum class Justification {
             Left = 0,
@@ -197,6 +630,7 @@ namespace utils {
             
             void parse(const FormatSpec& spec);
             std::string format(T value) const;
+            void format_to(T value, FormatBuffer& out) const;
             
             enum class Representation {
                 Decimal = 0,
@@ -228,9 +662,9 @@ namespace utils {
             std::optional<std::uint8_t> digits;
             
         private:
-            inline std::string to_binary(T value) const;
-            inline std::string to_decimal(T value) const;
-            inline std::string to_hexadecimal(T value) const;
+            inline void to_binary(T value, FormatBuffer& out) const;
+            inline void to_decimal(T value, FormatBuffer& out) const;
+            inline void to_hexadecimal(T value, FormatBuffer& out) const;
     };
     
     // char
@@ -241,36 +675,37 @@ namespace utils {
         
         void parse(const FormatSpec& spec);
         std::string format(char c) const;
+        void format_to(char c, FormatBuffer& out) const;
     };
     
     // signed char
     template <>
-    struct Formatter<std::int8_t> : public IntegerFormatter<std::int8_t> {
+    struct Formatter<signed char> : public IntegerFormatter<signed char> {
     };
     
     // unsigned char
     template <>
-    struct Formatter<std::uint8_t> : public IntegerFormatter<std::uint8_t> {
+    struct Formatter<unsigned char> : public IntegerFormatter<unsigned char> {
     };
     
     // short
     template <>
-    struct Formatter<std::int16_t> : public IntegerFormatter<std::int16_t> {
+    struct Formatter<short> : public IntegerFormatter<short> {
     };
     
     // unsigned short
     template <>
-    struct Formatter<std::uint16_t> : public IntegerFormatter<std::uint16_t> {
+    struct Formatter<unsigned short> : public IntegerFormatter<unsigned short> {
     };
     
     // int
     template <>
-    struct Formatter<std::int32_t> : public IntegerFormatter<std::int32_t> {
+    struct Formatter<int> : public IntegerFormatter<int> {
     };
     
     // unsigned int
     template <>
-    struct Formatter<std::uint32_t> : public IntegerFormatter<std::uint32_t> {
+    struct Formatter<unsigned> : public IntegerFormatter<unsigned> {
     };
     
     // long
@@ -285,12 +720,12 @@ namespace utils {
     
     // long long
     template <>
-    struct Formatter<std::int64_t> : public IntegerFormatter<std::int64_t> {
+    struct Formatter<long long> : public IntegerFormatter<long long> {
     };
     
     // unsigned long long
     template <>
-    struct Formatter<std::uint64_t> : public IntegerFormatter<std::uint64_t> {
+    struct Formatter<unsigned long long> : public IntegerFormatter<unsigned long long> {
     };
     
     // Floating point types
@@ -302,10 +737,18 @@ namespace utils {
         
         void parse(const FormatSpec& spec);
         std::string format(T value) const;
+        void format_to(T value, FormatBuffer& out) const;
         
         enum class Representation {
             Fixed = 0,
-            Scientific
+            Scientific,
+            
+            // Shortest representation that round-trips (as fixed or scientific notation, whichever is shorter)
+            // 'precision' is not applicable to shortest representations
+            Shortest,
+            
+            // Shortest representation that round-trips, switching to scientific notation for very large / small exponents (similar to printf %g)
+            General
         } representation;
         
         enum class Sign {
@@ -315,6 +758,9 @@ namespace utils {
         } sign;
         std::uint8_t precision;
         bool use_separator_character;
+        
+        private:
+            inline void to_shortest(T value, FormatBuffer& out) const;
     };
     
     // float
@@ -343,21 +789,31 @@ namespace utils {
             
             void parse(const FormatSpec& spec);
             std::string format(const char* value) const;
+            void format_to(const char* value, FormatBuffer& out) const;
             
         protected:
-            inline std::string format(const char* value, std::size_t length) const;
+            std::string format(const char* value, std::size_t length) const;
     };
     
     // std::string_view
     template <>
     struct Formatter<std::string_view> : public Formatter<const char*> {
         std::string format(std::string_view value) const;
+        void format_to(std::string_view value, FormatBuffer& out) const;
     };
     
     // std::string
     template <>
     struct Formatter<std::string> : public Formatter<const char*> {
         std::string format(const std::string& value) const;
+        void format_to(const std::string& value, FormatBuffer& out) const;
+    };
+    
+    // std::pmr::string
+    template <>
+    struct Formatter<std::pmr::string> : public Formatter<const char*> {
+        std::string format(const std::pmr::string& value) const;
+        void format_to(const std::pmr::string& value, FormatBuffer& out) const;
     };
     
     // Pointer types
@@ -370,6 +826,7 @@ namespace utils {
         
         void parse(const FormatSpec& spec);
         std::string format(void* value) const;
+        void format_to(void* value, FormatBuffer& out) const;
     };
     
     // T*
@@ -394,9 +851,13 @@ namespace utils {
             // Format: { first, second }
             void parse(const FormatSpec& spec);
             std::string format(const std::pair<T, U>& value) const;
+            void format_to(const std::pair<T, U>& value, FormatBuffer& out) const;
             
         private:
-            std::pair<Formatter<T>, Formatter<U>> m_formatters;
+            void write(const std::pair<T, U>& value, FormatBuffer& out) const;
+            
+            // Elements of associative containers are pairs with a const-qualified key
+            std::pair<Formatter<std::remove_cv_t<T>>, Formatter<std::remove_cv_t<U>>> m_formatters;
     };
     
     // std::tuple
@@ -409,8 +870,11 @@ namespace utils {
             // Format: { first, second, ... }
             void parse(const FormatSpec& spec);
             std::string format(const std::tuple<Ts...>& value) const;
+            void format_to(const std::tuple<Ts...>& value, FormatBuffer& out) const;
             
         private:
+            void write(const std::tuple<Ts...>& value, FormatBuffer& out) const;
+            
             std::tuple<Formatter<Ts>...> m_formatters;
     };
     
@@ -424,6 +888,7 @@ namespace utils {
             // Format: file:line
             void parse(const FormatSpec& spec);
             std::string format(const std::source_location& value) const;
+            void format_to(const std::source_location& value, FormatBuffer& out) const;
             
         private:
             std::string_view m_format;
@@ -433,34 +898,56 @@ namespace utils {
     template <>
     struct Formatter<std::filesystem::path> : public Formatter<std::string> {
         std::string format(const std::filesystem::path& value) const;
+        void format_to(const std::filesystem::path& value, FormatBuffer& out) const;
     };
     
     // std::thread::id
     template <>
     struct Formatter<std::thread::id> : public Formatter<std::size_t> {
         std::string format(const std::thread::id& value) const;
+        void format_to(const std::thread::id& value, FormatBuffer& out) const;
     };
     
     // Standard containers
     
-    // std::vector
-    template <typename T>
-    class Formatter<std::vector<T>> : public FormatterBase {
+    // Specifiers shared by all container types
+    struct ContainerFormatterBase : public FormatterBase {
+        ContainerFormatterBase();
+        ~ContainerFormatterBase();
+        
+        void parse(const FormatSpec& spec);
+        
+        // Specifies the maximum number of elements to format, remaining elements are replaced by 'truncation_marker'
+        // Elements past the limit are never visited, so the cost of formatting a large container is proportional to the number of elements printed
+        std::optional<std::size_t> max_elements;
+        std::string truncation_marker;
+    };
+    
+    // Generic containers (std::vector, std::span, std::list, std::map, user-defined types, ...)
+    template <Container C>
+    class Formatter<C> : public ContainerFormatterBase {
         public:
+            using T = std::remove_cvref_t<decltype(*std::begin(std::declval<const C&>()))>;
+            
             Formatter();
             ~Formatter();
             
             // Format: [ 1, 2, 3, ... ]
+            // Elements are formatted with the second formatting group ({::representation=[hexadecimal]}), specifiers of the first group apply to the container
+            // For containers of floating point values, floating point specifiers (representation, sign, precision, use_separator) in the first group are also forwarded to the elements
             void parse(const FormatSpec& spec);
-            std::string format(const std::vector<T>& value) const;
+            std::string format(const C& value) const;
+            void format_to(const C& value, FormatBuffer& out) const;
             
         private:
+            void write(const C& value, FormatBuffer& out) const;
+            
             Formatter<T> m_formatter;
     };
     
     // std::unordered_map
     template <typename K, typename V, typename H, typename P, typename A>
-    class Formatter<std::unordered_map<K, V, H, P, A>> : public FormatterBase {
+    class Formatter<std::unordered_map<K, V, H, P, A>> : public ContainerFormatterBase {
         public:
             using T = std::unordered_map<K, V, H, P, A>;
             
@@ -470,22 +957,33 @@ namespace utils {
             // Format: { { key: value }, ... }
             void parse(const FormatSpec& spec);
             std::string format(const T& value) const;
+            void format_to(const T& value, FormatBuffer& out) const;
             
         private:
+            void write(const T& value, FormatBuffer& out) const;
+            
             Formatter<K> m_key_formatter;
             Formatter<V> m_value_formatter;
     };
     
+    // std::unordered_set
     template <typename K, typename H, typename E, typename A>
-    struct Formatter<std::unordered_set<K, H, E, A>> : public Formatter<K> {
-        using T = std::unordered_set<K, H, E, A>;
-        
-        Formatter();
-        ~Formatter();
-        
-        // Format: { value, ... }
-        void parse(const FormatSpec& spec);
-        std::string format(const T& value) const;
+    class Formatter<std::unordered_set<K, H, E, A>> : public ContainerFormatterBase {
+        public:
+            using T = std::unordered_set<K, H, E, A>;
+            
+            Formatter();
+            ~Formatter();
+            
+            // Format: { value, ... }
+            void parse(const FormatSpec& spec);
+            std::string format(const T& value) const;
+            void format_to(const T& value, FormatBuffer& out) const;
+            
+        private:
+            void write(const T& value, FormatBuffer& out) const;
+            
+            Formatter<K> m_formatter;
     };
     
     // Custom / user-defined types
@@ -493,6 +991,7 @@ namespace utils {
     template <typename T>
     struct Formatter<NamedArgument<T>> : public Formatter<T> {
         std::string format(const NamedArgument<T>& value);
+        void format_to(const NamedArgument<T>& value, FormatBuffer& out) const;
     };
     
 }
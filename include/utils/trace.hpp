@@ -0,0 +1,106 @@
+
+#pragma once
+
+#ifndef TRACE_HPP
+#define TRACE_HPP
+
+#include <string_view> // std::string_view
+#include <source_location> // std::source_location
+#include <filesystem> // std::filesystem::path
+#include <chrono> // std::chrono::milliseconds, std::chrono::nanoseconds
+#include <atomic> // std::atomic
+#include <cstdint> // std::uint8_t, std::uint64_t
+
+namespace utils {
+    namespace trace {
+        
+        // Spans are recorded into per-thread lock-free ring buffers, which are drained by a background exporter
+        // Recording a span reads the timestamp counter twice and writes a single fixed-size event, names are never copied
+        // Spans that are recorded while a thread's ring buffer is full are dropped (and counted)
+        
+        enum class Format : std::uint8_t {
+            // Chrome Trace Event format (JSON), which can be loaded by chrome://tracing and Perfetto (ui.perfetto.dev)
+            Json = 0,
+            
+            // Layout of binary trace files (all values are stored in native byte order):
+            //   header: magic ("UTILSTRC"), u32 version, u32 process ID
+            //   events: u32 thread index, i64 begin timestamp (nanoseconds since tracing was started), i64 duration (nanoseconds),
+            //           u32 line, string name, string filename
+            // Strings are stored as a u16 length followed by characters (no null terminator)
+            Binary
+        };
+        
+        struct Options {
+            Format format = Format::Json;
+            std::chrono::milliseconds export_interval { 100 }; // How often the exporter drains the ring buffers of all threads
+            std::size_t buffer_capacity = 16384u; // Capacity of the ring buffer of each thread that records its first span from now on (number of spans), rounded up to the next power of two
+        };
+        
+        // Starts recording spans and writing them to 'filepath' (restarts tracing if it is already running)
+        // Throws if the file cannot be opened
+        void start(const std::filesystem::path& filepath, Options options = { });
+        
+        // Stops recording spans, writes out all recorded spans, and closes the file
+        void stop();
+        
+        [[nodiscard]] bool is_enabled();
+        
+        // Returns the number of spans dropped because a thread's ring buffer was full, since tracing was last started
+        [[nodiscard]] std::size_t get_dropped_span_count();
+        
+        namespace detail {
+            
+            // Reads the timestamp counter (rdtsc on x86, std::chrono::steady_clock elsewhere)
+            [[nodiscard]] std::uint64_t read_ticks();
+            
+            // Writes a span into the ring buffer of the calling thread
+            void record(std::string_view name, const std::source_location& source, std::uint64_t begin, std::uint64_t end);
+        
+        }
+        
+        // Records the time between construction and destruction as a span, and pushes a logging scope for its lifetime
+        // The name must refer to static storage (such as a string literal), defaults to the name of the enclosing function
+        // Does not allocate, and only reads the timestamp counter while tracing is enabled
+        class ScopedSpan {
+            public:
+                explicit ScopedSpan(std::string_view name = { }, std::source_location source = std::source_location::current());
+                ~ScopedSpan();
+                
+                ScopedSpan(const ScopedSpan& other) = delete;
+                ScopedSpan& operator=(const ScopedSpan& other) = delete;
+            
+            private:
+                std::string_view m_name;
+                std::source_location m_source;
+                std::uint64_t m_begin;
+                bool m_recording;
+        };
+        
+        // Measures the time between construction and destruction
+        // The elapsed time is either written to 'elapsed', or logged at the debug level
+        class ScopedTimer {
+            public:
+                explicit ScopedTimer(std::string_view name = { }, std::source_location source = std::source_location::current());
+                explicit ScopedTimer(std::chrono::nanoseconds& elapsed);
+                ~ScopedTimer();
+                
+                ScopedTimer(const ScopedTimer& other) = delete;
+                ScopedTimer& operator=(const ScopedTimer& other) = delete;
+                
+                // Returns the time elapsed since construction
+                [[nodiscard]] std::chrono::nanoseconds elapsed() const;
+            
+            private:
+                std::string_view m_name;
+                std::source_location m_source;
+                std::chrono::nanoseconds* m_elapsed;
+                std::chrono::steady_clock::time_point m_begin;
+        };
+    
+    }
+}
+
+// Template definitions
+#include "utils/detail/trace.tpp"
+
+#endif // TRACE_HPP
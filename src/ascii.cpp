@@ -0,0 +1,218 @@
+#include "utils/ascii.hpp"
+
+#include <cstring> // std::memcpy
+#include <bit> // std::countr_zero, std::countl_zero
+
+#if defined(__x86_64__) || defined(_M_X64)
+    // SSE2 is part of the x86-64 baseline
+    #define UTILS_SIMD_SSE2 1
+    #include <emmintrin.h>
+#elif defined(__aarch64__) || defined(_M_ARM64)
+    // NEON is part of the AArch64 baseline
+    #define UTILS_SIMD_NEON 1
+    #include <arm_neon.h>
+#endif
+
+namespace utils::ascii {
+
+    namespace detail {
+
+        // Blocks of 16 characters are processed with SIMD instructions, the remaining characters are processed 8 at a time (SWAR) and then individually
+        // Strings handled by these functions are typically short, so wider vectors (AVX2) are not worth the overhead of runtime dispatch
+
+        #if defined(UTILS_SIMD_SSE2)
+            // Returns 0xFF for each character in the range ['A', 'Z'], 0x00 otherwise (characters >= 0x80 are negative, and therefore outside the range)
+            inline __m128i uppercase_mask(__m128i block) {
+                return _mm_and_si128(_mm_cmpgt_epi8(block, _mm_set1_epi8('A' - 1)), _mm_cmplt_epi8(block, _mm_set1_epi8('Z' + 1)));
+            }
+
+            inline __m128i lowercase_mask(__m128i block) {
+                return _mm_and_si128(_mm_cmpgt_epi8(block, _mm_set1_epi8('a' - 1)), _mm_cmplt_epi8(block, _mm_set1_epi8('z' + 1)));
+            }
+
+            inline __m128i fold_lower(__m128i block) {
+                return _mm_or_si128(block, _mm_and_si128(uppercase_mask(block), _mm_set1_epi8(0x20)));
+            }
+
+            // Returns a bitmask with one bit set for each whitespace character of the block
+            inline unsigned whitespace_mask(__m128i block) {
+                // Characters in the range ['\t', '\r'] are at most 4 after subtracting '\t' (with unsigned wraparound)
+                __m128i control = _mm_cmpeq_epi8(_mm_subs_epu8(_mm_sub_epi8(block, _mm_set1_epi8('\t')), _mm_set1_epi8(4)), _mm_setzero_si128());
+                __m128i space = _mm_cmpeq_epi8(block, _mm_set1_epi8(' '));
+                return static_cast<unsigned>(_mm_movemask_epi8(_mm_or_si128(control, space)));
+            }
+        #elif defined(UTILS_SIMD_NEON)
+            inline uint8x16_t uppercase_mask(uint8x16_t block) {
+                return vandq_u8(vcgeq_u8(block, vdupq_n_u8('A')), vcleq_u8(block, vdupq_n_u8('Z')));
+            }
+
+            inline uint8x16_t lowercase_mask(uint8x16_t block) {
+                return vandq_u8(vcgeq_u8(block, vdupq_n_u8('a')), vcleq_u8(block, vdupq_n_u8('z')));
+            }
+
+            inline uint8x16_t fold_lower(uint8x16_t block) {
+                return vorrq_u8(block, vandq_u8(uppercase_mask(block), vdupq_n_u8(0x20)));
+            }
+
+            // Returns a bitmask with four bits set for each whitespace character of the block
+            inline std::uint64_t whitespace_mask(uint8x16_t block) {
+                uint8x16_t control = vcleq_u8(vsubq_u8(block, vdupq_n_u8('\t')), vdupq_n_u8(4));
+                uint8x16_t space = vceqq_u8(block, vdupq_n_u8(' '));
+
+                // Narrow each 8-bit comparison result to 4 bits to build a 64-bit mask
+                return vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(vorrq_u8(control, space)), 4)), 0);
+            }
+        #endif
+
+        bool iequals(const char* first, const char* second, std::size_t length) {
+            std::size_t i = 0u;
+
+            #if defined(UTILS_SIMD_SSE2)
+                for (; i + 16u <= length; i += 16u) {
+                    __m128i a = fold_lower(_mm_loadu_si128(reinterpret_cast<const __m128i*>(first + i)));
+                    __m128i b = fold_lower(_mm_loadu_si128(reinterpret_cast<const __m128i*>(second + i)));
+                    if (_mm_movemask_epi8(_mm_cmpeq_epi8(a, b)) != 0xFFFF) {
+                        return false;
+                    }
+                }
+            #elif defined(UTILS_SIMD_NEON)
+                for (; i + 16u <= length; i += 16u) {
+                    uint8x16_t a = fold_lower(vld1q_u8(reinterpret_cast<const std::uint8_t*>(first + i)));
+                    uint8x16_t b = fold_lower(vld1q_u8(reinterpret_cast<const std::uint8_t*>(second + i)));
+                    if (vminvq_u8(vceqq_u8(a, b)) != 0xFF) {
+                        return false;
+                    }
+                }
+            #endif
+
+            for (; i + 8u <= length; i += 8u) {
+                if (fold_lower(load_word(first + i, 8u)) != fold_lower(load_word(second + i, 8u))) {
+                    return false;
+                }
+            }
+
+            for (; i < length; ++i) {
+                if (ascii::to_lower(first[i]) != ascii::to_lower(second[i])) {
+                    return false;
+                }
+            }
+
+            return true;
+        }
+
+        std::size_t count_leading_spaces(const char* data, std::size_t length) {
+            std::size_t i = 0u;
+
+            #if defined(UTILS_SIMD_SSE2)
+                for (; i + 16u <= length; i += 16u) {
+                    unsigned mask = ~whitespace_mask(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i))) & 0xFFFFu;
+                    if (mask) {
+                        return i + std::countr_zero(mask);
+                    }
+                }
+            #elif defined(UTILS_SIMD_NEON)
+                for (; i + 16u <= length; i += 16u) {
+                    std::uint64_t mask = ~whitespace_mask(vld1q_u8(reinterpret_cast<const std::uint8_t*>(data + i)));
+                    if (mask) {
+                        return i + (std::countr_zero(mask) >> 2);
+                    }
+                }
+            #endif
+
+            while (i < length && is_space(data[i])) {
+                ++i;
+            }
+            return i;
+        }
+
+        std::size_t count_trailing_spaces(const char* data, std::size_t length) {
+            std::size_t count = 0u;
+
+            #if defined(UTILS_SIMD_SSE2)
+                for (; count + 16u <= length; count += 16u) {
+                    unsigned mask = ~whitespace_mask(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data + length - count - 16u))) & 0xFFFFu;
+                    if (mask) {
+                        // Characters after the highest non-whitespace character of the block are whitespace
+                        return count + (std::countl_zero(mask) - 16u);
+                    }
+                }
+            #elif defined(UTILS_SIMD_NEON)
+                for (; count + 16u <= length; count += 16u) {
+                    std::uint64_t mask = ~whitespace_mask(vld1q_u8(reinterpret_cast<const std::uint8_t*>(data + length - count - 16u)));
+                    if (mask) {
+                        return count + (std::countl_zero(mask) >> 2);
+                    }
+                }
+            #endif
+
+            while (count < length && is_space(data[length - count - 1u])) {
+                ++count;
+            }
+            return count;
+        }
+
+        void to_lower(char* data, std::size_t length) {
+            std::size_t i = 0u;
+
+            #if defined(UTILS_SIMD_SSE2)
+                for (; i + 16u <= length; i += 16u) {
+                    __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+                    _mm_storeu_si128(reinterpret_cast<__m128i*>(data + i), fold_lower(block));
+                }
+            #elif defined(UTILS_SIMD_NEON)
+                for (; i + 16u <= length; i += 16u) {
+                    uint8x16_t block = vld1q_u8(reinterpret_cast<const std::uint8_t*>(data + i));
+                    vst1q_u8(reinterpret_cast<std::uint8_t*>(data + i), fold_lower(block));
+                }
+            #endif
+
+            for (; i < length; ++i) {
+                data[i] = ascii::to_lower(data[i]);
+            }
+        }
+
+        void to_upper(char* data, std::size_t length) {
+            std::size_t i = 0u;
+
+            #if defined(UTILS_SIMD_SSE2)
+                for (; i + 16u <= length; i += 16u) {
+                    __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+                    block = _mm_andnot_si128(_mm_and_si128(lowercase_mask(block), _mm_set1_epi8(0x20)), block);
+                    _mm_storeu_si128(reinterpret_cast<__m128i*>(data + i), block);
+                }
+            #elif defined(UTILS_SIMD_NEON)
+                for (; i + 16u <= length; i += 16u) {
+                    uint8x16_t block = vld1q_u8(reinterpret_cast<const std::uint8_t*>(data + i));
+                    block = vbicq_u8(block, vandq_u8(lowercase_mask(block), vdupq_n_u8(0x20)));
+                    vst1q_u8(reinterpret_cast<std::uint8_t*>(data + i), block);
+                }
+            #endif
+
+            for (; i < length; ++i) {
+                data[i] = ascii::to_upper(data[i]);
+            }
+        }
+
+    }
+
+    std::string to_lower(std::string_view in) {
+        std::string result(in);
+        detail::to_lower(result.data(), result.length());
+        return result;
+    }
+
+    std::string to_upper(std::string_view in) {
+        std::string result(in);
+        detail::to_upper(result.data(), result.length());
+        return result;
+    }
+
+    void to_lower_in_place(std::span<char> str) {
+        detail::to_lower(str.data(), str.size());
+    }
+
+    void to_upper_in_place(std::span<char> str) {
+        detail::to_upper(str.data(), str.size());
+    }
+
+}
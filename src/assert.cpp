@@ -1,24 +1,30 @@
 
 #include "utils/assert.hpp"
 #include "utils/string.hpp"
+#include "utils/logging.hpp"
+
+#include <cstdio> // std::fprintf, stderr
+#include <cstdlib> // std::abort
 
 namespace utils {
     namespace internal {
         
+        // Set while a failed assertion is being reported, assertions that fail within logging are written directly to stderr instead
+        thread_local bool reporting = false;
+        
         // Assert implementation.
-        void cppassert(const std::string& expression, std::source_location source, const std::string& message) {
-            // TODO: hook up with logging functionality
-//            std::string error = format("ERROR: assertion {} failed in {}, {}:{}: {}", expression, source.file_name(), source.line(), message);
-//            std::cerr << error << std::endl;
+        void cppassert(const char* expression, std::source_location source, std::string_view message) {
+            if (!reporting) {
+                reporting = true;
+                logging::error(logging::Message("assertion '{}' failed in {}, {}:{}: {}", source), expression, source.function_name(), source.file_name(), source.line(), message);
+                logging::flush();
+            }
+            else {
+                std::fprintf(stderr, "assertion '%s' failed in %s, %s:%u: %.*s\n", expression, source.function_name(), source.file_name(), static_cast<unsigned>(source.line()), static_cast<int>(message.length()), message.data());
+            }
+            
             std::abort();
         }
         
     }
-    
-    void cppassert(const std::string& expression, bool result, std::source_location source, const std::string& message) {
-        if (!result) {
-            internal::cppassert(expression, source, message);
-        }
-    }
-    
-}
\ No newline at end of file
+}
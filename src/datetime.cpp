@@ -1,17 +1,76 @@
 
 #include "utils/datetime.hpp"
 #include "utils/string.hpp"
+#include "utils/platform.hpp"
+#include "utils/exceptions.hpp"
 
 #include <chrono> // std::chrono
+#include <atomic> // std::atomic
+#include <memory> // std::shared_ptr, std::make_shared
+#include <algorithm> // std::min
+#include <cstring> // std::memcpy, std::memset, std::memchr
+#include <span> // std::span
+#include <type_traits> // std::is_same
 
 namespace utils {
+    
+    std::atomic<Clock::Source> clock_source { Clock::Source::Precise };
+    
+    // Calendar breakdown of the last second converted on this thread
+    struct CalendarCache {
+        CalendarCache();
+        
+        std::chrono::seconds second; // Since the Unix epoch
+        Date date;
+        Time time; // Millisecond is always 0
+    };
+    
+    thread_local CalendarCache calendar_cache;
+    
+    // Constant-time conversions between civil (proleptic Gregorian) dates and days since the Unix epoch
+    // Based on http://howardhinnant.github.io/date_algorithms.html
+    // Years are shifted to start in March, which places the leap day at the end of each (shifted) year
+    
+    std::int64_t days_from_civil(std::int64_t year, unsigned month, unsigned day) {
+        year -= month <= 2u;
+        std::int64_t era = (year >= 0 ? year : year - 399) / 400;
+        unsigned yoe = static_cast<unsigned>(year - era * 400); // [0, 399]
+        unsigned doy = (153u * (month > 2u ? month - 3u : month + 9u) + 2u) / 5u + day - 1u; // [0, 365]
+        unsigned doe = yoe * 365u + yoe / 4u - yoe / 100u + doy; // [0, 146096]
+        return era * 146097 + static_cast<std::int64_t>(doe) - 719468;
+    }
+    
+    Date civil_from_days(std::int64_t days) {
+        days += 719468;
+        std::int64_t era = (days >= 0 ? days : days - 146096) / 146097;
+        unsigned doe = static_cast<unsigned>(days - era * 146097); // [0, 146096]
+        unsigned yoe = (doe - doe / 1460u + doe / 36524u - doe / 146096u) / 365u; // [0, 399]
+        unsigned doy = doe - (365u * yoe + yoe / 4u - yoe / 100u); // [0, 365]
+        unsigned mp = (5u * doy + 2u) / 153u; // [0, 11], starting from March
+        unsigned day = doy - (153u * mp + 2u) / 5u + 1u; // [1, 31]
+        unsigned month = mp < 10u ? mp + 3u : mp - 9u; // [1, 12]
+        std::int64_t year = static_cast<std::int64_t>(yoe) + era * 400 + (month <= 2u);
+        return { (std::uint8_t) day, (Month) month, (std::uint32_t) year };
+    }
+    
+    constexpr std::int64_t milliseconds_per_day = 24ll * 60ll * 60ll * 1000ll;
+    
+    // Returns the number of milliseconds between the Unix epoch and 'timestamp'
+    std::int64_t to_epoch_milliseconds(const Timestamp& timestamp) {
+        std::int64_t days = days_from_civil(timestamp.date.year, timestamp.date.month, timestamp.date.day);
+        std::int64_t milliseconds = ((timestamp.time.hour * 60ll + timestamp.time.minute) * 60ll + timestamp.time.second) * 1000ll + timestamp.time.millisecond;
+        return days * milliseconds_per_day + milliseconds;
+    }
 
     bool is_leap_year(unsigned year) {
         return (year % 400 == 0) || (year % 4 == 0 && year % 100 != 0);
     }
     
     std::uint8_t num_days_in_month(Month month, std::uint32_t year) {
-        static const int num_days_in_month[] = { 31, is_leap_year(year) ? 29 : 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31 };
+        static const int num_days_in_month[] = { 31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31 };
+        if (month == February && is_leap_year(year)) {
+            return 29;
+        }
         return num_days_in_month[month - 1];
     }
     
@@ -71,15 +130,7 @@ namespace utils {
         return { };
     }
     
-    Date::Date() {
-        std::chrono::time_point<std::chrono::system_clock> now = std::chrono::system_clock::now();
-        std::time_t time_point = std::chrono::system_clock::to_time_t(now);
-        std::tm time { }; // UTC
-        gmtime_s(&time, &time_point);
-        
-        day = (std::uint8_t) time.tm_mday;
-        month = (Month) (time.tm_mon + 1); // Convert from range [0, 11] to [1, 12]
-        year = (std::uint32_t) time.tm_year + 1900;
+    Date::Date() : Date(Timestamp::now().date) {
     }
     
     Date::Date(Month month, std::uint8_t day, std::uint32_t year) : year(year),
@@ -97,17 +148,9 @@ namespace utils {
     Date::~Date() = default;
     
     std::uint32_t Date::count_days() const {
-        unsigned count = 0;
-        
-        for (unsigned y = 1; y < year; ++y) { // Years start at 1
-            count += is_leap_year(y) ? 366 : 365;
-        }
-        
-        for (unsigned m = 1; m < month; ++m) {
-            count += num_days_in_month((Month) m, year);
-        }
-        
-        return count + day;
+        // Years start at 1, January 1st of year 1 is day 1
+        static const std::int64_t first_day = days_from_civil(1, January, 1u);
+        return (std::uint32_t) (days_from_civil(year, month, day) - first_day + 1);
     }
     
     Weekday Date::weekday() const {
@@ -164,16 +207,7 @@ namespace utils {
         return { };
     }
     
-    Time::Time() {
-        std::chrono::time_point<std::chrono::system_clock> now = std::chrono::system_clock::now();
-        std::time_t time_point = std::chrono::system_clock::to_time_t(now);
-        std::tm time { }; // UTC
-        gmtime_s(&time, &time_point);
-        
-        hour = (std::uint32_t) time.tm_hour;
-        minute = (std::uint8_t) time.tm_min;
-        second = (std::uint8_t) time.tm_sec;
-        millisecond = (std::uint16_t) (std::chrono::duration_cast<std::chrono::milliseconds>(now.time_since_epoch() % std::chrono::seconds(1)).count());
+    Time::Time() : Time(Timestamp::now().time) {
     }
     
     Time::Time(std::uint32_t hour, std::uint32_t minute, std::uint32_t second, std::uint32_t millisecond) : hour(hour),
@@ -280,11 +314,34 @@ namespace utils {
     }
     
     Timestamp Timestamp::now() {
-        return { };
+        return Timestamp(Clock::now());
+    }
+    
+    // Date and time are read from a single clock sample, so the two always agree (including across midnight)
+    Timestamp::Timestamp() : Timestamp(Clock::now()) {
+    }
+    
+    Timestamp::Timestamp(Clock::time_point time_point) : Timestamp(calendar_cache.date, calendar_cache.time) {
+        std::chrono::milliseconds milliseconds = std::chrono::floor<std::chrono::milliseconds>(time_point.time_since_epoch());
+        std::chrono::seconds second = std::chrono::floor<std::chrono::seconds>(milliseconds);
+        
+        if (second != calendar_cache.second) {
+            std::chrono::days days = std::chrono::floor<std::chrono::days>(second);
+            std::int64_t seconds = (second - days).count(); // Seconds into the day
+            
+            calendar_cache.second = second;
+            calendar_cache.date = civil_from_days(days.count());
+            calendar_cache.time = Time((std::uint32_t) (seconds / 3600), (std::uint32_t) (seconds / 60 % 60), (std::uint32_t) (seconds % 60));
+            
+            date = calendar_cache.date;
+            time = calendar_cache.time;
+        }
+        
+        time.millisecond = (std::uint16_t) (milliseconds - second).count();
     }
     
-    Timestamp::Timestamp() : date(),
-                             time() {
+    Timestamp::Timestamp(const Date& date, const Time& time) : date(date),
+                                                               time(time) {
     }
     
     Timestamp::Timestamp(Month month, std::uint8_t day, std::uint32_t year, std::uint32_t h, std::uint32_t m, std::uint32_t s, std::uint32_t ms) {
@@ -304,99 +361,887 @@ namespace utils {
         time = Time(hour, minute, second, millisecond);
         
         // Handle overflow for date
-        bool leap = is_leap_year(year);
+        if (month < 1 || month > 12) {
+            throw std::runtime_error("invalid month - month must be in range [1, 12]");
+        }
         
-        while (d > num_days_in_month(month, year)) {
-            d -= num_days_in_month(month, year);
-            if (month == December) {
-                month = January;
-                ++year;
-            }
-            else {
-                month = (Month) (month + 1);
-            }
+        if (day < 1) {
+            throw std::runtime_error("invalid day - must be at least 1");
         }
         
-        date = Date(d, month, year);
+        date = civil_from_days(days_from_civil(year, month, 1u) + (d - 1u));
     }
     
     Timestamp::~Timestamp() = default;
     
+    CalendarCache::CalendarCache() : second(0),
+                                     date(January, 1u, 1970u),
+                                     time(0u, 0u) {
+    }
+    
+    Clock::time_point Clock::now() {
+        #if defined(PLATFORM_LINUX)
+            if (clock_source.load(std::memory_order_relaxed) == Source::Coarse) {
+                timespec time { };
+                clock_gettime(CLOCK_REALTIME_COARSE, &time);
+                return time_point(std::chrono::duration_cast<time_point::duration>(std::chrono::seconds(time.tv_sec) + std::chrono::nanoseconds(time.tv_nsec)));
+            }
+        #endif
+        
+        return std::chrono::system_clock::now();
+    }
+    
+    void Clock::set_source(Source source) {
+        clock_source.store(source, std::memory_order_relaxed);
+    }
+    
+    Clock::Source Clock::get_source() {
+        return clock_source.load(std::memory_order_relaxed);
+    }
+    
     Duration Timestamp::operator-(const Timestamp& other) const {
         if (*this == other) {
             return { };
         }
         
-        Timestamp start, end;
+        // Duration is absolute
+        std::int64_t difference = to_epoch_milliseconds(*this) - to_epoch_milliseconds(other);
+        std::uint64_t milliseconds = difference < 0 ? (std::uint64_t) -difference : (std::uint64_t) difference;
         
-        if (*this > other) {
-            start = other;
-            end = *this;
+        return { (std::uint32_t) (milliseconds % 1000u), (std::uint32_t) (milliseconds / 1000u % 60u), (std::uint32_t) (milliseconds / 60000u % 60u), (std::uint32_t) (milliseconds / 3600000u % 24u), (std::uint32_t) (milliseconds / (std::uint64_t) milliseconds_per_day) };
+    }
+    
+    bool Timestamp::operator==(const Timestamp& other) const {
+        return date == other.date && time == other.time;
+    }
+    
+    bool Timestamp::operator<(const Timestamp& other) const {
+        return date < other.date || (date == other.date && time < other.time);
+    }
+    
+    bool Timestamp::operator<=(const Timestamp& other) const {
+        return !(other < *this);
+    }
+    
+    bool Timestamp::operator>(const Timestamp& other) const {
+        return other < *this;
+    }
+    
+    bool Timestamp::operator>=(const Timestamp& other) const {
+        return !(*this < other);
+    }
+    
+    EpochTimestamp EpochTimestamp::now() {
+        return EpochTimestamp(Clock::now());
+    }
+    
+    EpochTimestamp::EpochTimestamp(const Timestamp& timestamp) : microseconds(to_epoch_milliseconds(timestamp) * 1000) {
+    }
+    
+    Timestamp EpochTimestamp::to_timestamp() const {
+        return Timestamp(to_time_point());
+    }
+    
+    // Timestamp parsing
+    
+    // Calendar fields of a parsed date / time, validated against the ranges of Date and Time
+    struct ParsedTimestamp {
+        std::uint32_t year = 1970u;
+        unsigned month = 1u;
+        unsigned day = 1u;
+        unsigned hour = 0u;
+        unsigned minute = 0u;
+        unsigned second = 0u;
+        unsigned millisecond = 0u;
+        int offset = 0; // Minutes east of UTC
+        
+        [[nodiscard]] std::int64_t to_epoch_milliseconds() const {
+            std::int64_t milliseconds = ((hour * 60ll + minute) * 60ll + second) * 1000ll + millisecond;
+            return days_from_civil(year, month, day) * milliseconds_per_day + milliseconds - offset * 60000ll;
         }
-        else {
-            start = *this;
-            end = other;
+        
+        [[nodiscard]] Timestamp to_timestamp() const {
+            if (offset != 0) {
+                return Timestamp(Clock::time_point(std::chrono::milliseconds(to_epoch_milliseconds())));
+            }
+            return Timestamp(Date((std::uint8_t) day, (Month) month, year), Time(hour, minute, second, millisecond));
+        }
+    };
+    
+    struct ParseState {
+        explicit ParseState(std::string_view in) : first(in.data()),
+                                                   current(in.data()),
+                                                   last(in.data() + in.length()),
+                                                   error(ParseError::InvalidArgument),
+                                                   error_position(nullptr) {
         }
         
-        unsigned days = end.date.count_days() - start.date.count_days();
-        unsigned hours;
-        unsigned minutes;
-        unsigned seconds;
-        unsigned milliseconds;
+        bool fail(const char* position, ParseError e) {
+            error = e;
+            error_position = position;
+            return false;
+        }
         
-        if (end.time.hour >= start.time.hour) {
-            hours = end.time.hour - start.time.hour;
+        // Locates the first character of [current, last) that does not match 'layout' ('#' matches any digit)
+        // Only called once the fast path has already rejected the input
+        bool mismatch(std::string_view layout) {
+            const char* position = current;
+            for (char expected : layout) {
+                if (position == last || (expected == '#' ? !ascii::is_digit(*position) : *position != expected)) {
+                    break;
+                }
+                ++position;
+            }
+            return fail(position, ParseError::InvalidArgument);
+        }
+        
+        const char* first;
+        const char* current;
+        const char* last;
+        
+        ParseError error;
+        const char* error_position;
+    };
+    
+    // Validates that 'digits' consists of 8 decimal digits
+    bool is_eight_digits(const char (&digits)[8]) {
+        std::uint64_t chunk;
+        std::memcpy(&chunk, digits, sizeof(chunk));
+        return detail::is_eight_digits(chunk); // Checks each byte independently, regardless of byte order
+    }
+    
+    // Converts 8 decimal digits to their value
+    std::uint32_t parse_eight_digits(const char (&digits)[8]) {
+        if constexpr (detail::swar_available) {
+            std::uint64_t chunk;
+            std::memcpy(&chunk, digits, sizeof(chunk));
+            return detail::parse_eight_digits(chunk);
         }
         else {
-            days -= 1;
-            hours = (24 + end.time.hour) - start.time.hour;
+            std::uint32_t value = 0u;
+            for (char digit : digits) {
+                value = value * 10u + (digit - '0');
+            }
+            return value;
+        }
+    }
+    
+    bool validate_date(ParseState& state, const char* month_position, const char* day_position, ParsedTimestamp& out) {
+        if (out.month < 1u || out.month > 12u) {
+            return state.fail(month_position, ParseError::OutOfRange);
         }
         
-        if (end.time.minute >= start.time.minute) {
-            minutes = end.time.minute - start.time.minute;
+        if (out.day < 1u || out.day > num_days_in_month((Month) out.month, out.year)) {
+            return state.fail(day_position, ParseError::OutOfRange);
         }
-        else {
-            hours -= 1;
-            minutes = (60 + end.time.minute) - start.time.minute;
+        
+        return true;
+    }
+    
+    // ISO-8601 (YYYY-MM-DD) or default (MM/DD/YYYY) date layout, distinguished by the position of the first separator
+    bool parse_date(ParseState& state, ParsedTimestamp& out, bool& iso) {
+        const char* c = state.current;
+        std::size_t available = state.last - c;
+        
+        iso = !(available > 2u && c[2] == '/');
+        char digits[8];
+        
+        if (iso) {
+            if (available < 10u || c[4] != '-' || c[7] != '-') {
+                return state.mismatch("####-##-##");
+            }
+            
+            // YYYYMMDD
+            std::memcpy(digits, c, 4u);
+            std::memcpy(digits + 4, c + 5, 2u);
+            std::memcpy(digits + 6, c + 8, 2u);
+            
+            if (!is_eight_digits(digits)) {
+                return state.mismatch("####-##-##");
+            }
+            
+            std::uint32_t value = parse_eight_digits(digits);
+            out.year = value / 10000u;
+            out.month = value / 100u % 100u;
+            out.day = value % 100u;
+            
+            state.current = c + 10;
+            return validate_date(state, c + 5, c + 8, out);
+        }
+        
+        // Years are written without padding, the fast path covers the common case of a 4-digit year
+        const char* year = c + std::min(available, std::size_t(6u));
+        const char* year_end = year;
+        while (year_end != state.last && ascii::is_digit(*year_end)) {
+            ++year_end;
+        }
+        
+        std::size_t year_length = year_end - year;
+        if (available < 7u || c[5] != '/' || year_length == 0u) {
+            return state.mismatch("##/##/#");
+        }
+        
+        if (year_length > 9u) {
+            return state.fail(year, ParseError::OutOfRange);
+        }
+        
+        // MMDDYYYY
+        std::memcpy(digits, c, 2u);
+        std::memcpy(digits + 2, c + 3, 2u);
+        std::memcpy(digits + 4, year_length == 4u ? year : "0000", 4u);
+        
+        if (!is_eight_digits(digits)) {
+            return state.mismatch("##/##/#");
+        }
+        
+        std::uint32_t value = parse_eight_digits(digits);
+        out.month = value / 1000000u;
+        out.day = value / 10000u % 100u;
+        out.year = value % 10000u;
+        
+        if (year_length != 4u) {
+            out.year = 0u;
+            for (const char* digit = year; digit != year_end; ++digit) {
+                out.year = out.year * 10u + (*digit - '0');
+            }
+        }
+        
+        state.current = year_end;
+        return validate_date(state, c, c + 3, out);
+    }
+    
+    // Optional UTC offset: Z, +HH, +HH:MM, or +HHMM (or '-')
+    // Anything else is left unprocessed
+    bool parse_offset(ParseState& state, ParsedTimestamp& out) {
+        const char* c = state.current;
+        std::size_t available = state.last - c;
+        
+        if (available == 0u) {
+            return true;
+        }
+        
+        if (*c == 'Z') {
+            ++state.current;
+            return true;
+        }
+        
+        if ((*c != '+' && *c != '-') || available < 3u || !ascii::is_digit(c[1]) || !ascii::is_digit(c[2])) {
+            return true;
+        }
+        
+        unsigned hours = (c[1] - '0') * 10u + (c[2] - '0');
+        unsigned minutes = 0u;
+        const char* end = c + 3;
+        
+        const char* minute = end + (available > 3u && c[3] == ':');
+        if (state.last - minute >= 2 && ascii::is_digit(minute[0]) && ascii::is_digit(minute[1])) {
+            minutes = (minute[0] - '0') * 10u + (minute[1] - '0');
+            end = minute + 2;
+        }
+        
+        if (hours > 23u) {
+            return state.fail(c + 1, ParseError::OutOfRange);
+        }
+        
+        if (minutes > 59u) {
+            return state.fail(minute, ParseError::OutOfRange);
+        }
+        
+        out.offset = (*c == '-' ? -1 : 1) * static_cast<int>(hours * 60u + minutes);
+        state.current = end;
+        return true;
+    }
+    
+    // HH:MM:SS, followed by either a fraction of a second (.fff) or a number of milliseconds (:ffff)
+    bool parse_time(ParseState& state, ParsedTimestamp& out, bool allow_offset) {
+        const char* c = state.current;
+        std::size_t available = state.last - c;
+        
+        if (available < 8u || c[2] != ':' || c[5] != ':') {
+            return state.mismatch("##:##:##");
+        }
+        
+        // HHMMSS00
+        char digits[8];
+        std::memcpy(digits, c, 2u);
+        std::memcpy(digits + 2, c + 3, 2u);
+        std::memcpy(digits + 4, c + 6, 2u);
+        digits[6] = '0';
+        digits[7] = '0';
+        
+        if (!is_eight_digits(digits)) {
+            return state.mismatch("##:##:##");
+        }
+        
+        std::uint32_t value = parse_eight_digits(digits) / 100u;
+        out.hour = value / 10000u;
+        out.minute = value / 100u % 100u;
+        out.second = value % 100u;
+        
+        if (out.hour > 23u) {
+            return state.fail(c, ParseError::OutOfRange);
         }
         
-        if (end.time.second >= start.time.second) {
-            seconds = end.time.second - start.time.second;
+        if (out.minute > 59u) {
+            return state.fail(c + 3, ParseError::OutOfRange);
+        }
+        
+        if (out.second > 59u) {
+            return state.fail(c + 6, ParseError::OutOfRange);
+        }
+        
+        state.current = c + 8;
+        
+        if (state.current != state.last && (*state.current == '.' || *state.current == ':')) {
+            bool fraction = *state.current == '.';
+            const char* first = ++state.current;
+            
+            while (state.current != state.last && ascii::is_digit(*state.current)) {
+                ++state.current;
+            }
+            
+            std::size_t num_digits = state.current - first;
+            if (num_digits == 0u) {
+                return state.fail(first, ParseError::InvalidArgument);
+            }
+            
+            if (fraction) {
+                // Truncated to millisecond precision
+                out.millisecond = 0u;
+                for (std::size_t i = 0u; i < 3u; ++i) {
+                    out.millisecond = out.millisecond * 10u + (i < num_digits ? first[i] - '0' : 0u);
+                }
+            }
+            else {
+                if (num_digits > 8u) {
+                    return state.fail(first, ParseError::OutOfRange);
+                }
+                
+                // Right-aligned, 0000ffff for the default layout
+                std::memset(digits, '0', sizeof(digits));
+                std::memcpy(digits + (8u - num_digits), first, num_digits);
+                out.millisecond = parse_eight_digits(digits);
+                
+                if (out.millisecond > 999u) {
+                    return state.fail(first, ParseError::OutOfRange);
+                }
+            }
+        }
+        
+        return !allow_offset || parse_offset(state, out);
+    }
+    
+    // Parses a complete timestamp starting at the current position (without skipping whitespace)
+    bool parse_timestamp(ParseState& state, ParsedTimestamp& out) {
+        bool iso;
+        if (!parse_date(state, out, iso)) {
+            return false;
+        }
+        
+        if (state.current == state.last || !(*state.current == ' ' || (iso && *state.current == 'T'))) {
+            return state.fail(state.current, ParseError::InvalidArgument);
+        }
+        
+        ++state.current;
+        return parse_time(state, out, iso);
+    }
+    
+    template <typename T>
+    ParseResult<T, ParseError> parse_datetime(std::string_view in) {
+        ParseState state(in);
+        
+        // Leading whitespace is ignored, but still counts towards the number of characters processed
+        while (state.current != state.last && ascii::is_space(*state.current)) {
+            ++state.current;
+        }
+        
+        if (state.current == state.last) {
+            return ParseResult<T, ParseError>::NOT_OK(in.length(), ParseError::Empty);
+        }
+        
+        ParsedTimestamp fields { };
+        bool success;
+        
+        if constexpr (std::is_same<T, Date>::value) {
+            bool iso;
+            success = parse_date(state, fields, iso);
+        }
+        else if constexpr (std::is_same<T, Time>::value) {
+            success = parse_time(state, fields, false);
         }
         else {
-            minutes -= 1;
-            seconds = (60 + end.time.second) - start.time.second;
+            success = parse_timestamp(state, fields);
+        }
+        
+        if (!success) {
+            return ParseResult<T, ParseError>::NOT_OK(state.error_position - state.first, state.error);
         }
         
-        if (end.time.millisecond >= start.time.millisecond) {
-            milliseconds = end.time.millisecond - start.time.millisecond;
+        // Trailing whitespace is considered processed only if it makes up the remainder of the input
+        std::size_t num_characters_processed = state.current - state.first;
+        if (ascii::trim_left(in.substr(num_characters_processed)).empty()) {
+            num_characters_processed = in.length();
+        }
+        
+        if constexpr (std::is_same<T, Date>::value) {
+            return ParseResult<T, ParseError>::OK(num_characters_processed, Date((std::uint8_t) fields.day, (Month) fields.month, fields.year));
+        }
+        else if constexpr (std::is_same<T, Time>::value) {
+            return ParseResult<T, ParseError>::OK(num_characters_processed, Time(fields.hour, fields.minute, fields.second, fields.millisecond));
         }
         else {
-            seconds -= 1;
-            milliseconds = (1000 + end.time.millisecond) - start.time.millisecond;
+            return ParseResult<T, ParseError>::OK(num_characters_processed, fields.to_timestamp());
+        }
+    }
+    
+    template <typename T>
+    std::size_t datetime_from_string(std::string_view in, T& out) {
+        ParseResult<T, ParseError> result = parse_datetime<T>(in);
+        
+        if (!result.ok()) {
+            switch (result.error()) {
+                case ParseError::Empty:
+                    throw FormattedError("failed to parse '{}' - input is empty", in);
+                case ParseError::InvalidArgument:
+                    throw FormattedError("failed to parse '{}' - invalid character at position {}", in, result.offset());
+                case ParseError::OutOfRange:
+                    throw FormattedError("failed to parse '{}' - value at position {} is out of range", in, result.offset());
+            }
         }
         
-        return { milliseconds, seconds, minutes, hours, days };
+        out = result.result();
+        return result.offset();
     }
     
-    bool Timestamp::operator==(const Timestamp& other) const {
-        return date == other.date && time == other.time;
+    std::size_t from_string(std::string_view in, Timestamp& out) {
+        return datetime_from_string(in, out);
     }
     
-    bool Timestamp::operator<(const Timestamp& other) const {
-        return date < other.date && time < other.time;
+    std::size_t from_string(std::string_view in, Date& out) {
+        return datetime_from_string(in, out);
     }
     
-    bool Timestamp::operator<=(const Timestamp& other) const {
-        return date <= other.date && time <= other.time;
+    std::size_t from_string(std::string_view in, Time& out) {
+        return datetime_from_string(in, out);
     }
     
-    bool Timestamp::operator>(const Timestamp& other) const {
-        return date > other.date && time > other.time;
+    template <>
+    ParseResult<Timestamp, ParseError> from_string<Timestamp>(std::string_view in) {
+        return parse_datetime<Timestamp>(in);
     }
     
-    bool Timestamp::operator>=(const Timestamp& other) const {
-        return date >= other.date && time >= other.time;
+    template <>
+    ParseResult<Date, ParseError> from_string<Date>(std::string_view in) {
+        return parse_datetime<Date>(in);
+    }
+    
+    template <>
+    ParseResult<Time, ParseError> from_string<Time>(std::string_view in) {
+        return parse_datetime<Time>(in);
+    }
+    
+    // Returns whether 'field' was parsed successfully, fields must consist of exactly one timestamp (surrounded by optional whitespace)
+    bool parse_epoch_timestamp(std::string_view field, EpochTimestamp& out) {
+        ParseState state(ascii::trim(field));
+        ParsedTimestamp fields { };
+        
+        if (!parse_timestamp(state, fields) || state.current != state.last) {
+            out = EpochTimestamp();
+            return false;
+        }
+        
+        out = EpochTimestamp(fields.to_epoch_milliseconds() * 1000);
+        return true;
+    }
+    
+    template <>
+    BulkParseResult from_string<EpochTimestamp>(std::span<const std::string_view> in, std::span<EpochTimestamp> out) {
+        BulkParseResult result { 0u, 0u, 0u };
+        
+        std::size_t count = std::min(in.size(), out.size());
+        for (std::size_t i = 0u; i < count; ++i) {
+            detail::record_field(parse_epoch_timestamp(in[i], out[i]), result);
+        }
+        
+        if (result.num_errors == 0u) {
+            result.first_error = result.count;
+        }
+        return result;
+    }
+    
+    template <>
+    BulkParseResult parse_column<EpochTimestamp>(std::string_view buffer, char delimiter, std::span<EpochTimestamp> out) {
+        BulkParseResult result { 0u, 0u, 0u };
+        
+        const char* data = buffer.data();
+        std::size_t length = buffer.length();
+        std::size_t position = 0u;
+        
+        while (position < length && result.count < out.size()) {
+            // Fields without surrounding whitespace are scanned only once
+            ParseState state(buffer.substr(position));
+            ParsedTimestamp fields { };
+            
+            if (parse_timestamp(state, fields) && (state.current == state.last || *state.current == delimiter)) {
+                out[result.count] = EpochTimestamp(fields.to_epoch_milliseconds() * 1000);
+                detail::record_field(true, result);
+                position = state.current - data + 1u;
+                continue;
+            }
+            
+            const void* next = std::memchr(data + position, delimiter, length - position);
+            std::size_t end = next ? static_cast<const char*>(next) - data : length;
+            detail::record_field(parse_epoch_timestamp(buffer.substr(position, end - position), out[result.count]), result);
+            position = end + 1u;
+        }
+        
+        if (result.num_errors == 0u) {
+            result.first_error = result.count;
+        }
+        return result;
+    }
+    
+    constexpr std::string_view default_date_format = "{month:width=[2],fill=[0],justification=[right]}/{day:width=[2],fill=[0],justification=[right]}/{year}";
+    constexpr std::string_view default_time_format = "{hour:width=[2],fill=[0],justification=[right]}:{minute:width=[2],fill=[0],justification=[right]}:{second:width=[2],fill=[0],justification=[right]}:{millisecond:width=[4],fill=[0],justification=[right]}";
+    
+    constexpr const char* month_names[] = { "January", "February", "March", "April", "May", "June", "July", "August", "September", "October", "November", "December" };
+    constexpr const char* weekday_names[] = { "Monday", "Tuesday", "Wednesday", "Thursday", "Friday", "Saturday", "Sunday" };
+    
+    struct TimestampPattern::Field {
+        enum class Type : std::uint8_t {
+            Literal = 0,
+            Year,
+            Month,
+            MonthName,
+            MonthAbbreviation,
+            Day,
+            Weekday,
+            WeekdayAbbreviation,
+            Hour,
+            Minute,
+            Second,
+            Millisecond,
+        } type;
+        
+        FormatterBase::Justification justification;
+        std::uint8_t width;
+        char fill_character;
+        std::string literal;
+    };
+    
+    // Prefixes rendered by the patterns most recently used on this thread, indexed by pattern ID
+    struct PrefixCacheEntry {
+        std::uint64_t pattern; // 0 if the entry is unused
+        std::uint64_t second; // Date and time of the prefix, packed down to the second
+        std::uint8_t length;
+        char data[64];
+    };
+    
+    constexpr std::size_t prefix_cache_size = 4u;
+    thread_local PrefixCacheEntry prefix_cache[prefix_cache_size] { };
+    
+    std::atomic<std::uint64_t> next_pattern_id { 1u };
+    
+    TimestampPattern::TimestampPattern(std::string_view pattern) : m_fields(),
+                                                                   m_prefix_length(0u),
+                                                                   m_id(next_pattern_id.fetch_add(1u, std::memory_order_relaxed)) {
+        compile(pattern);
+        
+        m_prefix_length = m_fields.size();
+        for (std::size_t i = 0u; i < m_fields.size(); ++i) {
+            if (m_fields[i].type == Field::Type::Millisecond) {
+                m_prefix_length = i;
+                break;
+            }
+        }
+    }
+    
+    TimestampPattern::~TimestampPattern() = default;
+    
+    void TimestampPattern::compile(std::string_view pattern) {
+        detail::parse_format_string(pattern, std::source_location::current(), [this](std::string_view literal) {
+            append_literal(literal);
+        }, [this, pattern](const detail::Identifier& identifier, std::string_view format_spec, std::size_t) {
+            if (identifier.type != detail::Identifier::Type::Name) {
+                throw FormattedError("invalid timestamp pattern '{}' - placeholders must reference fields by name", pattern);
+            }
+            
+            FormatSpec spec { };
+            if (!format_spec.empty()) {
+                detail::parse_format_spec(format_spec, spec);
+            }
+            
+            std::string_view name = identifier.name;
+            if (name == "date" || name == "time") {
+                // Nested layouts are compiled in place
+                if (spec.has_specifier("format")) {
+                    compile(spec.get_specifier("format"));
+                }
+                else {
+                    compile(name == "date" ? default_date_format : default_time_format);
+                }
+                return;
+            }
+            
+            FormatterBase base { };
+            base.parse(spec);
+            
+            Field& field = m_fields.emplace_back();
+            field.justification = base.justification;
+            field.width = static_cast<std::uint8_t>(std::min(base.width, std::size_t(255u)));
+            field.fill_character = base.fill_character;
+            
+            std::string_view representation = spec.has_specifier("representation") ? trim(spec.get_specifier("representation")) : std::string_view();
+            
+            if (name == "year") {
+                field.type = Field::Type::Year;
+            }
+            else if (name == "month") {
+                if (icasecmp(representation, "full")) {
+                    field.type = Field::Type::MonthName;
+                }
+                else if (icasecmp(representation, "abbreviated")) {
+                    field.type = Field::Type::MonthAbbreviation;
+                }
+                else {
+                    field.type = Field::Type::Month;
+                }
+            }
+            else if (name == "day") {
+                field.type = Field::Type::Day;
+            }
+            else if (name == "weekday") {
+                field.type = icasecmp(representation, "abbreviated") ? Field::Type::WeekdayAbbreviation : Field::Type::Weekday;
+            }
+            else if (name == "hour") {
+                field.type = Field::Type::Hour;
+            }
+            else if (name == "minute") {
+                field.type = Field::Type::Minute;
+            }
+            else if (name == "second") {
+                field.type = Field::Type::Second;
+            }
+            else if (name == "millisecond") {
+                field.type = Field::Type::Millisecond;
+            }
+            else {
+                throw FormattedError("invalid timestamp pattern '{}' - unknown placeholder '{}'", pattern, name);
+            }
+        });
+    }
+    
+    void TimestampPattern::append_literal(std::string_view literal) {
+        auto append = [this](std::string_view value) {
+            if (value.empty()) {
+                return;
+            }
+            
+            if (m_fields.empty() || m_fields.back().type != Field::Type::Literal) {
+                m_fields.emplace_back().type = Field::Type::Literal;
+            }
+            m_fields.back().literal.append(value);
+        };
+        
+        // Conversions are fixed width and zero-padded (except for the year and names)
+        auto convert = [this](Field::Type type, std::uint8_t width) {
+            Field& field = m_fields.emplace_back();
+            field.type = type;
+            field.justification = FormatterBase::Justification::Right;
+            field.width = width;
+            field.fill_character = '0';
+        };
+        
+        std::size_t position = 0u;
+        while (position < literal.length()) {
+            std::size_t percent = literal.find('%', position);
+            if (percent == std::string_view::npos || percent + 1u == literal.length()) {
+                append(literal.substr(position));
+                break;
+            }
+            
+            append(literal.substr(position, percent - position));
+            position = percent + 2u;
+            
+            switch (literal[percent + 1u]) {
+                case 'Y':
+                    convert(Field::Type::Year, 4u);
+                    break;
+                case 'm':
+                    convert(Field::Type::Month, 2u);
+                    break;
+                case 'd':
+                    convert(Field::Type::Day, 2u);
+                    break;
+                case 'B':
+                    convert(Field::Type::MonthName, 0u);
+                    break;
+                case 'b':
+                    convert(Field::Type::MonthAbbreviation, 0u);
+                    break;
+                case 'A':
+                    convert(Field::Type::Weekday, 0u);
+                    break;
+                case 'a':
+                    convert(Field::Type::WeekdayAbbreviation, 0u);
+                    break;
+                case 'H':
+                    convert(Field::Type::Hour, 2u);
+                    break;
+                case 'M':
+                    convert(Field::Type::Minute, 2u);
+                    break;
+                case 'S':
+                    convert(Field::Type::Second, 2u);
+                    break;
+                case 'f':
+                    convert(Field::Type::Millisecond, 3u);
+                    break;
+                case 'F':
+                    append_literal("%Y-%m-%d");
+                    break;
+                case 'T':
+                    append_literal("%H:%M:%S");
+                    break;
+                case '%':
+                    append("%");
+                    break;
+                default:
+                    // Unknown conversions are kept as-is
+                    append(literal.substr(percent, 2u));
+                    break;
+            }
+        }
+    }
+    
+    void TimestampPattern::format_to(const Date& date, const Time& time, FormatBuffer& out) const {
+        const Field* fields = m_fields.data();
+        
+        if (m_prefix_length > 0u) {
+            std::uint64_t second = (std::uint64_t(date.year) << 40u) | (std::uint64_t(date.month) << 32u) | (std::uint64_t(date.day) << 24u) | (std::uint64_t(time.hour) << 16u) | (std::uint64_t(time.minute) << 8u) | std::uint64_t(time.second);
+            PrefixCacheEntry& entry = prefix_cache[m_id % prefix_cache_size];
+            
+            if (entry.pattern != m_id || entry.second != second) {
+                std::size_t length;
+                {
+                    detail::FixedBuffer buffer(entry.data, sizeof(entry.data));
+                    render(fields, fields + m_prefix_length, date, time, buffer);
+                    length = buffer.count();
+                }
+                
+                if (length > sizeof(entry.data)) {
+                    // Prefix is too long to be cached
+                    entry.pattern = 0u;
+                    render(fields, fields + m_prefix_length, date, time, out);
+                    render(fields + m_prefix_length, fields + m_fields.size(), date, time, out);
+                    return;
+                }
+                
+                entry.pattern = m_id;
+                entry.second = second;
+                entry.length = static_cast<std::uint8_t>(length);
+            }
+            
+            out.append(entry.data, entry.length);
+        }
+        
+        render(fields + m_prefix_length, fields + m_fields.size(), date, time, out);
+    }
+    
+    void TimestampPattern::render(const Field* first, const Field* last, const Date& date, const Time& time, FormatBuffer& out) const {
+        auto justify = [&out](const Field& field, const char* value, std::size_t length) {
+            if (length >= field.width) {
+                out.append(value, length);
+                return;
+            }
+            
+            std::size_t padding = field.width - length;
+            std::size_t leading = field.justification == FormatterBase::Justification::Right ? padding : field.justification == FormatterBase::Justification::Center ? padding / 2u : 0u;
+            
+            out.append(leading, field.fill_character);
+            out.append(value, length);
+            out.append(padding - leading, field.fill_character);
+        };
+        
+        auto number = [&justify](const Field& field, std::uint32_t value) {
+            char digits[10];
+            char* end = digits + sizeof(digits);
+            char* begin = detail::write_decimal_digits(value, end);
+            justify(field, begin, static_cast<std::size_t>(end - begin));
+        };
+        
+        auto name = [&justify](const Field& field, std::string_view value) {
+            justify(field, value.data(), value.length());
+        };
+        
+        for (const Field* field = first; field != last; ++field) {
+            switch (field->type) {
+                case Field::Type::Literal:
+                    out.append(field->literal);
+                    break;
+                case Field::Type::Year:
+                    number(*field, date.year);
+                    break;
+                case Field::Type::Month:
+                    number(*field, date.month);
+                    break;
+                case Field::Type::MonthName:
+                    name(*field, month_names[date.month - 1]);
+                    break;
+                case Field::Type::MonthAbbreviation:
+                    name(*field, std::string_view(month_names[date.month - 1], 3u));
+                    break;
+                case Field::Type::Day:
+                    number(*field, date.day);
+                    break;
+                case Field::Type::Weekday:
+                    name(*field, weekday_names[date.weekday()]);
+                    break;
+                case Field::Type::WeekdayAbbreviation:
+                    name(*field, std::string_view(weekday_names[date.weekday()], 3u));
+                    break;
+                case Field::Type::Hour:
+                    number(*field, time.hour);
+                    break;
+                case Field::Type::Minute:
+                    number(*field, time.minute);
+                    break;
+                case Field::Type::Second:
+                    number(*field, time.second);
+                    break;
+                case Field::Type::Millisecond:
+                    number(*field, time.millisecond);
+                    break;
+            }
+        }
+    }
+    
+    // Renders 'pattern', applying the justification of the formatter to the result
+    void format_pattern(const FormatterBase& formatter, const TimestampPattern& pattern, const Date& date, const Time& time, FormatBuffer& out) {
+        if (formatter.width == 0u) {
+            pattern.format_to(date, time, out);
+            return;
+        }
+        
+        char storage[128];
+        std::size_t length;
+        {
+            detail::FixedBuffer buffer(storage, sizeof(storage));
+            pattern.format_to(date, time, buffer);
+            length = buffer.count();
+        }
+        
+        if (length <= sizeof(storage)) {
+            formatter.format_to(storage, length, out);
+            return;
+        }
+        
+        std::string result;
+        {
+            detail::StringBuffer buffer(result);
+            pattern.format_to(date, time, buffer);
+        }
+        formatter.format_to(result.data(), result.length(), out);
     }
     
     // datetime Formatter implementations
@@ -664,16 +1509,32 @@ namespace utils {
         return FormatterBase::format(utils::format(m_format, NamedArgument("d", duration.days),
                                                              NamedArgument("h", duration.hours),
                                                              NamedArgument("m", duration.minutes),
-                                                             NamedArgument("s", duration.seconds)));
+                                                             NamedArgument("s", duration.seconds),
                                                              NamedArgument("ms", duration.milliseconds),
                                                              NamedArgument("days", duration.to_days()),
                                                              NamedArgument("hours", duration.to_hours()),
                                                              NamedArgument("minutes", duration.to_minutes()),
                                                              NamedArgument("seconds", duration.to_seconds()),
-                                                             NamedArgument("milliseconds", duration.to_milliseconds());
+                                                             NamedArgument("milliseconds", duration.to_milliseconds())));
     }
     
-    Formatter<Date>::Formatter() : m_format("{month:width=[2],fill=[0],justification=[right]}/{day:width=[2],fill=[0],justification=[right]}/{year}") {
+    std::shared_ptr<const TimestampPattern> default_date_pattern() {
+        static const std::shared_ptr<const TimestampPattern> pattern = std::make_shared<const TimestampPattern>(default_date_format);
+        return pattern;
+    }
+    
+    std::shared_ptr<const TimestampPattern> default_time_pattern() {
+        static const std::shared_ptr<const TimestampPattern> pattern = std::make_shared<const TimestampPattern>(default_time_format);
+        return pattern;
+    }
+    
+    std::shared_ptr<const TimestampPattern> default_timestamp_pattern() {
+        static const std::shared_ptr<const TimestampPattern> pattern = std::make_shared<const TimestampPattern>("{date} {time}");
+        return pattern;
+    }
+    
+    Formatter<Date>::Formatter() : FormatterBase(),
+                                   m_pattern(default_date_pattern()) {
     }
     
     Formatter<Date>::~Formatter() = default;
@@ -682,20 +1543,22 @@ namespace utils {
         ASSERT(spec.type() == FormatSpec::Type::SpecifierList, "format spec for Date types must be a specifier list");
         
         if (spec.has_specifier("format")) {
-            m_format = spec.get_specifier("format");
+            m_pattern = std::make_shared<const TimestampPattern>(spec.get_specifier("format"));
         }
         FormatterBase::parse(spec);
     }
     
     std::string Formatter<Date>::format(const Date& date) const {
-        return FormatterBase::format(utils::format(m_format, NamedArgument("day", date.day),
-                                                             NamedArgument("weekday", date.weekday()),
-                                                             NamedArgument("month", date.month),
-                                                             NamedArgument("year", date.year)));
+        return detail::format_to_string(*this, date);
+    }
+    
+    void Formatter<Date>::format_to(const Date& date, FormatBuffer& out) const {
+        static const Time midnight { 0u, 0u };
+        format_pattern(*this, *m_pattern, date, midnight, out);
     }
     
     Formatter<Time>::Formatter() : FormatterBase(),
-                                   m_format("{hour:width=[2],fill=[0],justification=[right]}:{minute:width=[2],fill=[0],justification=[right]}:{second:width=[2],fill=[0],justification=[right]}:{millisecond:width=[4],fill=[0],justification=[right]}") {
+                                   m_pattern(default_time_pattern()) {
     }
 
     Formatter<Time>::~Formatter() {
@@ -705,21 +1568,23 @@ namespace utils {
         ASSERT(spec.type() == FormatSpec::Type::SpecifierList, "format spec for Time types must be a specifier list");
         
         if (spec.has_specifier("format")) {
-            m_format = spec.get_specifier("format");
+            m_pattern = std::make_shared<const TimestampPattern>(spec.get_specifier("format"));
         }
         
         FormatterBase::parse(spec);
     }
     
     std::string Formatter<Time>::format(const Time& time) const {
-        return FormatterBase::format(utils::format(m_format, NamedArgument("hour", time.hour),
-                                                             NamedArgument("minute", time.minute),
-                                                             NamedArgument("second", time.second),
-                                                             NamedArgument("millisecond", time.millisecond)));
+        return detail::format_to_string(*this, time);
+    }
+    
+    void Formatter<Time>::format_to(const Time& time, FormatBuffer& out) const {
+        static const Date epoch { January, 1u, 1970u };
+        format_pattern(*this, *m_pattern, epoch, time, out);
     }
     
     Formatter<Timestamp>::Formatter() : FormatterBase(),
-                                        m_format("{date} {time}") {
+                                        m_pattern(default_timestamp_pattern()) {
     }
     
     Formatter<Timestamp>::~Formatter() {
@@ -729,23 +1594,18 @@ namespace utils {
         ASSERT(spec.type() == FormatSpec::Type::SpecifierList, "format spec for Timestamp types must be a specifier list");
         
         if (spec.has_specifier("format")) {
-            m_format = spec.get_specifier("format");
+            m_pattern = std::make_shared<const TimestampPattern>(spec.get_specifier("format"));
         }
         
         FormatterBase::parse(spec);
     }
     
     std::string Formatter<Timestamp>::format(const Timestamp& timestamp) const {
-        return FormatterBase::format(utils::format(m_format, NamedArgument("date", timestamp.date),
-                                                             NamedArgument("day", timestamp.date.day),
-                                                             NamedArgument("weekday", timestamp.date.weekday()),
-                                                             NamedArgument("month", timestamp.date.month),
-                                                             NamedArgument("year", timestamp.date.year),
-                                                             NamedArgument("time", timestamp.time),
-                                                             NamedArgument("hour", timestamp.time.hour),
-                                                             NamedArgument("minute", timestamp.time.minute),
-                                                             NamedArgument("second", timestamp.time.second),
-                                                             NamedArgument("millisecond", timestamp.time.millisecond)));
-    }
-    
-}
\ No newline at end of file
+        return detail::format_to_string(*this, timestamp);
+    }
+    
+    void Formatter<Timestamp>::format_to(const Timestamp& timestamp, FormatBuffer& out) const {
+        format_pattern(*this, *m_pattern, timestamp.date, timestamp.time, out);
+    }
+    
+}
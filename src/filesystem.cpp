@@ -1,30 +1,349 @@
 
 #include "utils/filesystem.hpp"
-#include <fstream> // std::ifstream
+#include "utils/exceptions.hpp"
+#include "utils/platform.hpp"
+
+#include <cstring> // std::memchr, std::memmove, std::memcpy
+#include <algorithm> // std::min, std::max
+#include <utility> // std::exchange
+#include <cerrno> // errno, EINTR
+#if defined(PLATFORM_WINDOWS)
+    #include <Windows.h>
+#else
+    #include <unistd.h> // read, close
+    #include <fcntl.h> // open, posix_fadvise
+    #include <sys/mman.h> // mmap, munmap, madvise
+    #include <sys/stat.h> // fstat
+#endif
 
 namespace utils {
 
-    std::string load(const std::filesystem::path& path) {
-        std::ifstream file(path, std::ios::in);
-        if (!file.is_open()) {
-            throw std::runtime_error("");
+    namespace detail {
+
+        // Unbuffered, read-only file handle
+        class ReadableFile {
+            public:
+                // Throws if the file cannot be opened
+                ReadableFile(const std::filesystem::path& path, bool sequential);
+                ~ReadableFile();
+
+                ReadableFile(const ReadableFile& other) = delete;
+                ReadableFile& operator=(const ReadableFile& other) = delete;
+
+                [[nodiscard]] std::size_t size() const;
+
+                // Reads up to 'length' bytes, returns the number of bytes read (0 at the end of the file), throws on failure
+                std::size_t read(char* data, std::size_t length);
+
+                // Reads until either 'length' bytes have been read or the end of the file is reached
+                std::size_t read_all(char* data, std::size_t length);
+
+                #if defined(PLATFORM_WINDOWS)
+                    HANDLE handle;
+                #else
+                    int fd;
+                #endif
+
+            private:
+                std::filesystem::path m_path;
+        };
+
+        ReadableFile::ReadableFile(const std::filesystem::path& path, bool sequential) : m_path(path) {
+            #if defined(PLATFORM_WINDOWS)
+                handle = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr, OPEN_EXISTING, sequential ? FILE_FLAG_SEQUENTIAL_SCAN : FILE_FLAG_RANDOM_ACCESS, nullptr);
+                if (handle == INVALID_HANDLE_VALUE) {
+                    throw FormattedError("failed to open file '{}'", path);
+                }
+            #else
+                fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+                if (fd < 0) {
+                    throw FormattedError("failed to open file '{}'", path);
+                }
+
+                #if defined(PLATFORM_LINUX)
+                    // Increases read-ahead for the file
+                    ::posix_fadvise(fd, 0, 0, sequential ? POSIX_FADV_SEQUENTIAL : POSIX_FADV_RANDOM);
+                #endif
+            #endif
+        }
+
+        ReadableFile::~ReadableFile() {
+            #if defined(PLATFORM_WINDOWS)
+                CloseHandle(handle);
+            #else
+                ::close(fd);
+            #endif
+        }
+
+        std::size_t ReadableFile::size() const {
+            #if defined(PLATFORM_WINDOWS)
+                LARGE_INTEGER size;
+                if (!GetFileSizeEx(handle, &size)) {
+                    throw FormattedError("failed to get the size of file '{}'", m_path);
+                }
+                return static_cast<std::size_t>(size.QuadPart);
+            #else
+                struct stat info;
+                if (::fstat(fd, &info) != 0) {
+                    throw FormattedError("failed to get the size of file '{}'", m_path);
+                }
+                return static_cast<std::size_t>(info.st_size);
+            #endif
         }
 
-        // Get the length of the file
-        file.seekg(0, std::ifstream::end);
-        std::streamsize length = file.tellg();
-        file.seekg(0, std::ifstream::beg);
+        std::size_t ReadableFile::read(char* data, std::size_t length) {
+            #if defined(PLATFORM_WINDOWS)
+                DWORD count;
+                if (!ReadFile(handle, data, static_cast<DWORD>(std::min(length, std::size_t(1u) << 30u)), &count, nullptr)) {
+                    throw FormattedError("failed to read from file '{}'", m_path);
+                }
+                return count;
+            #else
+                while (true) {
+                    // Reads of more than 2 GiB are truncated on Linux
+                    ssize_t count = ::read(fd, data, std::min(length, std::size_t(1u) << 30u));
+                    if (count >= 0) {
+                        return static_cast<std::size_t>(count);
+                    }
+                    if (errno != EINTR) {
+                        throw FormattedError("failed to read from file '{}'", m_path);
+                    }
+                }
+            #endif
+        }
+
+        std::size_t ReadableFile::read_all(char* data, std::size_t length) {
+            std::size_t total = 0u;
+            while (total < length) {
+                std::size_t count = read(data + total, length - total);
+                if (count == 0u) {
+                    break;
+                }
+                total += count;
+            }
+            return total;
+        }
+
+    }
+
+    std::string load(const std::filesystem::path& path) {
+        std::string source = load_binary(path);
 
-        std::string source;
-        source.reserve(length);
+        #if defined(PLATFORM_WINDOWS)
+            // Equivalent to reading the file in text mode
+            std::size_t length = 0u;
+            for (std::size_t i = 0u; i < source.length(); ++i) {
+                if (source[i] == '\r' && i + 1u < source.length() && source[i + 1u] == '\n') {
+                    continue;
+                }
+                source[length++] = source[i];
+            }
+            source.resize(length);
+        #endif
 
-        std::string line;
-        while (std::getline(file, line)) {
-            source += line;
+        if (!source.empty() && source.back() != '\n') {
             source += '\n';
         }
 
-        return std::move(source);
+        return source;
+    }
+
+    std::string load_binary(const std::filesystem::path& path) {
+        detail::ReadableFile file(path, true);
+
+        std::size_t size = file.size();
+
+        // Reserve an extra byte so that load() does not need to reallocate to append a trailing newline
+        std::string contents;
+        contents.reserve(size + 1u);
+        contents.resize(size);
+        contents.resize(file.read_all(contents.data(), size));
+
+        // Files that report a size of 0 (such as those under /proc) are read until the end
+        if (size == 0u) {
+            char chunk[4096];
+            while (std::size_t count = file.read(chunk, sizeof(chunk))) {
+                contents.append(chunk, count);
+            }
+        }
+
+        return contents;
+    }
+
+    MappedFile::MappedFile(const std::filesystem::path& path, Access access) : m_data(nullptr),
+                                                                               m_size(0u)
+                                                                               #if defined(PLATFORM_WINDOWS)
+                                                                                   , m_mapping(nullptr)
+                                                                               #endif
+                                                                               {
+        // The mapping remains valid after the file is closed
+        detail::ReadableFile file(path, access == Access::Sequential);
+
+        m_size = file.size();
+        if (m_size == 0u) {
+            // Empty files cannot be mapped
+            return;
+        }
+
+        #if defined(PLATFORM_WINDOWS)
+            m_mapping = CreateFileMappingW(file.handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+            if (!m_mapping) {
+                throw FormattedError("failed to map file '{}'", path);
+            }
+
+            m_data = static_cast<const char*>(MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0));
+            if (!m_data) {
+                CloseHandle(m_mapping);
+                throw FormattedError("failed to map file '{}'", path);
+            }
+        #else
+            void* data = ::mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, file.fd, 0);
+            if (data == MAP_FAILED) {
+                throw FormattedError("failed to map file '{}'", path);
+            }
+
+            ::madvise(data, m_size, access == Access::Sequential ? MADV_SEQUENTIAL : MADV_RANDOM);
+            m_data = static_cast<const char*>(data);
+        #endif
+    }
+
+    MappedFile::~MappedFile() {
+        unmap();
+    }
+
+    MappedFile::MappedFile(MappedFile&& other) noexcept : m_data(std::exchange(other.m_data, nullptr)),
+                                                          m_size(std::exchange(other.m_size, 0u))
+                                                          #if defined(PLATFORM_WINDOWS)
+                                                              , m_mapping(std::exchange(other.m_mapping, nullptr))
+                                                          #endif
+                                                          {
+    }
+
+    MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+        if (this != &other) {
+            unmap();
+
+            m_data = std::exchange(other.m_data, nullptr);
+            m_size = std::exchange(other.m_size, 0u);
+            #if defined(PLATFORM_WINDOWS)
+                m_mapping = std::exchange(other.m_mapping, nullptr);
+            #endif
+        }
+        return *this;
+    }
+
+    void MappedFile::unmap() {
+        if (!m_data) {
+            return;
+        }
+
+        #if defined(PLATFORM_WINDOWS)
+            UnmapViewOfFile(m_data);
+            CloseHandle(m_mapping);
+            m_mapping = nullptr;
+        #else
+            ::munmap(const_cast<char*>(m_data), m_size);
+        #endif
+
+        m_data = nullptr;
+        m_size = 0u;
+    }
+
+    std::string_view MappedFile::contents() const {
+        return { m_data, m_size };
+    }
+
+    std::size_t MappedFile::size() const {
+        return m_size;
+    }
+
+    bool MappedFile::empty() const {
+        return m_size == 0u;
+    }
+
+    FileReader::FileReader(const std::filesystem::path& path, std::size_t chunk_size) : m_file(std::make_unique<detail::ReadableFile>(path, true)),
+                                                                                        m_buffer(nullptr),
+                                                                                        m_capacity(0u),
+                                                                                        m_chunk_size(std::max(chunk_size, std::size_t(1u))),
+                                                                                        m_position(0u),
+                                                                                        m_size(0u),
+                                                                                        m_eof(false) {
+    }
+
+    FileReader::~FileReader() = default;
+
+    bool FileReader::next_line(std::string_view& line) {
+        // Lines are only searched for in data that has not been scanned before
+        std::size_t scanned = m_position;
+
+        while (true) {
+            const char* data = m_buffer.get();
+            const void* newline = m_size > scanned ? std::memchr(data + scanned, '\n', m_size - scanned) : nullptr;
+
+            if (newline) {
+                std::size_t end = static_cast<const char*>(newline) - data;
+
+                line = std::string_view(data + m_position, end - m_position);
+                if (!line.empty() && line.back() == '\r') {
+                    line.remove_suffix(1u);
+                }
+
+                m_position = end + 1u;
+                return true;
+            }
+
+            scanned = m_size;
+            std::size_t unprocessed = m_size - m_position;
+
+            if (m_eof || !fill()) {
+                if (unprocessed == 0u) {
+                    return false;
+                }
+
+                // Last line is not terminated by a newline
+                line = std::string_view(m_buffer.get() + m_position, unprocessed);
+                if (line.back() == '\r') {
+                    line.remove_suffix(1u);
+                }
+
+                m_position = m_size;
+                return true;
+            }
+
+            // fill() moves unprocessed data to the front of the buffer
+            scanned = unprocessed;
+        }
+    }
+
+    bool FileReader::fill() {
+        std::size_t unprocessed = m_size - m_position;
+
+        if (unprocessed + m_chunk_size > m_capacity) {
+            // Only grows past the chunk size if a line does not fit into a single chunk
+            std::size_t capacity = std::max(m_capacity * 2u, unprocessed + m_chunk_size);
+            std::unique_ptr<char[]> buffer(new char[capacity]);
+            if (unprocessed) {
+                std::memcpy(buffer.get(), m_buffer.get() + m_position, unprocessed);
+            }
+
+            m_buffer = std::move(buffer);
+            m_capacity = capacity;
+        }
+        else if (unprocessed && m_position) {
+            std::memmove(m_buffer.get(), m_buffer.get() + m_position, unprocessed);
+        }
+
+        m_position = 0u;
+        m_size = unprocessed;
+
+        std::size_t count = m_file->read(m_buffer.get() + m_size, m_capacity - m_size);
+        if (count == 0u) {
+            m_eof = true;
+            return false;
+        }
+
+        m_size += count;
+        return true;
     }
 
-}
\ No newline at end of file
+}
@@ -7,15 +7,117 @@
 
 #include <source_location>
 #include <iostream>
+#include <memory_resource> // std::pmr::unsynchronized_pool_resource, std::pmr::monotonic_buffer_resource
+#include <atomic> // std::atomic, std::atomic_thread_fence
+#include <thread> // std::thread, std::this_thread::yield
+#include <bit> // std::bit_ceil
+#include <deque> // std::deque
+#include <unordered_map> // std::unordered_map
+#include <variant> // std::variant, std::monostate
+#include <condition_variable> // std::condition_variable
+#include <chrono> // std::chrono::steady_clock
+#include <cerrno> // errno, EINTR
+#include <climits> // IOV_MAX
+#include <optional> // std::optional
+#include <limits> // std::numeric_limits
 #if defined(PLATFORM_WINDOWS)
     #include <Windows.h>
 #else
-    #include <unistd.h> // getpid
+    #include <unistd.h> // getpid, close, fsync, fdatasync
+    #include <pthread.h> // pthread_atfork
+    #include <fcntl.h> // open
+    #include <sys/uio.h> // writev, iovec
 #endif
 
 namespace utils {
     namespace logging {
         
+        // Bounded multi-producer, multi-consumer queue of messages (Dmitry Vyukov's bounded MPMC queue)
+        // Each slot carries a sequence number that tells producers and consumers whether the slot is ready to be written / read, so neither side takes a lock
+        class AsyncQueue {
+            public:
+                AsyncQueue(std::size_t capacity, OverflowPolicy policy);
+                ~AsyncQueue();
+                
+                // Copies 'message' into the queue, applying the overflow policy if the queue is full
+                // Returns false if the queue has been stopped (including while blocked on a full queue), in which case the message was not enqueued and should be written out by the caller
+                [[nodiscard]] bool push(const Message& message);
+                
+                // Invokes 'fn' with the oldest message in the queue, returns false if the queue is empty
+                // 'progress' is used by flush() to determine whether the consumer is still processing a message older than the flush request
+                template <typename Fn>
+                bool pop(std::atomic<std::size_t>& progress, Fn&& fn);
+                
+                // Total number of positions claimed by producers so far
+                [[nodiscard]] std::size_t get_enqueue_position() const;
+                [[nodiscard]] std::size_t get_dequeue_position() const;
+                [[nodiscard]] std::size_t get_dropped_message_count() const;
+                
+                // Blocks the calling (background) thread until a message is pushed or the queue is stopped
+                void wait();
+                
+                void stop();
+                [[nodiscard]] bool stopped() const;
+                
+                // Blocks until all producers that entered push() before the queue was stopped have left it
+                // Once this returns, no more messages are pushed into the queue
+                void wait_for_producers() const;
+                
+            private:
+                struct Slot {
+                    Slot();
+                    
+                    std::atomic<std::size_t> sequence;
+                    
+                    // Message contents are copied into storage owned by the slot, which is reused once the capacity of each string has grown large enough
+                    Message::Level level;
+                    std::string format;
+                    std::source_location source;
+                    Clock::time_point timestamp;
+                    std::string message;
+                    std::thread::id thread_id;
+                    
+                    #if defined(PLATFORM_WINDOWS)
+                        DWORD process_id;
+                    #else
+                        pid_t process_id;
+                    #endif
+                    
+                    std::vector<std::string> scope;
+                    std::vector<std::string_view> scope_views; // References 'scope'
+                };
+                
+                // Returns the slot for the claimed position, or nullptr if the queue is empty
+                Slot* claim(std::size_t& position);
+                void release(Slot* slot, std::size_t position);
+                
+                bool try_push(const Message& message);
+                
+                // Applies the overflow policy until the message is enqueued or discarded, returns false if the queue was stopped first
+                bool enqueue(const Message& message);
+                void notify();
+                
+                std::unique_ptr<Slot[]> m_slots;
+                std::size_t m_mask;
+                OverflowPolicy m_policy;
+                
+                // Producers and consumers operate on separate cache lines
+                alignas(64) std::atomic<std::size_t> m_enqueue_position;
+                alignas(64) std::atomic<std::size_t> m_dequeue_position;
+                
+                alignas(64) std::atomic<std::size_t> m_dropped;
+                std::atomic<std::uint32_t> m_signal; // Incremented to wake up sleeping consumers
+                std::atomic<std::uint32_t> m_num_waiting; // Number of sleeping consumers, producers skip notifying if there are none
+                std::atomic<bool> m_stopped;
+                std::atomic<std::size_t> m_producers; // Number of threads inside push()
+        };
+        
+        // Immutable snapshot of the registered sinks
+        struct SinkList {
+            std::vector<std::shared_ptr<Sink>> sinks;
+            std::unordered_map<std::string_view, std::shared_ptr<Sink>> names; // Keys reference the names owned by the sinks
+        };
+        
         class Logger {
             public:
                 static Logger& instance();
@@ -28,16 +130,56 @@ namespace utils {
                 [[nodiscard]] std::shared_ptr<Sink> get_sink(std::string_view name);
                 void remove_sink(std::string_view name);
                 
+                // Recomputes the lowest level across all enabled sinks
+                void refresh_level();
+                
                 void log(Message& message);
+                void log(const detail::BinaryRecord& record);
+                
+                void enable_async(std::size_t capacity, OverflowPolicy policy, std::size_t num_workers);
+                void disable_async();
+                void flush();
+                [[nodiscard]] std::size_t get_dropped_message_count();
                 
             private:
                 Logger();
                 
+                // Publishes 'sinks' as the new snapshot of registered sinks
+                // Expects m_sink_lock to be held
+                void update_sinks(std::vector<std::shared_ptr<Sink>> sinks);
+                
+                // Expects m_sink_lock to be held
+                void update_level(const SinkList& list);
+                
+                // Writes 'message' out to all sinks
+                void dispatch(const Message& message);
+                void run(AsyncQueue& queue, std::atomic<std::size_t>& progress);
+                
+                // Expects m_async_lock to be held
+                void stop_async();
+                
                 std::mutex m_format_lock;
                 std::string m_format;
                 
+                // Logging threads read the current snapshot without locking, so that a slow sink does not hold up threads that are registering or looking up sinks
+                // Modifications copy the snapshot and publish the modified copy, which are serialized by m_sink_lock
+                // Sinks removed while a message is being written remain alive until all threads have released the snapshot that references them
                 std::mutex m_sink_lock;
-                std::vector<std::shared_ptr<Sink>> m_sinks;
+                std::atomic<std::shared_ptr<const SinkList>> m_sinks;
+                
+                // Serializes enabling / disabling asynchronous mode
+                std::mutex m_async_lock;
+                
+                // Queue for asynchronous mode, nullptr if logging is synchronous
+                std::atomic<AsyncQueue*> m_queue;
+                
+                // Queues are kept alive until the logger is destroyed, as producers may still hold a reference to a queue after asynchronous mode is disabled
+                std::vector<std::unique_ptr<AsyncQueue>> m_queues;
+                
+                std::vector<std::thread> m_workers;
+                
+                // Progress of each background thread, encoded as (position << 1 | 1) while the thread is processing a message and 0 while it is idle
+                std::unique_ptr<std::atomic<std::size_t>[]> m_progress;
         };
         
         struct ConsoleSink : public Sink {
@@ -51,29 +193,483 @@ namespace utils {
             FILE* file;
         };
         
-        thread_local std::vector<std::string> scopes;
+        // Assigns IDs to unique combinations of a format string and a source location for messages logged in deferred mode
+        class FormatRegistry {
+            public:
+                static FormatRegistry& instance();
+                
+                [[nodiscard]] std::uint32_t get_id(std::string_view format, const std::source_location& source);
+                
+                // Returns the serialized format record for 'id'
+                [[nodiscard]] std::string_view get_record(std::uint32_t id);
+                
+            private:
+                FormatRegistry();
+                
+                std::mutex m_lock;
+                std::unordered_map<std::string, std::uint32_t> m_ids;
+                
+                // Elements of a std::deque are never relocated, so views of the records remain valid as new formats are registered
+                std::deque<std::pmr::string> m_records;
+                std::deque<std::string> m_formats;
+        };
+        
+        namespace detail {
+            
+            class RenderCache {
+                public:
+                    explicit RenderCache(std::pmr::memory_resource* resource);
+                    
+                    // Returns the line rendered for 'layout', which is only rendered if no layout with the same format string has been rendered before
+                    // Note: the result is invalidated by the next call to render(...)
+                    std::string_view render(const SinkLayout& layout, const Message& message);
+                    
+                private:
+                    struct Entry {
+                        std::pmr::string format; // Copied, as the layout of a sink may be replaced once the lock of the sink is released
+                        std::pmr::string line;
+                    };
+                    
+                    std::pmr::memory_resource* m_resource;
+                    std::pmr::vector<Entry> m_entries;
+            };
+            
+            // Unbuffered handle to a file opened for appending
+            class AppendFile {
+                public:
+                    AppendFile();
+                    ~AppendFile();
+                    
+                    AppendFile(const AppendFile& other) = delete;
+                    AppendFile& operator=(const AppendFile& other) = delete;
+                    
+                    // Returns false if the file could not be opened
+                    bool open(const std::filesystem::path& filepath, bool truncate);
+                    void close();
+                    [[nodiscard]] bool is_open() const;
+                    
+                    // Writes 'buffers' out in order, with as few system calls as possible
+                    // Returns false if not all data could be written
+                    bool write(std::span<const std::string> buffers);
+                    
+                    void sync();
+                    
+                private:
+                    #if defined(PLATFORM_WINDOWS)
+                        HANDLE m_handle;
+                    #else
+                        int m_fd;
+                    #endif
+            };
+            
+            class FileWriter {
+                public:
+                    FileWriter(std::filesystem::path filepath, FileSink::Options options);
+                    ~FileWriter(); // Writes out all buffered messages
+                    
+                    void write(std::string_view message);
+                    
+                    // Blocks until all messages written before the call are written out (and synced, depending on the sync policy)
+                    void flush();
+                    
+                private:
+                    // Moves the active buffer to the list of buffers pending to be written out
+                    // Expects m_lock to be held
+                    void submit();
+                    
+                    void run();
+                    
+                    // Renames the current file and opens a new one in its place
+                    void rotate();
+                    
+                    // Returns the path of the rotated file with the given index
+                    [[nodiscard]] std::filesystem::path get_rotated_path(std::size_t index) const;
+                    
+                    std::filesystem::path m_filepath;
+                    FileSink::Options m_options;
+                    
+                    // Accessed only by the background thread once the writer is constructed
+                    AppendFile m_file;
+                    std::size_t m_file_size;
+                    std::chrono::steady_clock::time_point m_rotation_time; // Time at which the file is rotated next
+                    std::size_t m_rotation_index; // Index of the next rotated file
+                    
+                    std::mutex m_lock;
+                    std::condition_variable m_work; // Signaled when there is work for the background thread
+                    std::condition_variable m_done; // Signaled when the background thread finishes writing out a batch of buffers
+                    
+                    std::string m_buffer;
+                    std::chrono::steady_clock::time_point m_buffer_time; // Time at which the first message was appended to the active buffer
+                    
+                    std::vector<std::string> m_pending;
+                    std::vector<std::string> m_free; // Buffers that have been written out, kept to reuse their storage
+                    
+                    std::size_t m_flush_requested;
+                    std::size_t m_flush_completed;
+                    bool m_stopped;
+                    
+                    std::thread m_thread;
+            };
+            
+        }
+        
+        // Per-thread cache of format IDs, so that the registry is only locked the first time a thread logs from a given location
+        struct FormatCacheEntry {
+            std::string_view format; // References the copy of the format string owned by the registry
+            const char* filename;
+            std::uint32_t line;
+            std::uint32_t column;
+            std::uint32_t id;
+        };
+        
+        // Names of the active scopes, which reference either static storage (scopes pushed with push_scope_view) or 'owned_scopes'
+        thread_local std::vector<std::string_view> scopes;
+        thread_local std::deque<std::string> owned_scopes; // Elements do not move when the deque grows
+        thread_local const std::thread::id thread_id = std::this_thread::get_id();
+        
+        // Process ID is read once instead of for every message (getpid() is a system call)
+        decltype(Message::process_id) get_process_id() {
+            #if defined(PLATFORM_WINDOWS)
+                static const DWORD id = GetCurrentProcessId();
+            #else
+                // Refreshed in the child process after a fork
+                static pid_t id = []() {
+                    pthread_atfork(nullptr, nullptr, []() {
+                        id = getpid();
+                    });
+                    return getpid();
+                }();
+            #endif
+            return id;
+        }
+        thread_local FormatCacheEntry format_cache[64] { };
+        
+        std::atomic<bool> deferred_formatting { false };
+        
+        // Backing storage for detail::MessageArena
+        // Blocks allocated by the monotonic arena once the initial buffer is exhausted are returned to (and reused from) the pool, which keeps them for the lifetime of the thread
+        struct MessageArenaStorage {
+            MessageArenaStorage();
+            
+            alignas(std::max_align_t) char buffer[2048];
+            std::pmr::unsynchronized_pool_resource pool;
+            std::pmr::monotonic_buffer_resource arena;
+            std::size_t depth; // Number of active MessageArena instances on this thread
+        };
+        
+        thread_local MessageArenaStorage message_arena;
+        
+        AsyncQueue::Slot::Slot() : sequence(0u),
+                                   level(Message::Level::Debug),
+                                   format(),
+                                   source(),
+                                   timestamp(),
+                                   message(),
+                                   thread_id(),
+                                   process_id(),
+                                   scope(),
+                                   scope_views() {
+        }
+        
+        AsyncQueue::AsyncQueue(std::size_t capacity, OverflowPolicy policy) : m_slots(),
+                                                                              m_mask(std::bit_ceil(std::max(capacity, std::size_t(2u))) - 1u),
+                                                                              m_policy(policy),
+                                                                              m_enqueue_position(0u),
+                                                                              m_dequeue_position(0u),
+                                                                              m_dropped(0u),
+                                                                              m_signal(0u),
+                                                                              m_num_waiting(0u),
+                                                                              m_stopped(false),
+                                                                              m_producers(0u) {
+            m_slots = std::make_unique<Slot[]>(m_mask + 1u);
+            
+            // Slot i is ready to be written at position i
+            for (std::size_t i = 0u; i <= m_mask; ++i) {
+                m_slots[i].sequence.store(i, std::memory_order_relaxed);
+            }
+        }
+        
+        AsyncQueue::~AsyncQueue() = default;
+        
+        bool AsyncQueue::try_push(const Message& message) {
+            std::size_t position = m_enqueue_position.load(std::memory_order_relaxed);
+            Slot* slot;
+            
+            while (true) {
+                slot = &m_slots[position & m_mask];
+                std::size_t sequence = slot->sequence.load(std::memory_order_acquire);
+                std::ptrdiff_t difference = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(position);
+                
+                if (difference == 0) {
+                    if (m_enqueue_position.compare_exchange_weak(position, position + 1u, std::memory_order_relaxed)) {
+                        break;
+                    }
+                }
+                else if (difference < 0) {
+                    // Slot has not been consumed since the last lap, queue is full
+                    return false;
+                }
+                else {
+                    // Another producer claimed this position
+                    position = m_enqueue_position.load(std::memory_order_relaxed);
+                }
+            }
+            
+            slot->level = message.level;
+            slot->format.assign(message.format);
+            slot->source = message.source;
+            slot->timestamp = message.timestamp;
+            slot->message.assign(message.message);
+            slot->thread_id = message.thread_id;
+            slot->process_id = message.process_id;
+            
+            if (slot->scope.size() > message.scope.size()) {
+                slot->scope.resize(message.scope.size());
+            }
+            for (std::size_t i = 0u; i < message.scope.size(); ++i) {
+                if (i < slot->scope.size()) {
+                    slot->scope[i].assign(message.scope[i]);
+                }
+                else {
+                    slot->scope.emplace_back(message.scope[i]);
+                }
+            }
+            
+            // Views are only taken once all strings are in place, as growing the vector may move them
+            slot->scope_views.assign(slot->scope.begin(), slot->scope.end());
+            
+            // Publish the message to consumers
+            slot->sequence.store(position + 1u, std::memory_order_release);
+            return true;
+        }
+        
+        bool AsyncQueue::push(const Message& message) {
+            // Producers announce themselves before checking whether the queue has been stopped, and stop() sets the flag before waiting for producers to leave
+            // Either the producer observes the flag, or wait_for_producers() observes the producer (both sides use sequentially consistent operations)
+            m_producers.fetch_add(1u, std::memory_order_seq_cst);
+            bool pushed = !m_stopped.load(std::memory_order_seq_cst) && enqueue(message);
+            m_producers.fetch_sub(1u, std::memory_order_release);
+            return pushed;
+        }
+        
+        bool AsyncQueue::enqueue(const Message& message) {
+            while (!try_push(message)) {
+                switch (m_policy) {
+                    case OverflowPolicy::Block:
+                        // Background threads exit once the queue is stopped, nothing would make room
+                        if (m_stopped.load(std::memory_order_seq_cst)) {
+                            return false;
+                        }
+                        std::this_thread::yield();
+                        break;
+                    case OverflowPolicy::DropNewest:
+                        m_dropped.fetch_add(1u, std::memory_order_relaxed);
+                        return true;
+                    case OverflowPolicy::OverwriteOldest: {
+                        // Consume the oldest message in place of a background thread
+                        std::size_t position;
+                        if (Slot* slot = claim(position)) {
+                            release(slot, position);
+                            m_dropped.fetch_add(1u, std::memory_order_relaxed);
+                        }
+                        break;
+                    }
+                }
+            }
+            
+            notify();
+            return true;
+        }
+        
+        AsyncQueue::Slot* AsyncQueue::claim(std::size_t& position) {
+            position = m_dequeue_position.load(std::memory_order_relaxed);
+            
+            while (true) {
+                Slot* slot = &m_slots[position & m_mask];
+                std::size_t sequence = slot->sequence.load(std::memory_order_acquire);
+                std::ptrdiff_t difference = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(position + 1u);
+                
+                if (difference == 0) {
+                    if (m_dequeue_position.compare_exchange_weak(position, position + 1u, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+                        return slot;
+                    }
+                }
+                else if (difference < 0) {
+                    // Slot has not been written to yet, queue is empty
+                    return nullptr;
+                }
+                else {
+                    position = m_dequeue_position.load(std::memory_order_relaxed);
+                }
+            }
+        }
+        
+        void AsyncQueue::release(Slot* slot, std::size_t position) {
+            // Slot is ready to be written to on the next lap
+            slot->sequence.store(position + m_mask + 1u, std::memory_order_release);
+        }
+        
+        template <typename Fn>
+        bool AsyncQueue::pop(std::atomic<std::size_t>& progress, Fn&& fn) {
+            std::size_t position = m_dequeue_position.load(std::memory_order_relaxed);
+            
+            // Conservatively mark the thread as busy with the current position before attempting to claim it
+            // A flush() that observes the claim is guaranteed to also observe the mark, and waits for the message to be processed
+            progress.store((position << 1u) | 1u, std::memory_order_seq_cst);
+            
+            Slot* slot = claim(position);
+            if (!slot) {
+                progress.store(0u, std::memory_order_release);
+                return false;
+            }
+            
+            Message message { std::string_view(slot->format), slot->source };
+            message.level = slot->level;
+            message.timestamp = slot->timestamp;
+            message.message = slot->message;
+            message.thread_id = slot->thread_id;
+            message.process_id = slot->process_id;
+            message.scope = slot->scope_views;
+            
+            fn(message);
+            
+            release(slot, position);
+            progress.store(0u, std::memory_order_release);
+            return true;
+        }
+        
+        std::size_t AsyncQueue::get_enqueue_position() const {
+            return m_enqueue_position.load(std::memory_order_seq_cst);
+        }
+        
+        std::size_t AsyncQueue::get_dequeue_position() const {
+            return m_dequeue_position.load(std::memory_order_seq_cst);
+        }
+        
+        std::size_t AsyncQueue::get_dropped_message_count() const {
+            return m_dropped.load(std::memory_order_relaxed);
+        }
+        
+        void AsyncQueue::notify() {
+            // Pairs with the fence in wait(): either the consumer observes the new message before going to sleep, or the producer observes the sleeping consumer
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (m_num_waiting.load(std::memory_order_relaxed)) {
+                m_signal.fetch_add(1u, std::memory_order_release);
+                m_signal.notify_all();
+            }
+        }
+        
+        void AsyncQueue::wait() {
+            std::uint32_t signal = m_signal.load(std::memory_order_acquire);
+            m_num_waiting.fetch_add(1u, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            
+            std::size_t position = m_dequeue_position.load(std::memory_order_relaxed);
+            bool empty = m_slots[position & m_mask].sequence.load(std::memory_order_acquire) != position + 1u;
+            
+            if (empty && !m_stopped.load(std::memory_order_acquire)) {
+                m_signal.wait(signal, std::memory_order_acquire);
+            }
+            
+            m_num_waiting.fetch_sub(1u, std::memory_order_relaxed);
+        }
+        
+        void AsyncQueue::stop() {
+            m_stopped.store(true, std::memory_order_seq_cst);
+            m_signal.fetch_add(1u, std::memory_order_release);
+            m_signal.notify_all();
+        }
+        
+        bool AsyncQueue::stopped() const {
+            return m_stopped.load(std::memory_order_acquire);
+        }
+        
+        void AsyncQueue::wait_for_producers() const {
+            while (m_producers.load(std::memory_order_seq_cst) != 0u) {
+                std::this_thread::yield();
+            }
+        }
+        
+        FormatRegistry& FormatRegistry::instance() {
+            static FormatRegistry instance { };
+            return instance;
+        }
+        
+        FormatRegistry::FormatRegistry() = default;
+        
+        std::uint32_t FormatRegistry::get_id(std::string_view format, const std::source_location& source) {
+            std::uint32_t line = source.line();
+            std::uint32_t column = source.column();
+            
+            // Format strings are typically string literals, which makes the address of the format string a good hash for the call site
+            FormatCacheEntry& entry = format_cache[((reinterpret_cast<std::uintptr_t>(format.data()) >> 3u) ^ line) & 63u];
+            if (entry.filename == source.file_name() && entry.line == line && entry.column == column && entry.format == format) {
+                return entry.id;
+            }
+            
+            std::string key;
+            key.reserve(format.length() + 64u);
+            key.append(format);
+            key.push_back('\0');
+            key.append(source.file_name());
+            key.push_back('\0');
+            key.append(std::to_string(line));
+            key.push_back(':');
+            key.append(std::to_string(column));
+            
+            std::lock_guard guard { m_lock };
+            
+            auto [iter, inserted] = m_ids.try_emplace(std::move(key), static_cast<std::uint32_t>(m_records.size()));
+            std::uint32_t id = iter->second;
+            
+            if (inserted) {
+                std::pmr::string& record = m_records.emplace_back();
+                detail::write_value(record, detail::RecordType::Format);
+                detail::write_value(record, std::uint32_t(0u));
+                detail::write_value(record, id);
+                detail::write_value(record, line);
+                detail::write_value(record, column);
+                detail::write_string(record, format);
+                detail::write_string(record, source.file_name());
+                detail::write_string(record, source.function_name());
+                
+                std::uint32_t size = static_cast<std::uint32_t>(record.length() - sizeof(detail::RecordType) - sizeof(std::uint32_t));
+                std::memcpy(record.data() + sizeof(detail::RecordType), &size, sizeof(size));
+                
+                m_formats.emplace_back(format);
+            }
+            
+            entry = FormatCacheEntry { m_formats[id], source.file_name(), line, column, id };
+            return id;
+        }
+        
+        std::string_view FormatRegistry::get_record(std::uint32_t id) {
+            std::lock_guard guard { m_lock };
+            return m_records[id];
+        }
         
         Logger& Logger::instance() {
             static Logger instance { };
             return instance;
         }
         
-        Logger::Logger() : m_format("[{level}] {message}") {
+        Logger::Logger() : m_format("[{level}] {message}"),
+                           m_queue(nullptr) {
             std::scoped_lock guard { m_format_lock, m_sink_lock };
             
             // Create standard output (stdout) and standard error (stderr) sinks
             std::shared_ptr<Sink> out = std::make_shared<ConsoleSink>(stdout);
             out->set_format(m_format);
             
-            m_sinks.emplace_back(out);
-            
             std::shared_ptr<Sink> err = std::make_shared<ConsoleSink>(stderr);
             err->set_format(m_format);
             
-            m_sinks.emplace_back(err);
+            update_sinks({ out, err });
         }
         
-        Logger::~Logger() = default;
+        Logger::~Logger() {
+            disable_async();
+        }
 
         void Logger::set_default_format(std::string format) {
             std::lock_guard guard { m_format_lock };
@@ -87,52 +683,213 @@ namespace utils {
         
         void Logger::add_sink(const std::shared_ptr<Sink>& sink) {
             std::lock_guard guard { m_sink_lock };
+            std::shared_ptr<const SinkList> list = m_sinks.load(std::memory_order_acquire);
             
             // Do not add multiple sinks with the same name
-            for (const std::shared_ptr<Sink>& s : m_sinks) {
-                if (s->get_name() == sink->get_name()) {
-                    return;
-                }
+            if (list->names.contains(sink->get_name())) {
+                return;
             }
             
-            m_sinks.emplace_back(sink);
+            std::vector<std::shared_ptr<Sink>> sinks = list->sinks;
+            sinks.emplace_back(sink);
+            update_sinks(std::move(sinks));
         }
         
         std::shared_ptr<Sink> Logger::get_sink(std::string_view name) {
+            std::shared_ptr<const SinkList> list = m_sinks.load(std::memory_order_acquire);
+            
+            auto iter = list->names.find(name);
+            if (iter == list->names.end()) {
+                return nullptr;
+            }
+            return iter->second;
+        }
+        
+        void Logger::remove_sink(std::string_view name) {
             std::lock_guard guard { m_sink_lock };
+            std::shared_ptr<const SinkList> list = m_sinks.load(std::memory_order_acquire);
+            
+            if (!list->names.contains(name)) {
+                return;
+            }
             
-            for (const std::shared_ptr<Sink>& sink : m_sinks) {
-                if (sink->get_name() == name) {
-                    return sink;
+            std::vector<std::shared_ptr<Sink>> sinks;
+            sinks.reserve(list->sinks.size() - 1u);
+            for (const std::shared_ptr<Sink>& sink : list->sinks) {
+                if (sink->get_name() != name) {
+                    sinks.emplace_back(sink);
                 }
             }
-            return nullptr;
+            
+            update_sinks(std::move(sinks));
         }
         
-        void Logger::remove_sink(std::string_view name) {
+        void Logger::refresh_level() {
             std::lock_guard guard { m_sink_lock };
+            update_level(*m_sinks.load(std::memory_order_acquire));
+        }
+        
+        void Logger::update_sinks(std::vector<std::shared_ptr<Sink>> sinks) {
+            std::shared_ptr<SinkList> list = std::make_shared<SinkList>();
+            list->sinks = std::move(sinks);
             
-            for (auto iter = m_sinks.begin(); iter != m_sinks.end(); ++iter) {
-                if ((*iter)->get_name() == name) {
-                    m_sinks.erase(iter);
-                    break;
+            list->names.reserve(list->sinks.size());
+            for (const std::shared_ptr<Sink>& sink : list->sinks) {
+                list->names.emplace(sink->get_name(), sink);
+            }
+            
+            update_level(*list);
+            m_sinks.store(std::move(list), std::memory_order_release);
+        }
+        
+        void Logger::update_level(const SinkList& list) {
+            // Start above the highest level, which rejects all messages if no sinks are enabled
+            std::uint8_t level = static_cast<std::uint8_t>(Message::Level::Error) + 1u;
+            for (const std::shared_ptr<Sink>& sink : list.sinks) {
+                if (sink->is_enabled()) {
+                    level = std::min(level, static_cast<std::uint8_t>(sink->get_level()));
                 }
             }
+            detail::min_enabled_level.store(level, std::memory_order_relaxed);
         }
         
         void Logger::log(Message& message) {
-            message.thread_id = std::this_thread::get_id();
-            #if defined(PLATFORM_WINDOWS)
-                message.process_id = GetCurrentProcessId();
-            #else
-                message.process_id = getpid();
-            #endif
+            message.thread_id = thread_id;
+            message.process_id = get_process_id();
             message.scope = scopes;
             
-            std::lock_guard guard { m_sink_lock };
-            for (std::shared_ptr<Sink>& sink : m_sinks) {
-                sink->log(message);
+            // Messages are written out synchronously if the queue was stopped before the message could be enqueued
+            AsyncQueue* queue = m_queue.load(std::memory_order_acquire);
+            if (queue && queue->push(message)) {
+                return;
+            }
+            
+            dispatch(message);
+        }
+        
+        void Logger::log(const detail::BinaryRecord& record) {
+            std::shared_ptr<const SinkList> list = m_sinks.load(std::memory_order_acquire);
+            for (const std::shared_ptr<Sink>& sink : list->sinks) {
+                sink->log(record);
+            }
+        }
+        
+        void Logger::dispatch(const Message& message) {
+            detail::MessageArena arena;
+            detail::RenderCache cache { arena.resource() };
+            
+            std::shared_ptr<const SinkList> list = m_sinks.load(std::memory_order_acquire);
+            for (const std::shared_ptr<Sink>& sink : list->sinks) {
+                sink->log(message, cache);
+            }
+        }
+        
+        void Logger::run(AsyncQueue& queue, std::atomic<std::size_t>& progress) {
+            auto write = [this](const Message& message) {
+                dispatch(message);
+            };
+            
+            while (true) {
+                if (queue.pop(progress, write)) {
+                    continue;
+                }
+                
+                // Queue is empty, pending messages have been written out
+                if (queue.stopped()) {
+                    break;
+                }
+                
+                queue.wait();
+            }
+        }
+        
+        void Logger::enable_async(std::size_t capacity, OverflowPolicy policy, std::size_t num_workers) {
+            std::lock_guard guard { m_async_lock };
+            
+            // Restart with the new configuration if asynchronous mode is already enabled
+            stop_async();
+            
+            if (num_workers == 0u) {
+                num_workers = 1u;
+            }
+            
+            std::unique_ptr<AsyncQueue>& queue = m_queues.emplace_back(std::make_unique<AsyncQueue>(capacity, policy));
+            
+            m_progress = std::make_unique<std::atomic<std::size_t>[]>(num_workers);
+            for (std::size_t i = 0u; i < num_workers; ++i) {
+                m_progress[i].store(0u, std::memory_order_relaxed);
+                m_workers.emplace_back(&Logger::run, this, std::ref(*queue), std::ref(m_progress[i]));
+            }
+            
+            m_queue.store(queue.get(), std::memory_order_release);
+        }
+        
+        void Logger::disable_async() {
+            std::lock_guard guard { m_async_lock };
+            stop_async();
+        }
+        
+        void Logger::stop_async() {
+            AsyncQueue* queue = m_queue.exchange(nullptr, std::memory_order_acq_rel);
+            if (!queue) {
+                return;
+            }
+            
+            // Background threads write out all pending messages before exiting
+            queue->stop();
+            for (std::thread& worker : m_workers) {
+                worker.join();
+            }
+            m_workers.clear();
+            m_progress.reset();
+            
+            // Write out messages pushed by producers that loaded the queue before it was retired
+            // Producers that have not enqueued their message by the time the queue is stopped write it out themselves
+            queue->wait_for_producers();
+            std::atomic<std::size_t> progress { 0u };
+            while (queue->pop(progress, [this](const Message& message) { dispatch(message); })) {
+            }
+        }
+        
+        void Logger::flush() {
+            {
+                std::lock_guard guard { m_async_lock };
+                
+                if (AsyncQueue* queue = m_queue.load(std::memory_order_relaxed)) {
+                    std::size_t target = queue->get_enqueue_position();
+                    
+                    while (true) {
+                        // All messages before the target position have been claimed by a background thread (or discarded) ...
+                        bool done = queue->get_dequeue_position() >= target;
+                        
+                        // ... and no background thread is still processing one of them
+                        for (std::size_t i = 0u; done && i < m_workers.size(); ++i) {
+                            std::size_t progress = m_progress[i].load(std::memory_order_seq_cst);
+                            done = !(progress & 1u) || (progress >> 1u) >= target;
+                        }
+                        
+                        if (done) {
+                            break;
+                        }
+                        std::this_thread::yield();
+                    }
+                }
             }
+            
+            std::shared_ptr<const SinkList> list = m_sinks.load(std::memory_order_acquire);
+            for (const std::shared_ptr<Sink>& sink : list->sinks) {
+                sink->flush();
+            }
+        }
+        
+        std::size_t Logger::get_dropped_message_count() {
+            std::lock_guard guard { m_async_lock };
+            
+            std::size_t count = 0u;
+            for (const std::unique_ptr<AsyncQueue>& queue : m_queues) {
+                count += queue->get_dropped_message_count();
+            }
+            return count;
         }
         
         // Sink format string is set later to avoid a deadlock with Logger initialization
@@ -211,88 +968,242 @@ namespace utils {
             ConsoleSink::flush();
         }
         
-        Message::Message(const std::string& fmt, std::source_location source) : level(Level::Debug),
-                                                                                format(fmt),
-                                                                                source(source),
-                                                                                message(),
-                                                                                timestamp(Timestamp::now()) {
+        MessageArenaStorage::MessageArenaStorage() : buffer(),
+                                                     pool(),
+                                                     arena(buffer, sizeof(buffer), &pool),
+                                                     depth(0u) {
         }
         
-        Message::Message(std::string_view fmt, std::source_location source) : level(Level::Debug),
-                                                                              format(fmt),
-                                                                              source(source),
-                                                                              message(),
-                                                                              timestamp(Timestamp::now()) {
+        namespace detail {
+            
+            MessageArena::MessageArena() {
+                ++message_arena.depth;
+            }
+            
+            MessageArena::~MessageArena() {
+                // Messages logged while formatting another message (nested calls) share the arena of the outermost message
+                if (--message_arena.depth == 0u) {
+                    message_arena.arena.release();
+                }
+            }
+            
+            std::pmr::memory_resource* MessageArena::resource() const {
+                return &message_arena.arena;
+            }
+            
         }
         
-        Message::Message(const char* fmt, std::source_location source) : level(Level::Debug),
-                                                                         format(fmt),
-                                                                         source(source),
-                                                                         message(),
-                                                                         timestamp(Timestamp::now()) {
+        // Limiters read the steady clock (which is cheaper than the wall clock on most platforms), and only once the level check has passed
+        std::int64_t get_steady_time() {
+            return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
         }
         
-        Message::~Message() = default;
-        
-        void push_scope(std::string name) {
-            scopes.emplace_back(std::move(name));
+        EveryN::EveryN(std::uint64_t n) : m_n(std::max(n, std::uint64_t(1u))),
+                                          m_count(0u) {
         }
         
-        void pop_scope() {
-            scopes.pop_back();
+        EveryN::~EveryN() = default;
+        
+        bool EveryN::should_log() {
+            return m_count.fetch_add(1u, std::memory_order_relaxed) % m_n == 0u;
         }
         
-        Sink::Sink(std::string name, std::optional<std::string> format, Message::Level level) : m_name(std::move(name)),
-                                                                                                m_level(level),
-                                                                                                m_lock(),
-                                                                                                m_format(format ? std::move(*format) : Logger::instance().get_default_format()),
-                                                                                                m_enabled(true) {
+        FirstN::FirstN(std::uint64_t n) : m_n(n),
+                                          m_count(0u) {
+        }
+        
+        FirstN::~FirstN() = default;
+        
+        bool FirstN::should_log() {
+            // Once the limit is reached, the counter is only read (and its cache line stays shared between threads)
+            if (m_count.load(std::memory_order_relaxed) >= m_n) {
+                return false;
+            }
+            return m_count.fetch_add(1u, std::memory_order_relaxed) < m_n;
+        }
+        
+        RateLimit::RateLimit(std::chrono::nanoseconds interval, std::uint32_t burst) : m_interval(std::max(interval.count(), std::int64_t(1))),
+                                                                                      m_tolerance(m_interval * (std::max(burst, std::uint32_t(1u)) - 1)),
+                                                                                      m_next(std::numeric_limits<std::int64_t>::min()),
+                                                                                      m_suppressed(0u) {
+        }
+        
+        RateLimit::~RateLimit() = default;
+        
+        bool RateLimit::should_log() {
+            std::int64_t now = get_steady_time();
+            std::int64_t next = m_next.load(std::memory_order_relaxed);
+            
+            do {
+                // The bucket is empty if the next message is due more than 'burst - 1' intervals from now
+                if (next > now && next - now > m_tolerance) {
+                    m_suppressed.fetch_add(1u, std::memory_order_relaxed);
+                    return false;
+                }
+            }
+            while (!m_next.compare_exchange_weak(next, std::max(next, now) + m_interval, std::memory_order_relaxed));
+            
+            return true;
+        }
+        
+        std::uint64_t RateLimit::take_suppressed() {
+            if (m_suppressed.load(std::memory_order_relaxed) == 0u) {
+                return 0u;
+            }
+            return m_suppressed.exchange(0u, std::memory_order_relaxed);
+        }
+        
+        Deduplicator::Deduplicator(std::chrono::nanoseconds window) : m_window(window.count()),
+                                                                      m_last(std::numeric_limits<std::int64_t>::min()),
+                                                                      m_suppressed(0u) {
+        }
+        
+        Deduplicator::~Deduplicator() = default;
+        
+        bool Deduplicator::should_log() {
+            std::int64_t now = get_steady_time();
+            std::int64_t last = m_last.exchange(now, std::memory_order_relaxed);
+            
+            // Repeats extend the window, so a storm is collapsed until it stops
+            if (last != std::numeric_limits<std::int64_t>::min() && now - last < m_window) {
+                m_suppressed.fetch_add(1u, std::memory_order_relaxed);
+                return false;
+            }
+            return true;
+        }
+        
+        std::uint64_t Deduplicator::take_suppressed() {
+            if (m_suppressed.load(std::memory_order_relaxed) == 0u) {
+                return 0u;
+            }
+            return m_suppressed.exchange(0u, std::memory_order_relaxed);
+        }
+        
+        void push_scope(std::string name) {
+            scopes.emplace_back(owned_scopes.emplace_back(std::move(name)));
+        }
+        
+        void pop_scope() {
+            if (scopes.empty()) {
+                return;
+            }
+            
+            if (!owned_scopes.empty() && scopes.back().data() == owned_scopes.back().data()) {
+                owned_scopes.pop_back();
+            }
+            scopes.pop_back();
+        }
+        
+        namespace detail {
+            
+            void push_scope_view(std::string_view name) {
+                scopes.emplace_back(name);
+            }
+            
+        }
+        
+        void enable_async(std::size_t capacity, OverflowPolicy policy, std::size_t num_workers) {
+            Logger::instance().enable_async(capacity, policy, num_workers);
+        }
+        
+        void disable_async() {
+            Logger::instance().disable_async();
+        }
+        
+        void flush() {
+            Logger::instance().flush();
+        }
+        
+        std::size_t get_dropped_message_count() {
+            return Logger::instance().get_dropped_message_count();
+        }
+        
+        void enable_deferred_formatting() {
+            deferred_formatting.store(true, std::memory_order_relaxed);
+        }
+        
+        void disable_deferred_formatting() {
+            deferred_formatting.store(false, std::memory_order_relaxed);
+        }
+        
+        bool deferred_formatting_enabled() {
+            return deferred_formatting.load(std::memory_order_relaxed);
+        }
+        
+        Sink::Sink(std::string name, std::optional<std::string> format, Message::Level level) : m_name(std::move(name)),
+                                                                                                m_level(level),
+                                                                                                m_lock(),
+                                                                                                m_layout(std::make_unique<detail::SinkLayout>(format ? std::move(*format) : Logger::instance().get_default_format())),
+                                                                                                m_enabled(true) {
         }
         
         Sink::~Sink() = default;
         
-        void Sink::log(const Message& data) {
-            if (!m_enabled) {
+        bool Sink::accepts(Message::Level level) const {
+            return m_enabled.load(std::memory_order_relaxed) && level >= m_level.load(std::memory_order_relaxed);
+        }
+        
+        void Sink::log(const detail::BinaryRecord& record) {
+            if (!accepts(record.level)) {
                 return;
             }
             
-            if (data.level < m_level) {
+            std::lock_guard guard { m_lock };
+            write(record);
+        }
+        
+        void Sink::write(const detail::BinaryRecord&) {
+        }
+        
+        void Sink::log(const Message& data) {
+            if (!accepts(data.level)) {
                 return;
             }
             
             std::lock_guard guard { m_lock };
-            std::string message = utils::format(m_format, NamedArgument("message", data.message),
-                                                          NamedArgument("level", data.level),
-                                                          NamedArgument("timestamp", data.timestamp),
-                                                          NamedArgument("date", data.timestamp.date),
-                                                          NamedArgument("day", data.timestamp.date.day),
-                                                          NamedArgument("month", data.timestamp.date.month),
-                                                          NamedArgument("year", data.timestamp.date.year),
-                                                          NamedArgument("time", data.timestamp.time),
-                                                          NamedArgument("hour", data.timestamp.time.hour),
-                                                          NamedArgument("minute", data.timestamp.time.minute),
-                                                          NamedArgument("second", data.timestamp.time.second),
-                                                          NamedArgument("millisecond", data.timestamp.time.millisecond),
-                                                          NamedArgument("source", data.source),
-                                                          NamedArgument("filename", data.source.file_name()),
-                                                          NamedArgument("line", data.source.line()),
-                                                          NamedArgument("thread_id", data.thread_id),
-                                                          NamedArgument("tid", data.thread_id),
-                                                          NamedArgument("process_id", data.process_id),
-                                                          NamedArgument("pid", data.process_id));
+            detail::MessageArena arena;
+            std::pmr::string message(arena.resource());
+            
+            {
+                utils::detail::StringBuffer buffer(message);
+                m_layout->render(data, buffer);
+            }
+            
             log(message, data);
         }
         
+        void Sink::log(const Message& data, detail::RenderCache& cache) {
+            if (!accepts(data.level)) {
+                return;
+            }
+            
+            std::lock_guard guard { m_lock };
+            log(cache.render(*m_layout, data), data);
+        }
+        
         void Sink::set_format(const std::string& format) {
-            m_format = format.empty() ? Logger::instance().get_default_format() : format;
+            // Compile the layout before taking the lock, as it may throw
+            std::unique_ptr<detail::SinkLayout> layout = std::make_unique<detail::SinkLayout>(format.empty() ? Logger::instance().get_default_format() : format);
+            
+            std::lock_guard guard { m_lock };
+            m_layout.swap(layout);
         }
         
         void Sink::reset_format() {
-            m_format = Logger::instance().get_default_format();
+            set_format(Logger::instance().get_default_format());
+        }
+        
+        std::string_view Sink::get_format() const {
+            return m_layout->format();
         }
         
         void Sink::set_level(Message::Level level) {
-            m_level = level;
+            m_level.store(level, std::memory_order_relaxed);
+            Logger::instance().refresh_level();
+        }
+        
+        Message::Level Sink::get_level() const {
+            return m_level.load(std::memory_order_relaxed);
         }
         
         std::string_view Sink::get_name() const {
@@ -300,34 +1211,102 @@ namespace utils {
         }
         
         void Sink::enable() {
-            m_enabled = true;
+            m_enabled.store(true, std::memory_order_relaxed);
+            Logger::instance().refresh_level();
         }
         
         void Sink::disable() {
-            m_enabled = false;
+            m_enabled.store(false, std::memory_order_relaxed);
+            Logger::instance().refresh_level();
+        }
+        
+        bool Sink::is_enabled() const {
+            return m_enabled.load(std::memory_order_relaxed);
         }
         
         void Sink::flush() {
         }
         
-        FileSink::FileSink(const std::filesystem::path& filepath, std::ios::openmode open_mode, std::optional<std::string> format, Message::Level level) : Sink(filepath.stem().string(), std::move(format), level) {
-            if (!std::filesystem::create_directories(filepath)) {
-                throw std::runtime_error(utils::format("failed to create directories for path '{}'", filepath.parent_path()));
+        FileSink::Options::Options() : open_mode(std::ios::out | std::ios::app),
+                                       buffer_size(256u * 1024u),
+                                       flush_interval(1000),
+                                       max_file_size(0u),
+                                       rotation_interval(0),
+                                       max_rotated_files(0u),
+                                       on_rotate(),
+                                       sync(SyncPolicy::Never) {
+        }
+        
+        FileSink::FileSink(const std::filesystem::path& filepath, std::ios::openmode open_mode, std::optional<std::string> format, Message::Level level) : Sink(filepath.stem().string(), std::move(format), level),
+                                                                                                                                                        m_writer() {
+            Options options { };
+            options.open_mode = open_mode;
+            m_writer = std::make_unique<detail::FileWriter>(filepath, std::move(options));
+        }
+        
+        FileSink::FileSink(const std::filesystem::path& filepath, Options options, std::optional<std::string> format, Message::Level level) : Sink(filepath.stem().string(), std::move(format), level),
+                                                                                                                                            m_writer(std::make_unique<detail::FileWriter>(filepath, std::move(options))) {
+        }
+        
+        FileSink::~FileSink() = default;
+        
+        void FileSink::log(std::string_view message, const Message& data) {
+            m_writer->write(message);
+        }
+        
+        void FileSink::flush() {
+            m_writer->flush();
+        }
+        
+        // Records are written out to the file in blocks of (at least) this many bytes
+        constexpr std::size_t binary_file_buffer_size = 64u * 1024u;
+        
+        BinaryFileSink::BinaryFileSink(const std::filesystem::path& filepath, Message::Level level) : Sink(filepath.stem().string(), { }, level),
+                                                                                                      m_file(),
+                                                                                                      m_buffer(),
+                                                                                                      m_formats() {
+            std::filesystem::path directory = filepath.parent_path();
+            if (!directory.empty()) {
+                std::filesystem::create_directories(directory);
             }
-    
-            m_file = std::ofstream(filepath, open_mode);
+            
+            m_file = std::ofstream(filepath, std::ios::out | std::ios::binary | std::ios::trunc);
             if (!m_file.is_open()) {
                 throw std::runtime_error(utils::format("failed to open file '{}'", filepath));
             }
+            
+            m_buffer.reserve(binary_file_buffer_size * 2u);
+            m_buffer.append(detail::binary_log_magic);
+            m_buffer.append(reinterpret_cast<const char*>(&detail::binary_log_version), sizeof(detail::binary_log_version));
         }
         
-        FileSink::~FileSink() = default;
+        BinaryFileSink::~BinaryFileSink() {
+            BinaryFileSink::flush();
+        }
         
-        void FileSink::log(std::string_view message, const Message& data) {
-            m_file << message << '\n';
+        void BinaryFileSink::log(std::string_view, const Message&) {
         }
         
-        void FileSink::flush() {
+        void BinaryFileSink::write(const detail::BinaryRecord& record) {
+            // Each file is self-contained, format records are written before the first message that references them
+            if (record.format_id >= m_formats.size()) {
+                m_formats.resize(record.format_id + 1u, false);
+            }
+            if (!m_formats[record.format_id]) {
+                m_buffer.append(FormatRegistry::instance().get_record(record.format_id));
+                m_formats[record.format_id] = true;
+            }
+            
+            m_buffer.append(record.data);
+            if (m_buffer.length() >= binary_file_buffer_size) {
+                m_file.write(m_buffer.data(), static_cast<std::streamsize>(m_buffer.length()));
+                m_buffer.clear();
+            }
+        }
+        
+        void BinaryFileSink::flush() {
+            m_file.write(m_buffer.data(), static_cast<std::streamsize>(m_buffer.length()));
+            m_buffer.clear();
             m_file.flush();
         }
         
@@ -348,10 +1327,635 @@ namespace utils {
         
         namespace detail {
             
+            struct SinkLayout::Field {
+                enum class Type : std::uint8_t {
+                    Literal = 0,
+                    Message,
+                    Level,
+                    Timestamp,
+                    Date,
+                    Day,
+                    Month,
+                    Year,
+                    Time,
+                    Hour,
+                    Minute,
+                    Second,
+                    Millisecond,
+                    Source,
+                    Filename,
+                    Line,
+                    ThreadId,
+                    ProcessId,
+                } type;
+                
+                std::string_view literal;
+                
+                // Specifier values that require unescaping are stored by the spec, which must outlive the formatter that was parsed from it
+                FormatSpec spec;
+                
+                std::variant<std::monostate,
+                             Formatter<std::string_view>,
+                             Formatter<Message::Level>,
+                             Formatter<utils::Timestamp>,
+                             Formatter<utils::Date>,
+                             Formatter<utils::Time>,
+                             Formatter<utils::Month>,
+                             Formatter<std::uint8_t>,
+                             Formatter<std::uint16_t>,
+                             Formatter<std::uint32_t>,
+                             Formatter<std::source_location>,
+                             Formatter<const char*>,
+                             Formatter<std::thread::id>,
+                             Formatter<decltype(Message::process_id)>> formatter;
+            };
+            
+            template <typename T>
+            void SinkLayout::parse_field(Field& field) {
+                field.formatter.emplace<Formatter<T>>().parse(field.spec);
+            }
+            
+            template <typename T>
+            void SinkLayout::render_field(const Field& field, const T& value, FormatBuffer& out) {
+                utils::detail::format_argument(std::get<Formatter<T>>(field.formatter), value, out);
+            }
+            
+            SinkLayout::SinkLayout(std::string format) : m_format(std::move(format)),
+                                                         m_fields() {
+                std::size_t count = 0u;
+                utils::detail::parse_format_string(m_format, std::source_location::current(), [&count](std::string_view) {
+                    ++count;
+                }, [&count](const utils::detail::Identifier&, std::string_view, std::size_t) {
+                    ++count;
+                });
+                
+                // Fields are parsed in place, as formatters may reference the storage of the format spec of their field
+                m_fields.reserve(count);
+                
+                utils::detail::parse_format_string(m_format, std::source_location::current(), [this](std::string_view literal) {
+                    Field& field = m_fields.emplace_back();
+                    field.type = Field::Type::Literal;
+                    field.literal = literal;
+                }, [this](const utils::detail::Identifier& identifier, std::string_view format_spec, std::size_t) {
+                    if (identifier.type != utils::detail::Identifier::Type::Name) {
+                        throw FormattedError("invalid sink format '{}' - placeholders must reference message fields by name", m_format);
+                    }
+                    
+                    Field& field = m_fields.emplace_back();
+                    if (!format_spec.empty()) {
+                        utils::detail::parse_format_spec(format_spec, field.spec);
+                    }
+                    
+                    std::string_view name = identifier.name;
+                    if (name == "message") {
+                        field.type = Field::Type::Message;
+                        parse_field<std::string_view>(field);
+                    }
+                    else if (name == "level") {
+                        field.type = Field::Type::Level;
+                        parse_field<Message::Level>(field);
+                    }
+                    else if (name == "timestamp") {
+                        field.type = Field::Type::Timestamp;
+                        parse_field<utils::Timestamp>(field);
+                    }
+                    else if (name == "date") {
+                        field.type = Field::Type::Date;
+                        parse_field<utils::Date>(field);
+                    }
+                    else if (name == "day") {
+                        field.type = Field::Type::Day;
+                        parse_field<std::uint8_t>(field);
+                    }
+                    else if (name == "month") {
+                        field.type = Field::Type::Month;
+                        parse_field<utils::Month>(field);
+                    }
+                    else if (name == "year") {
+                        field.type = Field::Type::Year;
+                        parse_field<std::uint32_t>(field);
+                    }
+                    else if (name == "time") {
+                        field.type = Field::Type::Time;
+                        parse_field<utils::Time>(field);
+                    }
+                    else if (name == "hour") {
+                        field.type = Field::Type::Hour;
+                        parse_field<std::uint32_t>(field);
+                    }
+                    else if (name == "minute") {
+                        field.type = Field::Type::Minute;
+                        parse_field<std::uint8_t>(field);
+                    }
+                    else if (name == "second") {
+                        field.type = Field::Type::Second;
+                        parse_field<std::uint8_t>(field);
+                    }
+                    else if (name == "millisecond") {
+                        field.type = Field::Type::Millisecond;
+                        parse_field<std::uint16_t>(field);
+                    }
+                    else if (name == "source") {
+                        field.type = Field::Type::Source;
+                        parse_field<std::source_location>(field);
+                    }
+                    else if (name == "filename") {
+                        field.type = Field::Type::Filename;
+                        parse_field<const char*>(field);
+                    }
+                    else if (name == "line") {
+                        field.type = Field::Type::Line;
+                        parse_field<std::uint32_t>(field);
+                    }
+                    else if (name == "thread_id" || name == "tid") {
+                        field.type = Field::Type::ThreadId;
+                        parse_field<std::thread::id>(field);
+                    }
+                    else if (name == "process_id" || name == "pid") {
+                        field.type = Field::Type::ProcessId;
+                        parse_field<decltype(Message::process_id)>(field);
+                    }
+                    else {
+                        throw FormattedError("invalid sink format '{}' - unknown placeholder '{}'", m_format, name);
+                    }
+                });
+            }
+            
+            SinkLayout::~SinkLayout() = default;
+            
+            std::string_view SinkLayout::format() const {
+                return m_format;
+            }
+            
+            void SinkLayout::render(const Message& message, FormatBuffer& out) const {
+                // Calendar breakdown of the timestamp is only computed if a field references it
+                std::optional<utils::Timestamp> storage;
+                auto timestamp = [&storage, &message]() -> const utils::Timestamp& {
+                    if (!storage) {
+                        storage.emplace(message.timestamp);
+                    }
+                    return *storage;
+                };
+                
+                for (const Field& field : m_fields) {
+                    switch (field.type) {
+                        case Field::Type::Literal:
+                            out.append(field.literal);
+                            break;
+                        case Field::Type::Message:
+                            render_field(field, message.message, out);
+                            break;
+                        case Field::Type::Level:
+                            render_field(field, message.level, out);
+                            break;
+                        case Field::Type::Timestamp:
+                            render_field(field, timestamp(), out);
+                            break;
+                        case Field::Type::Date:
+                            render_field(field, timestamp().date, out);
+                            break;
+                        case Field::Type::Day:
+                            render_field(field, timestamp().date.day, out);
+                            break;
+                        case Field::Type::Month:
+                            render_field(field, timestamp().date.month, out);
+                            break;
+                        case Field::Type::Year:
+                            render_field(field, timestamp().date.year, out);
+                            break;
+                        case Field::Type::Time:
+                            render_field(field, timestamp().time, out);
+                            break;
+                        case Field::Type::Hour:
+                            render_field(field, timestamp().time.hour, out);
+                            break;
+                        case Field::Type::Minute:
+                            render_field(field, timestamp().time.minute, out);
+                            break;
+                        case Field::Type::Second:
+                            render_field(field, timestamp().time.second, out);
+                            break;
+                        case Field::Type::Millisecond:
+                            render_field(field, timestamp().time.millisecond, out);
+                            break;
+                        case Field::Type::Source:
+                            render_field(field, message.source, out);
+                            break;
+                        case Field::Type::Filename:
+                            render_field(field, message.source.file_name(), out);
+                            break;
+                        case Field::Type::Line:
+                            render_field(field, static_cast<std::uint32_t>(message.source.line()), out);
+                            break;
+                        case Field::Type::ThreadId:
+                            render_field(field, message.thread_id, out);
+                            break;
+                        case Field::Type::ProcessId:
+                            render_field(field, message.process_id, out);
+                            break;
+                    }
+                }
+            }
+            
+            RenderCache::RenderCache(std::pmr::memory_resource* resource) : m_resource(resource),
+                                                                            m_entries(resource) {
+            }
+            
+            std::string_view RenderCache::render(const SinkLayout& layout, const Message& message) {
+                for (const Entry& entry : m_entries) {
+                    if (entry.format == layout.format()) {
+                        return entry.line;
+                    }
+                }
+                
+                Entry& entry = m_entries.emplace_back(Entry { std::pmr::string(layout.format(), m_resource), std::pmr::string(m_resource) });
+                
+                {
+                    utils::detail::StringBuffer buffer(entry.line);
+                    layout.render(message, buffer);
+                }
+                
+                return entry.line;
+            }
+            
+            AppendFile::AppendFile() {
+                #if defined(PLATFORM_WINDOWS)
+                    m_handle = INVALID_HANDLE_VALUE;
+                #else
+                    m_fd = -1;
+                #endif
+            }
+            
+            AppendFile::~AppendFile() {
+                close();
+            }
+            
+            bool AppendFile::open(const std::filesystem::path& filepath, bool truncate) {
+                close();
+                
+                #if defined(PLATFORM_WINDOWS)
+                    // Writes to a handle opened with FILE_APPEND_DATA (and without FILE_WRITE_DATA) always append to the end of the file
+                    m_handle = CreateFileW(filepath.c_str(), FILE_APPEND_DATA, FILE_SHARE_READ | FILE_SHARE_DELETE, nullptr, truncate ? CREATE_ALWAYS : OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+                #else
+                    m_fd = ::open(filepath.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC | (truncate ? O_TRUNC : 0), 0644);
+                #endif
+                
+                return is_open();
+            }
+            
+            void AppendFile::close() {
+                if (!is_open()) {
+                    return;
+                }
+                
+                #if defined(PLATFORM_WINDOWS)
+                    CloseHandle(m_handle);
+                    m_handle = INVALID_HANDLE_VALUE;
+                #else
+                    ::close(m_fd);
+                    m_fd = -1;
+                #endif
+            }
+            
+            bool AppendFile::is_open() const {
+                #if defined(PLATFORM_WINDOWS)
+                    return m_handle != INVALID_HANDLE_VALUE;
+                #else
+                    return m_fd >= 0;
+                #endif
+            }
+            
+            bool AppendFile::write(std::span<const std::string> buffers) {
+                if (!is_open()) {
+                    return false;
+                }
+                
+                #if defined(PLATFORM_WINDOWS)
+                    for (const std::string& buffer : buffers) {
+                        const char* data = buffer.data();
+                        std::size_t remaining = buffer.length();
+                        
+                        while (remaining > 0u) {
+                            DWORD written;
+                            if (!WriteFile(m_handle, data, static_cast<DWORD>(std::min(remaining, std::size_t(1u) << 30u)), &written, nullptr)) {
+                                return false;
+                            }
+                            data += written;
+                            remaining -= written;
+                        }
+                    }
+                #else
+                    // Buffers are written out with a single system call (per IOV_MAX buffers), partial writes resume from the first byte that was not written
+                    iovec vectors[IOV_MAX];
+                    std::size_t offset = 0u;
+                    
+                    while (offset < buffers.size()) {
+                        int count = 0;
+                        for (std::size_t i = offset; i < buffers.size() && count < IOV_MAX; ++i) {
+                            vectors[count++] = iovec { const_cast<char*>(buffers[i].data()), buffers[i].length() };
+                        }
+                        
+                        iovec* current = vectors;
+                        while (count > 0) {
+                            ssize_t written = ::writev(m_fd, current, count);
+                            if (written < 0) {
+                                if (errno == EINTR) {
+                                    continue;
+                                }
+                                return false;
+                            }
+                            
+                            std::size_t remaining = static_cast<std::size_t>(written);
+                            while (count > 0 && remaining >= current->iov_len) {
+                                remaining -= current->iov_len;
+                                ++current;
+                                --count;
+                                ++offset;
+                            }
+                            
+                            if (count > 0) {
+                                current->iov_base = static_cast<char*>(current->iov_base) + remaining;
+                                current->iov_len -= remaining;
+                            }
+                        }
+                    }
+                #endif
+                
+                return true;
+            }
+            
+            void AppendFile::sync() {
+                if (!is_open()) {
+                    return;
+                }
+                
+                #if defined(PLATFORM_WINDOWS)
+                    FlushFileBuffers(m_handle);
+                #elif defined(PLATFORM_LINUX)
+                    // File metadata (other than the size) does not need to be written out to read the data back
+                    ::fdatasync(m_fd);
+                #else
+                    ::fsync(m_fd);
+                #endif
+            }
+            
+            // Maximum number of buffers waiting to be written out before logging threads wait for the background thread to catch up
+            constexpr std::size_t file_writer_max_pending_buffers = 8u;
+            
+            FileWriter::FileWriter(std::filesystem::path filepath, FileSink::Options options) : m_filepath(std::move(filepath)),
+                                                                                                m_options(std::move(options)),
+                                                                                                m_file(),
+                                                                                                m_file_size(0u),
+                                                                                                m_rotation_time(std::chrono::steady_clock::time_point::max()),
+                                                                                                m_rotation_index(1u),
+                                                                                                m_lock(),
+                                                                                                m_work(),
+                                                                                                m_done(),
+                                                                                                m_buffer(),
+                                                                                                m_buffer_time(),
+                                                                                                m_pending(),
+                                                                                                m_free(),
+                                                                                                m_flush_requested(0u),
+                                                                                                m_flush_completed(0u),
+                                                                                                m_stopped(false),
+                                                                                                m_thread() {
+                std::filesystem::path directory = m_filepath.parent_path();
+                if (!directory.empty()) {
+                    std::filesystem::create_directories(directory);
+                }
+                
+                if (!m_file.open(m_filepath, (m_options.open_mode & std::ios::trunc) != 0)) {
+                    throw std::runtime_error(utils::format("failed to open file '{}'", m_filepath));
+                }
+                
+                std::error_code error { };
+                std::uintmax_t size = std::filesystem::file_size(m_filepath, error);
+                m_file_size = error ? 0u : static_cast<std::size_t>(size);
+                
+                if (m_options.rotation_interval.count() > 0) {
+                    m_rotation_time = std::chrono::steady_clock::now() + m_options.rotation_interval;
+                }
+                
+                if (m_options.max_file_size > 0u || m_options.rotation_interval.count() > 0) {
+                    // Continue numbering after the most recent rotated file left behind by a previous run
+                    while (std::filesystem::exists(get_rotated_path(m_rotation_index), error)) {
+                        ++m_rotation_index;
+                    }
+                }
+                
+                m_buffer.reserve(m_options.buffer_size + 1024u);
+                m_thread = std::thread(&FileWriter::run, this);
+            }
+            
+            FileWriter::~FileWriter() {
+                {
+                    std::lock_guard guard { m_lock };
+                    submit();
+                    m_stopped = true;
+                }
+                m_work.notify_one();
+                m_thread.join();
+            }
+            
+            void FileWriter::write(std::string_view message) {
+                std::unique_lock guard { m_lock };
+                
+                bool empty = m_buffer.empty();
+                if (empty) {
+                    m_buffer_time = std::chrono::steady_clock::now();
+                }
+                
+                m_buffer.append(message);
+                m_buffer.push_back('\n');
+                
+                if (empty) {
+                    // Background thread waits without a deadline while the buffer is empty
+                    guard.unlock();
+                    m_work.notify_one();
+                }
+                else if (m_buffer.length() >= m_options.buffer_size) {
+                    // Wait for the background thread to catch up instead of buffering an unbounded amount of data
+                    m_done.wait(guard, [this]() {
+                        return m_pending.size() < file_writer_max_pending_buffers;
+                    });
+                    
+                    submit();
+                    guard.unlock();
+                    m_work.notify_one();
+                }
+            }
+            
+            void FileWriter::flush() {
+                std::unique_lock guard { m_lock };
+                submit();
+                
+                std::size_t request = ++m_flush_requested;
+                m_work.notify_one();
+                
+                m_done.wait(guard, [this, request]() {
+                    return m_flush_completed >= request;
+                });
+            }
+            
+            void FileWriter::submit() {
+                if (m_buffer.empty()) {
+                    return;
+                }
+                
+                m_pending.emplace_back(std::move(m_buffer));
+                
+                if (m_free.empty()) {
+                    m_buffer = std::string();
+                    m_buffer.reserve(m_options.buffer_size + 1024u);
+                }
+                else {
+                    m_buffer = std::move(m_free.back());
+                    m_free.pop_back();
+                }
+            }
+            
+            void FileWriter::run() {
+                std::vector<std::string> buffers;
+                std::unique_lock guard { m_lock };
+                
+                while (true) {
+                    auto ready = [this]() {
+                        return m_stopped || !m_pending.empty() || m_flush_completed < m_flush_requested;
+                    };
+                    
+                    // Wake up to write out the active buffer once its flush interval elapses, or to rotate the file
+                    std::chrono::steady_clock::time_point deadline = std::min(m_rotation_time, m_buffer.empty() ? std::chrono::steady_clock::time_point::max() : m_buffer_time + m_options.flush_interval);
+                    if (deadline == std::chrono::steady_clock::time_point::max()) {
+                        // Also wake up once a message is appended to the active buffer, to start its flush interval
+                        m_work.wait(guard, [this, &ready]() {
+                            return ready() || !m_buffer.empty();
+                        });
+                    }
+                    else {
+                        m_work.wait_until(guard, deadline, ready);
+                    }
+                    
+                    std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+                    if (!m_buffer.empty() && now - m_buffer_time >= m_options.flush_interval) {
+                        submit();
+                    }
+                    
+                    std::size_t flush_request = m_flush_requested;
+                    bool stopped = m_stopped;
+                    buffers.swap(m_pending);
+                    
+                    // Logging threads waiting for room in the pending list can proceed while buffers are written out
+                    m_done.notify_all();
+                    guard.unlock();
+                    
+                    if (!buffers.empty()) {
+                        // Write failures cannot be reported to the logging thread, messages that could not be written out are lost
+                        m_file.write(buffers);
+                        
+                        for (const std::string& buffer : buffers) {
+                            m_file_size += buffer.length();
+                        }
+                        
+                        if (m_options.sync == SyncPolicy::Always) {
+                            m_file.sync();
+                        }
+                    }
+                    
+                    if (m_options.sync == SyncPolicy::OnFlush && flush_request > m_flush_completed) {
+                        m_file.sync();
+                    }
+                    
+                    if ((m_options.max_file_size > 0u && m_file_size >= m_options.max_file_size) || now >= m_rotation_time) {
+                        rotate();
+                    }
+                    
+                    guard.lock();
+                    
+                    for (std::string& buffer : buffers) {
+                        buffer.clear();
+                        m_free.emplace_back(std::move(buffer));
+                    }
+                    buffers.clear();
+                    
+                    m_flush_completed = flush_request;
+                    m_done.notify_all();
+                    
+                    if (stopped && m_pending.empty()) {
+                        break;
+                    }
+                }
+            }
+            
+            void FileWriter::rotate() {
+                if (m_options.rotation_interval.count() > 0) {
+                    m_rotation_time = std::chrono::steady_clock::now() + m_options.rotation_interval;
+                }
+                
+                if (m_file_size == 0u) {
+                    // Do not rotate out empty files
+                    return;
+                }
+                
+                m_file.close();
+                
+                std::filesystem::path rotated = get_rotated_path(m_rotation_index);
+                std::error_code error { };
+                std::filesystem::rename(m_filepath, rotated, error);
+                if (!error) {
+                    ++m_rotation_index;
+                }
+                
+                // Keep appending to the current file if it could not be renamed
+                m_file.open(m_filepath, false);
+                m_file_size = error ? m_file_size : 0u;
+                
+                if (error) {
+                    return;
+                }
+                
+                if (m_options.max_rotated_files > 0u && m_rotation_index > m_options.max_rotated_files + 1u) {
+                    std::filesystem::remove(get_rotated_path(m_rotation_index - m_options.max_rotated_files - 1u), error);
+                }
+                
+                if (m_options.on_rotate) {
+                    m_options.on_rotate(rotated);
+                }
+            }
+            
+            std::filesystem::path FileWriter::get_rotated_path(std::size_t index) const {
+                std::filesystem::path filepath = m_filepath;
+                filepath.replace_filename(utils::format("{}.{}{}", m_filepath.stem().string(), index, m_filepath.extension().string()));
+                return filepath;
+            }
+            
             void log(Message& message) {
                 Logger::instance().log(message);
             }
             
+            void log(const BinaryRecord& record) {
+                Logger::instance().log(record);
+            }
+            
+            std::uint32_t begin_record(std::pmr::string& record, Message::Level level, const Message& message) {
+                std::uint32_t id = FormatRegistry::instance().get_id(message.format, message.source);
+                
+                write_value(record, RecordType::Message);
+                write_value(record, std::uint32_t(0u)); // Patched once the record is complete
+                write_value(record, id);
+                write_value(record, static_cast<std::uint8_t>(level));
+                write_value(record, static_cast<std::int64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now().time_since_epoch()).count()));
+                write_value(record, static_cast<std::uint64_t>(std::hash<std::thread::id> { }(thread_id)));
+                write_value(record, static_cast<std::uint32_t>(get_process_id()));
+                
+                std::size_t depth = std::min(scopes.size(), std::size_t(255u));
+                write_value(record, static_cast<std::uint8_t>(depth));
+                for (std::size_t i = 0u; i < depth; ++i) {
+                    write_string(record, scopes[i]);
+                }
+                
+                return id;
+            }
+            
             void add_sink(const std::shared_ptr<Sink>& sink) {
                 Logger& logger = Logger::instance();
                 std::string_view name = sink->get_name();
@@ -429,4 +2033,24 @@ namespace utils {
         return Formatter<const char*>::format(str);
     }
     
+    void Formatter<logging::Message::Level>::format_to(logging::Message::Level level, FormatBuffer& out) const {
+        using namespace logging;
+        
+        const char* str;
+        if (level == Message::Level::Debug) {
+            str = uppercase ? "DEBUG" : "debug";
+        }
+        else if (level == Message::Level::Info) {
+            str = uppercase ? "INFO" : "info";
+        }
+        else if (level == Message::Level::Warning) {
+            str = uppercase ? "WARNING" : "warning";
+        }
+        else { // if (level == Message::Level::Error) {
+            str = uppercase ? "ERROR" : "error";
+        }
+        
+        Formatter<const char*>::format_to(str, out);
+    }
+    
 }
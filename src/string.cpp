@@ -5,29 +5,29 @@
 
 #include <limits> // std::numeric_limits
 #include <charconv> // std::from_chars, std::from_chars_result
-#include <cstring> // std::strlen
+#include <cstring> // std::strlen, std::memcpy, std::memchr
+#include <memory> // std::uninitialized_copy_n
+#include <bit> // std::countr_zero, std::endian
+#include <span> // std::span
+
+#if defined(__x86_64__) || defined(_M_X64)
+    // SSE2 is part of the x86-64 baseline, AVX2 is selected at runtime (requires compiler support for per-function target attributes)
+    #define UTILS_SIMD_SSE2 1
+    #include <emmintrin.h>
+    #if defined(__GNUC__) || defined(__clang__)
+        #define UTILS_SIMD_AVX2 1
+        #include <immintrin.h>
+    #endif
+#elif defined(__aarch64__) || defined(_M_ARM64)
+    // NEON is part of the AArch64 baseline
+    #define UTILS_SIMD_NEON 1
+    #include <arm_neon.h>
+#endif
 
 namespace utils {
 
     namespace detail {
         
-        Identifier::Identifier() : type(Type::Auto),
-                                   position(std::numeric_limits<std::size_t>::max()),
-                                   name() {
-        }
-        
-        Identifier::Identifier(std::size_t position) : type(Type::Position),
-                                                       position(position),
-                                                       name() {
-        }
-        
-        Identifier::Identifier(std::string_view name) : type(Type::Name),
-                                                        position(std::numeric_limits<std::size_t>::max()),
-                                                        name(name) {
-        }
-        
-        Identifier::~Identifier() = default;
-        
         bool Identifier::operator==(const Identifier& other) const {
             bool matching_types = type == other.type;
         
@@ -42,34 +42,254 @@ namespace utils {
             }
         }
         
-        std::size_t parse_identifier(std::string_view in, Identifier& out) {
-            std::size_t offset = 0;
-
-            if (std::isdigit(in[offset])) {
-                ++offset;
-
-                // Positional placeholders must only contain numbers
-                while (std::isdigit(in[offset])) {
-                    ++offset;
+        std::size_t find_first_of_scalar(const char* data, std::size_t length, std::string_view characters) {
+            for (std::size_t i = 0u; i < length; ++i) {
+                if (characters.find(data[i]) != std::string_view::npos) {
+                    return i;
                 }
-
-                std::size_t position;
-                from_string(in.substr(0, offset), position);
-
-                out = Identifier(position);
             }
-            else if (std::isalpha(in[offset]) || in[offset] == '_') {
-                ++offset;
-
-                // Named placeholders follow the same identifier rules as standard C/C++ identifiers
-                while (std::isalnum(in[offset]) || in[offset] == '_') {
-                    ++offset;
+            return length;
+        }
+        
+        // Vectorized implementations compare blocks of characters against exactly 4 characters, unused slots repeat the first character
+        std::array<char, 4> pad_characters(std::string_view characters) {
+            std::array<char, 4> result { };
+            for (std::size_t i = 0u; i < 4u; ++i) {
+                result[i] = i < characters.length() ? characters[i] : characters[0];
+            }
+            return result;
+        }
+        
+        #if defined(UTILS_SIMD_SSE2)
+            std::size_t find_first_of_sse2(const char* data, std::size_t length, std::string_view characters) {
+                std::array<char, 4> c = pad_characters(characters);
+                __m128i c0 = _mm_set1_epi8(c[0]);
+                __m128i c1 = _mm_set1_epi8(c[1]);
+                __m128i c2 = _mm_set1_epi8(c[2]);
+                __m128i c3 = _mm_set1_epi8(c[3]);
+                
+                std::size_t i = 0u;
+                for (; i + 16u <= length; i += 16u) {
+                    __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+                    __m128i matches = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(block, c0), _mm_cmpeq_epi8(block, c1)),
+                                                   _mm_or_si128(_mm_cmpeq_epi8(block, c2), _mm_cmpeq_epi8(block, c3)));
+                    
+                    unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(matches));
+                    if (mask) {
+                        return i + std::countr_zero(mask);
+                    }
                 }
-
-                out = Identifier(in.substr(0, offset));
+                
+                return i + find_first_of_scalar(data + i, length - i, characters);
             }
-
-            return offset;
+        #endif
+        
+        #if defined(UTILS_SIMD_AVX2)
+            __attribute__((target("avx2")))
+            std::size_t find_first_of_avx2(const char* data, std::size_t length, std::string_view characters) {
+                std::array<char, 4> c = pad_characters(characters);
+                __m256i c0 = _mm256_set1_epi8(c[0]);
+                __m256i c1 = _mm256_set1_epi8(c[1]);
+                __m256i c2 = _mm256_set1_epi8(c[2]);
+                __m256i c3 = _mm256_set1_epi8(c[3]);
+                
+                std::size_t i = 0u;
+                for (; i + 32u <= length; i += 32u) {
+                    __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+                    __m256i matches = _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(block, c0), _mm256_cmpeq_epi8(block, c1)),
+                                                      _mm256_or_si256(_mm256_cmpeq_epi8(block, c2), _mm256_cmpeq_epi8(block, c3)));
+                    
+                    unsigned mask = static_cast<unsigned>(_mm256_movemask_epi8(matches));
+                    if (mask) {
+                        return i + std::countr_zero(mask);
+                    }
+                }
+                
+                // Remaining characters (less than one full block)
+                return i + find_first_of_sse2(data + i, length - i, characters);
+            }
+        #endif
+        
+        #if defined(UTILS_SIMD_NEON)
+            std::size_t find_first_of_neon(const char* data, std::size_t length, std::string_view characters) {
+                std::array<char, 4> c = pad_characters(characters);
+                uint8x16_t c0 = vdupq_n_u8(static_cast<std::uint8_t>(c[0]));
+                uint8x16_t c1 = vdupq_n_u8(static_cast<std::uint8_t>(c[1]));
+                uint8x16_t c2 = vdupq_n_u8(static_cast<std::uint8_t>(c[2]));
+                uint8x16_t c3 = vdupq_n_u8(static_cast<std::uint8_t>(c[3]));
+                
+                std::size_t i = 0u;
+                for (; i + 16u <= length; i += 16u) {
+                    uint8x16_t block = vld1q_u8(reinterpret_cast<const std::uint8_t*>(data + i));
+                    uint8x16_t matches = vorrq_u8(vorrq_u8(vceqq_u8(block, c0), vceqq_u8(block, c1)),
+                                                  vorrq_u8(vceqq_u8(block, c2), vceqq_u8(block, c3)));
+                    
+                    // Narrow each 8-bit comparison result to 4 bits to build a 64-bit mask
+                    std::uint64_t mask = vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(matches), 4)), 0);
+                    if (mask) {
+                        return i + (std::countr_zero(mask) >> 2);
+                    }
+                }
+                
+                return i + find_first_of_scalar(data + i, length - i, characters);
+            }
+        #endif
+        
+        std::size_t find_first_of(const char* data, std::size_t length, std::string_view characters) {
+            using Implementation = std::size_t (*)(const char*, std::size_t, std::string_view);
+            
+            // Selected once, based on the instruction sets supported by the CPU
+            static const Implementation implementation = []() -> Implementation {
+                #if defined(UTILS_SIMD_AVX2)
+                    if (__builtin_cpu_supports("avx2")) {
+                        return find_first_of_avx2;
+                    }
+                #endif
+                
+                #if defined(UTILS_SIMD_SSE2)
+                    return find_first_of_sse2;
+                #elif defined(UTILS_SIMD_NEON)
+                    return find_first_of_neon;
+                #else
+                    return find_first_of_scalar;
+                #endif
+            }();
+            
+            if (length < 16u) {
+                // Not worth the overhead of vectorization
+                return find_first_of_scalar(data, length, characters);
+            }
+            
+            return implementation(data, length, characters);
+        }
+        
+        // Multi-character delimiter search compares blocks of characters against both the first and last characters of the delimiter
+        // Only positions where both match are verified against the full delimiter, which rejects most candidates without a comparison
+        // All implementations require the delimiter to contain at least two characters, and return 'length' if the delimiter is not found
+        
+        std::size_t find_substring_scalar(const char* data, std::size_t length, std::string_view delimiter) {
+            std::size_t position = std::string_view(data, length).find(delimiter);
+            return position == std::string_view::npos ? length : position;
+        }
+        
+        #if defined(UTILS_SIMD_SSE2)
+            std::size_t find_substring_sse2(const char* data, std::size_t length, std::string_view delimiter) {
+                std::size_t last = delimiter.length() - 1u;
+                __m128i c0 = _mm_set1_epi8(delimiter.front());
+                __m128i c1 = _mm_set1_epi8(delimiter.back());
+                
+                std::size_t i = 0u;
+                for (; i + last + 16u <= length; i += 16u) {
+                    __m128i first_block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+                    __m128i last_block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i + last));
+                    
+                    unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(first_block, c0), _mm_cmpeq_epi8(last_block, c1))));
+                    while (mask) {
+                        std::size_t candidate = i + std::countr_zero(mask);
+                        if (std::memcmp(data + candidate + 1u, delimiter.data() + 1u, last - 1u) == 0) {
+                            return candidate;
+                        }
+                        mask &= mask - 1u;
+                    }
+                }
+                
+                return i + find_substring_scalar(data + i, length - i, delimiter);
+            }
+        #endif
+        
+        #if defined(UTILS_SIMD_AVX2)
+            __attribute__((target("avx2")))
+            std::size_t find_substring_avx2(const char* data, std::size_t length, std::string_view delimiter) {
+                std::size_t last = delimiter.length() - 1u;
+                __m256i c0 = _mm256_set1_epi8(delimiter.front());
+                __m256i c1 = _mm256_set1_epi8(delimiter.back());
+                
+                std::size_t i = 0u;
+                for (; i + last + 32u <= length; i += 32u) {
+                    __m256i first_block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+                    __m256i last_block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i + last));
+                    
+                    unsigned mask = static_cast<unsigned>(_mm256_movemask_epi8(_mm256_and_si256(_mm256_cmpeq_epi8(first_block, c0), _mm256_cmpeq_epi8(last_block, c1))));
+                    while (mask) {
+                        std::size_t candidate = i + std::countr_zero(mask);
+                        if (std::memcmp(data + candidate + 1u, delimiter.data() + 1u, last - 1u) == 0) {
+                            return candidate;
+                        }
+                        mask &= mask - 1u;
+                    }
+                }
+                
+                // Remaining characters (less than one full block)
+                return i + find_substring_sse2(data + i, length - i, delimiter);
+            }
+        #endif
+        
+        #if defined(UTILS_SIMD_NEON)
+            std::size_t find_substring_neon(const char* data, std::size_t length, std::string_view delimiter) {
+                std::size_t last = delimiter.length() - 1u;
+                uint8x16_t c0 = vdupq_n_u8(static_cast<std::uint8_t>(delimiter.front()));
+                uint8x16_t c1 = vdupq_n_u8(static_cast<std::uint8_t>(delimiter.back()));
+                
+                std::size_t i = 0u;
+                for (; i + last + 16u <= length; i += 16u) {
+                    uint8x16_t first_block = vld1q_u8(reinterpret_cast<const std::uint8_t*>(data + i));
+                    uint8x16_t last_block = vld1q_u8(reinterpret_cast<const std::uint8_t*>(data + i + last));
+                    uint8x16_t matches = vandq_u8(vceqq_u8(first_block, c0), vceqq_u8(last_block, c1));
+                    
+                    // Narrow each 8-bit comparison result to 4 bits to build a 64-bit mask
+                    std::uint64_t mask = vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(matches), 4)), 0);
+                    while (mask) {
+                        unsigned bit = std::countr_zero(mask);
+                        std::size_t candidate = i + (bit >> 2);
+                        if (std::memcmp(data + candidate + 1u, delimiter.data() + 1u, last - 1u) == 0) {
+                            return candidate;
+                        }
+                        mask &= ~(std::uint64_t(0xF) << (bit & ~3u));
+                    }
+                }
+                
+                return i + find_substring_scalar(data + i, length - i, delimiter);
+            }
+        #endif
+        
+        std::size_t find_delimiter(std::string_view in, std::size_t offset, std::string_view delimiter) {
+            using Implementation = std::size_t (*)(const char*, std::size_t, std::string_view);
+            
+            // Selected once, based on the instruction sets supported by the CPU
+            static const Implementation implementation = []() -> Implementation {
+                #if defined(UTILS_SIMD_AVX2)
+                    if (__builtin_cpu_supports("avx2")) {
+                        return find_substring_avx2;
+                    }
+                #endif
+                
+                #if defined(UTILS_SIMD_SSE2)
+                    return find_substring_sse2;
+                #elif defined(UTILS_SIMD_NEON)
+                    return find_substring_neon;
+                #else
+                    return find_substring_scalar;
+                #endif
+            }();
+            
+            if (delimiter.empty() || offset >= in.length()) {
+                return in.length();
+            }
+            
+            const char* data = in.data() + offset;
+            std::size_t length = in.length() - offset;
+            
+            if (delimiter.length() == 1u) {
+                // std::memchr is vectorized by all major standard library implementations
+                const void* position = std::memchr(data, delimiter.front(), length);
+                return position ? static_cast<const char*>(position) - in.data() : in.length();
+            }
+            
+            if (delimiter.length() > length) {
+                return in.length();
+            }
+            
+            return offset + implementation(data, length, delimiter);
         }
         
         std::size_t parse_specifier_name(std::string_view in, std::string_view& out) {
@@ -77,7 +297,7 @@ namespace utils {
             std::size_t i = 0;
 
             // Specifier names follow the same rules as standard C/C++ identifiers
-            while (std::isalpha(in[i]) || (in[i] == '_') || (i && std::isdigit(in[i]))) {
+            while (ascii::is_alpha(char_at(in, i)) || (char_at(in, i) == '_') || (i && ascii::is_digit(char_at(in, i)))) {
                 ++i;
             }
             
@@ -85,7 +305,58 @@ namespace utils {
             return i;
         }
         
-        std::size_t parse_specifier_value(std::string_view in, std::string_view name, std::string& out) {
+        // Accumulates the characters of a specifier value, which are appended as ranges of the input string
+        // Values without escaped braces form a single contiguous range and are referenced directly, only values that require unescaping are copied (into 'resource')
+        class SpecifierValue {
+            public:
+                SpecifierValue(std::string_view in, std::pmr::memory_resource* resource) : m_in(in),
+                                                                                           m_resource(resource),
+                                                                                           m_buffer(nullptr),
+                                                                                           m_offset(0u),
+                                                                                           m_length(0u) {
+                }
+                
+                void append(std::string_view in, std::size_t offset, std::size_t count) {
+                    if (!count) {
+                        return;
+                    }
+                    
+                    if (!m_buffer) {
+                        if (!m_length) {
+                            m_offset = offset;
+                        }
+                        
+                        if (m_offset + m_length == offset) {
+                            // Range is contiguous with the characters appended so far
+                            m_length += count;
+                            return;
+                        }
+                        
+                        // Unescaping removes characters, so the value is never longer than the input
+                        m_buffer = static_cast<char*>(m_resource->allocate(m_in.length(), alignof(char)));
+                        std::memcpy(m_buffer, m_in.data() + m_offset, m_length);
+                    }
+                    
+                    std::memcpy(m_buffer + m_length, in.data() + offset, count);
+                    m_length += count;
+                }
+                
+                [[nodiscard]] std::string_view view() const {
+                    if (m_buffer) {
+                        return { m_buffer, m_length };
+                    }
+                    return m_in.substr(m_offset, m_length);
+                }
+                
+            private:
+                std::string_view m_in;
+                std::pmr::memory_resource* m_resource;
+                char* m_buffer;
+                std::size_t m_offset;
+                std::size_t m_length;
+        };
+        
+        std::size_t parse_specifier_value(std::string_view in, std::string_view name, SpecifierValue& out) {
             std::size_t length = in.length();
             std::size_t i = 0;
             std::size_t last_read_position = i;
@@ -94,7 +365,13 @@ namespace utils {
                 // Specifiers containing nested format strings are parsed differently
                 bool processing_placeholder = false;
                 
-                while (i < length) {
+                while (true) {
+                    // Skip to the next character of interest: the closing brace of a nested placeholder, or any opening brace / format specifier brace
+                    i = find_first_of(in, i, processing_placeholder ? "}" : "{[]");
+                    if (i == length) {
+                        break;
+                    }
+                    
                     if (processing_placeholder) {
                         if (in[i] == '}') {
                             if (i + 1 == length) {
@@ -197,6 +474,7 @@ namespace utils {
 
         std::size_t parse_format_spec(std::string_view in, FormatSpec& out, bool nested) {
             // Note: function assumes input string does not contain a leading formatting group separator ':'
+            // Must accept the same grammar as scan_format_spec, which validates format specs at compile time
             std::size_t length = in.length();
             std::size_t group = 0;
             std::size_t i = 0;
@@ -228,9 +506,12 @@ namespace utils {
                     i += parse_format_spec(in.substr(i), out[group], true);
 
                     // After parsing a nested formatting spec, the terminator character is expected to be '|'
-                    if (in[i] != '|') {
+                    if (char_at(in, i) != '|') {
                         return i;
                     }
+                    
+                    // Skip nested formatting spec terminator
+                    ++i;
                 }
                 else {
                     // Parse format specifiers
@@ -238,7 +519,7 @@ namespace utils {
                         std::string_view name;
                         i += parse_specifier_name(in.substr(i), name);
                         
-                        if (in[i] != '=') {
+                        if (char_at(in, i) != '=') {
                             // Specifier name and value must be separated by '='
                             return i;
                         }
@@ -246,21 +527,36 @@ namespace utils {
                         // Skip separator '='
                         ++i;
                         
-                        if (out[group].has_specifier(name)) {
+                        FormatSpec& spec = out[group];
+                        if (spec.has_specifier(name)) {
                             throw std::runtime_error(utils::format("encountered multiple format specifiers using the same identifier: '{}' - format specifiers must be unique", name));
                         }
                         
+                        if (char_at(in, i) != '[') {
+                            // Specifier values must be enclosed in braces '[' and ']'
+                            return i;
+                        }
+                        
                         // Skip opening brace '['
                         ++i;
                         
-                        i += parse_specifier_value(in.substr(i), name, out[group][name]);
+                        // Specifier values reference the input string, unless they contain escaped braces
+                        std::string_view remaining = in.substr(i);
+                        SpecifierValue value(remaining, spec.arena());
+                        i += parse_specifier_value(remaining, name, value);
+                        spec.append_specifier(name, value.view());
+                        
+                        if (i > length) {
+                            // Unterminated specifier value
+                            return length;
+                        }
                         
-                        if (in[i] == ',') {
+                        if (char_at(in, i) == ',') {
                             // Skip format specifier separator
                             ++i;
                             continue;
                         }
-                        else if (in[i] == terminator || in[i] == ':') {
+                        else if (char_at(in, i) == terminator || char_at(in, i) == ':') {
                             // End of format spec || new format group
                             break;
                         }
@@ -275,148 +571,85 @@ namespace utils {
             return i;
         }
 
-        char nibble_to_hexadecimal(const char* nibble) {
-            if (nibble[0] == '0') {
-                // 0---
-                if (nibble[1] == '0') {
-                    // 00--
-                    if (nibble[2] == '0') {
-                        // 000-
-                        if (nibble[3] == '0') {
-                            // 0000 (0)
-                            return '0';
-                        }
-                        else {
-                            // 0001 (1)
-                            return '1';
-                        }
-                    }
-                    else {
-                        // 001-
-                        if (nibble[3] == '0') {
-                            // 0010 (2)
-                            return '2';
-                        }
-                        else {
-                            // 0011 (3)
-                            return '3';
-                        }
-                    }
-                }
-                else {
-                    // 01--
-                    if (nibble[2] == '0') {
-                        // 010-
-                        if (nibble[3] == '0') {
-                            // 0100 (4)
-                            return '4';
-                        }
-                        else {
-                            // 0101 (5)
-                            return '5';
-                        }
-                    }
-                    else {
-                        // 011-
-                        if (nibble[3] == '0') {
-                            // 0110 (6)
-                            return '6';
-                        }
-                        else {
-                            // 0111 (7)
-                            return '7';
-                        }
-                    }
-                }
-            }
-            else {
-                // 1---
-                if (nibble[1] == '0') {
-                    // 10--
-                    if (nibble[2] == '0') {
-                        // 100-
-                        if (nibble[3] == '0') {
-                            // 1000 (8)
-                            return '8';
-                        }
-                        else {
-                            // 1001 (9)
-                            return '9';
-                        }
-                    }
-                    else {
-                        if (nibble[3] == '0') {
-                            // 1010 (10)
-                            return 'a';
-                        }
-                        else {
-                            // 1011 (11)
-                            return 'b';
-                        }
-                    }
-                }
-                else {
-                    // 11--
-                    if (nibble[2] == '0') {
-                        // 110-
-                        if (nibble[3] == '0') {
-                            // 1100 (12)
-                            return 'c';
-                        }
-                        else {
-                            // 1101 (13)
-                            return 'd';
-                        }
-                    }
-                    else {
-                        // 111-
-                        if (nibble[3] == '0') {
-                            // 1110 (14)
-                            return 'e';
-                        }
-                        else {
-                            // 1111 (15)
-                            return 'f';
-                        }
-                    }
-                }
+        
+        void formatting_group_access_error(std::string_view function) {
+            throw FormattedError("bad format specification access - {} called on formatting group list", function);
+        }
+        
+        void unterminated_placeholder_error(std::size_t position, std::source_location source) {
+            throw std::runtime_error(utils::format("unterminated placeholder opening brace at position {} - opening brace literals must be escaped as '{{{{' ({})", position, source));
+        }
+        
+        void unescaped_closing_brace_error(std::size_t position, std::source_location source) {
+            throw std::runtime_error(utils::format("invalid placeholder closing brace at position {} - closing brace literals must be escaped as '}}}}' ({})", position, source));
+        }
+        
+        void invalid_character_error(char c, std::size_t position, std::source_location source) {
+            if (c == '\0') {
+                throw std::runtime_error(utils::format("unexpected end of format string at position {} ({})", position, source));
             }
+            
+            throw std::runtime_error(utils::format("invalid character '{}' at position {} ({})", c, position, source));
+        }
+        
+        void heterogeneous_placeholders_error(std::source_location source) {
+            throw std::runtime_error(utils::format("invalid format string - placeholder types must be homogeneous ({})", source));
+        }
+        
+        void missing_argument_error(std::size_t placeholder, std::size_t position, std::source_location source) {
+            throw std::runtime_error(utils::format("invalid format string - missing argument for placeholder {} at position {} ({})", placeholder, position, source));
+        }
+        
+        void missing_named_argument_error(std::string_view name, std::size_t position, std::source_location source) {
+            throw std::runtime_error(utils::format("invalid format string - missing NamedArgument for placeholder '{}' at position {} ({})", name, position, source));
+        }
+        
+        void not_enough_arguments_error(std::size_t expected, std::size_t received, std::source_location source) {
+            throw std::runtime_error(utils::format("not enough arguments provided to format(...) - expecting: {}, received: {} ({})", expected, received, source));
+        }
+        
+        void argument_order_error(std::size_t index, std::source_location source) {
+            throw std::runtime_error(utils::format("invalid argument at position {} - arguments for positional placeholders must come before arguments for named placeholders ({})", index, source));
         }
         
-        std::string format_no_args(std::string_view fmt, std::source_location source) {
+        void format_no_args(std::string_view fmt, std::source_location source, FormatBuffer& out) {
             std::size_t length = fmt.length();
             std::size_t last_read_position = 0u;
             std::size_t i = 0u;
             
-            std::string out;
-            
-            while (i < length) {
+            while (true) {
+                // Skip to the next opening / closing brace, literal characters in between are appended in bulk
+                i = find_first_of(fmt, i, "{}");
+                if (i == length) {
+                    break;
+                }
+                
                 if (fmt[i] == '{') {
                     if (i + 1 == length) {
-                        throw std::runtime_error(utils::format("unterminated placeholder opening brace at position {} - opening brace literals must be escaped as '}}' ()", i, source));
+                        unterminated_placeholder_error(i, source);
                     }
                     else if (fmt[i + 1] == '{') {
                         // Escaped opening brace '{{'
-                        out.append(fmt, last_read_position, i - last_read_position + 1u); // Include the first opening brace
+                        out.append(fmt.substr(last_read_position, i - last_read_position + 1u)); // Include the first opening brace
                         
                         ++i;
                         last_read_position = i + 1u; // Skip to the next character after the second brace
                     }
                     else {
                         // format(...) was called with no arguments, so the existence of any placeholders is invalid
-                        throw std::runtime_error(utils::format("invalid format string - missing argument for placeholder at position {} ()", i, source));
+                        throw std::runtime_error(utils::format("invalid format string - missing argument for placeholder at position {} ({})", i, source));
                     }
                 }
-                else if (fmt[i] == '}') {
+                else { // if (fmt[i] == '}') {
                     if (i + 1 < length && fmt[i + 1] == '}') {
                         // Escaped closing brace '}}'
-                        out.append(fmt, last_read_position, i - last_read_position + 1u); // Include the first opening brace
+                        out.append(fmt.substr(last_read_position, i - last_read_position + 1u)); // Include the first opening brace
                         
                         ++i;
                         last_read_position = i + 1u; // Skip to the next character after the second brace
                     }
                     else {
-                        throw std::runtime_error(utils::format("invalid placeholder closing brace at position {} - closing brace literals must be escaped as '}}' ()", i, source));
+                        unescaped_closing_brace_error(i, source);
                     }
                 }
                 
@@ -425,58 +658,93 @@ namespace utils {
             
             if (i != last_read_position) {
                 // Append any remaining characters
-                out.append(fmt, last_read_position, i - last_read_position);
+                out.append(fmt.substr(last_read_position, i - last_read_position));
+            }
+        }
+        
+        FixedBuffer::FixedBuffer(char* out, std::size_t capacity) : FormatBuffer(out, 0u, capacity),
+                                                                    m_out(out),
+                                                                    m_limit(capacity),
+                                                                    m_count(0u),
+                                                                    m_scratch() {
+        }
+        
+        FixedBuffer::~FixedBuffer() = default;
+        
+        std::size_t FixedBuffer::count() const {
+            return m_count + m_size;
+        }
+        
+        std::size_t FixedBuffer::written() const {
+            return std::min(count(), m_limit);
+        }
+        
+        void FixedBuffer::grow(std::size_t) {
+            if (m_size < m_capacity) {
+                // Storage is not yet full (reserve), characters are written up until the end of the provided memory
+                return;
             }
             
-            return std::move(out);
+            // Discard any further characters, only keeping track of how many there are
+            m_count += m_size;
+            m_data = m_scratch;
+            m_size = 0u;
+            m_capacity = sizeof(m_scratch);
         }
         
     }
 
     [[nodiscard]] std::vector<std::string_view> split(std::string_view in, std::string_view delimiter) {
         std::vector<std::string_view> components { };
-
-        std::size_t position;
-        do {
-            position = in.find(delimiter);
-            components.emplace_back(in.substr(0, position));
-            in = in.substr(position + delimiter.length());
+        
+        for (std::string_view component : split_view(in, delimiter)) {
+            components.emplace_back(component);
         }
-        while (position != std::string::npos);
 
         return std::move(components);
     }
-
-    [[nodiscard]] std::string_view trim(std::string_view in) {
-        if (in.empty()) {
-            return "";
-        }
-
-        std::size_t start = 0;
-        while (std::isspace(in[start])) {
-            ++start;
+    
+    std::size_t split_into(std::string_view in, std::string_view delimiter, std::span<std::string_view> out) {
+        if (out.empty()) {
+            return 0u;
         }
-
-        std::size_t end = in.length() - 1;
-        while (end != start && std::isspace(in[end])) {
-            --end;
+        
+        std::size_t count = 0u;
+        std::size_t position = 0u;
+        
+        while (count + 1u < out.size()) {
+            std::size_t end = detail::find_delimiter(in, position, delimiter);
+            out[count++] = in.substr(position, end - position);
+            
+            if (end == in.length()) {
+                return count;
+            }
+            position = end + delimiter.length();
         }
+        
+        // Last element receives the remainder of the input
+        out[count++] = in.substr(position);
+        return count;
+    }
 
-        return in.substr(start, end + 1);
+    [[nodiscard]] std::string_view trim(std::string_view in) {
+        return ascii::trim(in);
     }
 
     template <typename T>
-    inline std::size_t fundamental_from_string(std::string_view in, T& out) {
-        // Leading whitespace is not ignored
+    ParseResult<T, ParseError> parse_fundamental(std::string_view in) {
+        // Leading and trailing whitespace is ignored, but still counts towards the number of characters processed
         std::string_view str = trim(in);
+        std::size_t offset = str.data() - in.data();
 
         if (str.empty()) {
-            // throw FormattedError("");
+            return ParseResult<T, ParseError>::NOT_OK(in.length(), ParseError::Empty);
         }
 
         // Only a leading '-' is permitted at the beginning
         if (str[0] == '+') {
             str = str.substr(1);
+            ++offset;
         }
 
         // Leading base prefixes are not recognized
@@ -500,36 +768,220 @@ namespace utils {
 
         if (has_base) {
             str = str.substr(2);
+            offset += 2;
         }
 
         const char* start = str.data();
         const char* end = start + str.length();
-
+        
+        T value { };
         std::from_chars_result result { };
 
         if constexpr (is_integer_type<T>::value) {
-            result = std::from_chars(start, end, out, base);
+            result = std::from_chars(start, end, value, base);
         }
         else {
             // std::format_chars::general supports both scientific and fixed representations
-            result = std::from_chars(start, end, out, std::chars_format::general);
+            result = std::from_chars(start, end, value, std::chars_format::general);
         }
 
         const auto& [ptr, error_code] = result;
 
         if (error_code == std::errc::invalid_argument) {
-            // failed to convert
-            throw FormattedError("");
+            // Failed to convert
+            return ParseResult<T, ParseError>::NOT_OK(offset, ParseError::InvalidArgument);
         }
 
         if (error_code == std::errc::result_out_of_range) {
-            out = std::numeric_limits<T>::max();
+            return ParseResult<T, ParseError>::NOT_OK(offset, ParseError::OutOfRange);
+        }
+        
+        // Trailing whitespace is considered processed only if the entire number was consumed
+        std::size_t num_characters_processed = offset + (ptr - start);
+        if (ptr == end) {
+            num_characters_processed = in.length();
         }
 
-        // Return the number of characters processed
-        return ptr - start;
+        return ParseResult<T, ParseError>::OK(num_characters_processed, value);
     }
 
+    template <typename T>
+    std::size_t fundamental_from_string(std::string_view in, T& out) {
+        ParseResult<T, ParseError> result = parse_fundamental<T>(in);
+        
+        if (!result.ok()) {
+            switch (result.error()) {
+                case ParseError::Empty:
+                    throw FormattedError("failed to parse '{}' - input is empty", in);
+                case ParseError::InvalidArgument:
+                    throw FormattedError("failed to parse '{}' - invalid character at position {}", in, result.offset());
+                case ParseError::OutOfRange:
+                    throw FormattedError("failed to parse '{}' - value is out of range", in);
+            }
+        }
+        
+        out = result.result();
+        return result.offset();
+    }
+    
+    namespace detail {
+        
+        // Fast path for decimal integers (with an optional leading '-' for signed types) at the start of [current, end)
+        // Returns a pointer past the last digit, or nullptr if the value must be handled by the general implementation instead
+        template <typename T>
+        const char* parse_decimal(const char* current, const char* end, T& out) {
+            bool negative = false;
+            if constexpr (std::is_signed<T>::value) {
+                if (current != end && *current == '-') {
+                    negative = true;
+                    ++current;
+                }
+            }
+            
+            const char* first = current;
+            std::uint64_t value = 0u;
+            
+            if constexpr (swar_available) {
+                while (end - current >= 8) {
+                    std::uint64_t chunk;
+                    std::memcpy(&chunk, current, sizeof(chunk));
+                    
+                    if (!is_eight_digits(chunk)) {
+                        break;
+                    }
+                    
+                    value = value * 100000000u + parse_eight_digits(chunk);
+                    current += 8;
+                    
+                    if (current - first > std::numeric_limits<T>::digits10) {
+                        return nullptr;
+                    }
+                }
+            }
+            
+            while (current != end) {
+                unsigned digit = static_cast<unsigned char>(*current) - '0';
+                if (digit > 9u) {
+                    break;
+                }
+                
+                value = value * 10u + digit;
+                ++current;
+            }
+            
+            // Values with at most digits10 digits are guaranteed to be representable by T, longer values may overflow
+            std::ptrdiff_t num_digits = current - first;
+            if (num_digits == 0 || num_digits > std::numeric_limits<T>::digits10) {
+                return nullptr;
+            }
+            
+            out = negative ? static_cast<T>(T(0) - static_cast<T>(value)) : static_cast<T>(value);
+            return current;
+        }
+        
+        // Fast path for values at the start of [current, end) that are written in their simplest form (no surrounding whitespace, leading '+', or base prefix)
+        // Returns a pointer past the value, or nullptr if the value must be handled by the general implementation instead
+        template <typename T>
+        const char* parse_prefix(const char* current, const char* end, T& out) {
+            if constexpr (is_integer_type<T>::value) {
+                return parse_decimal(current, end, out);
+            }
+            else {
+                const auto& [ptr, error_code] = std::from_chars(current, end, out, std::chars_format::general);
+                return error_code == std::errc() ? ptr : nullptr;
+            }
+        }
+        
+        // Returns whether 'field' was parsed successfully, fields must consist of exactly one number (surrounded by optional whitespace)
+        template <typename T>
+        bool parse_field(std::string_view field, T& out) {
+            const char* end = field.data() + field.length();
+            if (parse_prefix(field.data(), end, out) == end) {
+                return true;
+            }
+            
+            ParseResult<T, ParseError> result = parse_fundamental<T>(field);
+            if (!result.ok() || result.offset() != field.length()) {
+                out = T { };
+                return false;
+            }
+            
+            out = result.result();
+            return true;
+        }
+        
+    }
+    
+    template <typename T>
+    ParseResult<T, ParseError> from_string(std::string_view in) {
+        return parse_fundamental<T>(in);
+    }
+    
+    template <typename T>
+    BulkParseResult from_string(std::span<const std::string_view> in, std::span<T> out) {
+        BulkParseResult result { 0u, 0u, 0u };
+        
+        std::size_t count = std::min(in.size(), out.size());
+        for (std::size_t i = 0u; i < count; ++i) {
+            detail::record_field(detail::parse_field(in[i], out[i]), result);
+        }
+        
+        if (result.num_errors == 0u) {
+            result.first_error = result.count;
+        }
+        return result;
+    }
+    
+    template <typename T>
+    BulkParseResult parse_column(std::string_view buffer, char delimiter, std::span<T> out) {
+        BulkParseResult result { 0u, 0u, 0u };
+        
+        const char* data = buffer.data();
+        std::size_t length = buffer.length();
+        std::size_t position = 0u;
+        
+        while (position < length && result.count < out.size()) {
+            // Fields written in their simplest form are scanned only once
+            const char* stop = detail::parse_prefix(data + position, data + length, out[result.count]);
+            if (stop && (stop == data + length || *stop == delimiter)) {
+                detail::record_field(true, result);
+                position = stop - data + 1u;
+                continue;
+            }
+            
+            // std::memchr is vectorized by all major standard library implementations
+            const void* next = std::memchr(data + position, delimiter, length - position);
+            std::size_t end = next ? static_cast<const char*>(next) - data : length;
+            detail::record_field(detail::parse_field(buffer.substr(position, end - position), out[result.count]), result);
+            position = end + 1u;
+        }
+        
+        if (result.num_errors == 0u) {
+            result.first_error = result.count;
+        }
+        return result;
+    }
+    
+    #define UTILS_INSTANTIATE_FROM_STRING(T)                                                                     \
+        template ParseResult<T, ParseError> from_string<T>(std::string_view in);                                 \
+        template BulkParseResult from_string<T>(std::span<const std::string_view> in, std::span<T> out);         \
+        template BulkParseResult parse_column<T>(std::string_view buffer, char delimiter, std::span<T> out);
+    
+    UTILS_INSTANTIATE_FROM_STRING(unsigned char)
+    UTILS_INSTANTIATE_FROM_STRING(short)
+    UTILS_INSTANTIATE_FROM_STRING(unsigned short)
+    UTILS_INSTANTIATE_FROM_STRING(int)
+    UTILS_INSTANTIATE_FROM_STRING(unsigned)
+    UTILS_INSTANTIATE_FROM_STRING(long)
+    UTILS_INSTANTIATE_FROM_STRING(unsigned long)
+    UTILS_INSTANTIATE_FROM_STRING(long long)
+    UTILS_INSTANTIATE_FROM_STRING(unsigned long long)
+    UTILS_INSTANTIATE_FROM_STRING(float)
+    UTILS_INSTANTIATE_FROM_STRING(double)
+    UTILS_INSTANTIATE_FROM_STRING(long double)
+    
+    #undef UTILS_INSTANTIATE_FROM_STRING
+
     std::size_t from_string(std::string_view in, unsigned char& out) {
         return fundamental_from_string(in, out);
     }
@@ -580,70 +1032,136 @@ namespace utils {
 
     // FormatSpec implementation
     
-    FormatSpec::FormatSpec() : m_spec(std::monostate { }),
-                               m_type(Type::SpecifierList) {
+    FormatSpec::FormatSpec() : FormatSpec(nullptr) {
     }
-
-    FormatSpec::FormatSpec(SpecifierList&& specifiers) : m_spec(std::move(specifiers)),
-                                                         m_type(Type::SpecifierList) {
+    
+    FormatSpec::FormatSpec(std::pmr::memory_resource* resource) : m_arena(),
+                                                                  m_resource(resource),
+                                                                  m_specifiers(m_inline),
+                                                                  m_groups(nullptr),
+                                                                  m_size(0u),
+                                                                  m_capacity(inline_capacity),
+                                                                  m_type(Type::SpecifierList),
+                                                                  m_inline() {
     }
     
-    FormatSpec::FormatSpec(const FormatSpec& other) {
+    FormatSpec::FormatSpec(const FormatSpec& other) : FormatSpec() {
         *this = other;
     }
-    
-    FormatSpec::FormatSpec(FormatSpec&& other) noexcept {
-        if (*this != other) {
-            m_type = other.m_type;
-            m_spec = std::move(other.m_spec);
-        }
+
+    FormatSpec::FormatSpec(FormatSpec&& other) noexcept : FormatSpec() {
+        *this = std::move(other);
     }
     
     FormatSpec& FormatSpec::operator=(const FormatSpec& other) {
-        if (*this == other) {
+        if (this == &other) {
             return *this;
         }
         
-        if (std::holds_alternative<std::monostate>(other.m_spec)) {
-            // Assigning to a FormatSpec that currently has no data
-            if (!std::holds_alternative<std::monostate>(m_spec) && m_type == Type::FormattingGroupList) {
-                for (FormatSpec* spec : std::get<FormattingGroupList>(m_spec)) {
-                    delete spec;
-                }
+        clear();
+        
+        if (other.m_type == Type::SpecifierList) {
+            for (std::size_t i = 0u; i < other.m_size; ++i) {
+                append_specifier(copy(other.m_specifiers[i].name), copy(other.m_specifiers[i].value));
             }
-            // Reset to defaults
-            m_type = Type::SpecifierList;
-            m_spec = std::monostate { }; // std::vector assignment operator automatically cleans up specifier memory when m_spec is of type SpecifierList
         }
         else {
-            m_type = other.m_type;
+            // Perform a deep copy of nested formatting groups
+            m_type = Type::FormattingGroupList;
+            m_capacity = 0u;
             
-            if (other.m_type == Type::SpecifierList) {
-                // Vector of specifiers can be copied directly
-                m_spec = other.m_spec;
-            }
-            else {
-                FormattingGroupList groups = FormattingGroupList();
-                
-                // Perform a deep copy of nested formatting groups
-                for (const FormatSpec* spec : std::get<FormattingGroupList>(other.m_spec)) {
-                    groups.emplace_back(new FormatSpec(*spec));
+            for (std::size_t i = 0u; i < other.m_size; ++i) {
+                if (other.m_groups[i]) {
+                    get_group(i) = *other.m_groups[i];
                 }
-                
-                m_spec = std::move(groups);
             }
         }
         
         return *this;
     }
     
-    FormatSpec::~FormatSpec() {
-        if (m_type == Type::FormattingGroupList) {
-            FormattingGroupList& groups = std::get<FormattingGroupList>(m_spec);
-            for (FormatSpec* spec : groups) {
-                delete spec;
+    FormatSpec& FormatSpec::operator=(FormatSpec&& other) noexcept {
+        if (this == &other) {
+            return *this;
+        }
+        
+        // Ownership of the arena (and therefore of any nested formatting groups) is transferred
+        m_arena = std::move(other.m_arena);
+        m_resource = other.m_resource;
+        m_groups = other.m_groups;
+        m_size = other.m_size;
+        m_type = other.m_type;
+        
+        m_capacity = other.m_capacity;
+        
+        if (other.m_specifiers == other.m_inline) {
+            // Specifiers stored in line must be copied, formatting groups are always allocated from the arena
+            if (m_type == Type::SpecifierList) {
+                std::copy_n(other.m_inline, other.m_size, m_inline);
             }
+            m_specifiers = m_inline;
+        }
+        else {
+            m_specifiers = other.m_specifiers;
         }
+        
+        // Reset 'other' to defaults
+        other.m_resource = nullptr;
+        other.clear();
+        
+        return *this;
+    }
+    
+    FormatSpec::~FormatSpec() = default;
+    
+    std::pmr::memory_resource* FormatSpec::arena() {
+        if (!m_resource) {
+            m_arena = std::make_unique<std::pmr::monotonic_buffer_resource>();
+            m_resource = m_arena.get();
+        }
+        return m_resource;
+    }
+    
+    void FormatSpec::append_specifier(std::string_view name, std::string_view value) {
+        if (m_size == m_capacity) {
+            // Spill specifiers into the arena
+            std::size_t capacity = m_capacity * 2u;
+            SpecifierView* specifiers = static_cast<SpecifierView*>(arena()->allocate(capacity * sizeof(SpecifierView), alignof(SpecifierView)));
+            
+            std::uninitialized_copy_n(m_specifiers, m_size, specifiers);
+            m_specifiers = specifiers;
+            m_capacity = capacity;
+        }
+        
+        m_specifiers[m_size++] = { name, value };
+    }
+    
+    std::string_view FormatSpec::copy(std::string_view value) {
+        if (value.empty()) {
+            return { };
+        }
+        
+        char* storage = static_cast<char*>(arena()->allocate(value.length(), alignof(char)));
+        std::memcpy(storage, value.data(), value.length());
+        return { storage, value.length() };
+    }
+    
+    void FormatSpec::reserve_groups(std::size_t capacity) {
+        // Formatting groups are stored as a sparse array of pointers
+        FormatSpec** groups = static_cast<FormatSpec**>(arena()->allocate(capacity * sizeof(FormatSpec*), alignof(FormatSpec*)));
+        
+        std::copy_n(m_groups, m_size, groups);
+        std::fill(groups + m_size, groups + capacity, nullptr);
+        m_groups = groups;
+        m_capacity = capacity;
+    }
+    
+    void FormatSpec::clear() {
+        m_specifiers = m_inline;
+        m_groups = nullptr;
+        m_size = 0u;
+        m_capacity = inline_capacity;
+        m_type = Type::SpecifierList;
     }
     
     FormatSpec::Type FormatSpec::type() const {
@@ -651,29 +1169,11 @@ namespace utils {
     }
 
     std::size_t FormatSpec::size() const {
-        static const auto visitor = []<typename T>(const T& data) -> std::size_t {
-            if constexpr (std::is_same<T, std::monostate>::value) {
-                return 0;
-            }
-            else {
-                // SpecifierList and FormattingGroupList are both std::vector types
-                return data.size();
-            }
-        };
-        return std::visit(visitor, m_spec);
+        return m_size;
     }
 
     bool FormatSpec::empty() const {
-        static const auto visitor = []<typename T>(const T& data) -> bool {
-            if constexpr (std::is_same<T, std::monostate>::value) {
-                return true;
-            }
-            else {
-                // SpecifierList and FormattingGroupList are both std::vector types
-                return data.empty();
-            }
-        };
-        return std::visit(visitor, m_spec);
+        return m_size == 0u;
     }
 
     bool FormatSpec::operator!=(const FormatSpec& other) const {
@@ -681,125 +1181,75 @@ namespace utils {
     }
     
     bool FormatSpec::operator==(const FormatSpec& other) const {
-        if (std::holds_alternative<std::monostate>(m_spec)) {
-            if (std::holds_alternative<std::monostate>(other.m_spec)) {
-                return true;
-            }
-            else {
-                return false;
-            }
+        if (empty() && other.empty()) {
+            return true;
         }
-        else {
-            if (std::holds_alternative<std::monostate>(other.m_spec)) {
-                return false;
-            }
-            else {
-                if (m_type != other.m_type) {
-                    return false;
-                }
+        
+        if (m_type != other.m_type || m_size != other.m_size) {
+            return false;
+        }
+        
+        for (std::size_t i = 0u; i < m_size; ++i) {
+            if (m_type == Type::SpecifierList) {
+                // Compare specifier values
+                const SpecifierView& specifier = m_specifiers[i];
+                const SpecifierView& other_specifier = other.m_specifiers[i];
                 
-                std::size_t _size = size();
-                if (_size != other.size()) {
+                if (!icasecmp(specifier.name, other_specifier.name) || !icasecmp(specifier.value, other_specifier.value)) {
                     return false;
                 }
+            }
+            else {
+                // Compare nested formatting groups
+                const FormatSpec* group = m_groups[i];
+                const FormatSpec* other_group = other.m_groups[i];
                 
-                if (m_type == Type::SpecifierList) {
-                    // Compare specifier values
-                    const SpecifierList& specifiers = std::get<SpecifierList>(m_spec);
-                    const SpecifierList& other_specifiers = std::get<SpecifierList>(other.m_spec);
-                    
-                    for (std::size_t i = 0; i < _size; ++i) {
-                        if (specifiers[i] != other_specifiers[i]) {
-                            return false;
-                        }
-                    }
-                }
-                else {
-                    // Compare nested formatting groups
-                    const FormattingGroupList& groups = std::get<FormattingGroupList>(m_spec);
-                    const FormattingGroupList& other_groups = std::get<FormattingGroupList>(other.m_spec);
-    
-                    for (std::size_t i = 0; i < _size; ++i) {
-                        // Compare pointers
-                        if (!groups[i] && !other_groups[i]) {
-                            continue;
-                        }
-                        if (!groups[i] && other_groups[i] || groups[i] && !other_groups[i]) {
-                            return false;
-                        }
-    
-                        // Compare nested format specs
-                        if (*(groups[i]) != *(other_groups[i])) {
-                            return false;
-                        }
+                if (!group || !other_group) {
+                    if (group != other_group) {
+                        return false;
                     }
+                    continue;
                 }
                 
-                return true;
+                if (*group != *other_group) {
+                    return false;
+                }
             }
         }
+        
+        return true;
     }
 
-    void FormatSpec::set_specifier(std::string_view key, std::string value) {
-        if (std::holds_alternative<std::monostate>(m_spec)) {
-            m_spec = SpecifierList();
-            m_type = Type::SpecifierList;
-        }
-        else if (m_type == Type::FormattingGroupList) {
+    void FormatSpec::set_specifier(std::string_view key, std::string_view value) {
+        if (m_type == Type::FormattingGroupList) {
             // Format specifier-related functions are not available on formatting group lists
             throw FormattedError("bad and/or ambiguous format specification access - specification contains nested formatting group(s) and cannot be accessed by specifier (key: '{}')", key);
         }
 
-        SpecifierList& specifiers = std::get<SpecifierList>(m_spec);
-        for (Specifier& specifier : specifiers) {
-            if (icasecmp(specifier.name, key)) {
-                specifier.value = std::move(value);
+        for (std::size_t i = 0u; i < m_size; ++i) {
+            if (icasecmp(m_specifiers[i].name, key)) {
+                m_specifiers[i].value = copy(value);
                 return;
             }
         }
 
         // Specifier not found, create a new entry
-        specifiers.emplace_back(std::string(key), std::move(value));
-    }
-
-    std::string& FormatSpec::operator[](std::string_view key) {
-        return get_specifier(key);
+        append_specifier(copy(key), copy(value));
     }
 
     std::string_view FormatSpec::operator[](std::string_view key) const {
         return get_specifier(key);
     }
 
-    std::string& FormatSpec::get_specifier(std::string_view key) {
-        if (std::holds_alternative<std::monostate>(m_spec)) {
-            m_spec = SpecifierList();
-            m_type = Type::SpecifierList;
-        }
-        else if (m_type == Type::FormattingGroupList) {
-            // Format specifier-related functions are not available on formatting group lists
-            throw FormattedError("bad and/or ambiguous format specification access - specification contains nested formatting group(s) and cannot be accessed by specifier (key: '{}')", key);
-        }
-
-        SpecifierList& specifiers = std::get<SpecifierList>(m_spec);
-        for (Specifier& specifier : specifiers) {
-            if (icasecmp(specifier.name, key)) {
-                return specifier.value;
-            }
-        }
-
-        // Specifier was not found, create a new entry
-        return specifiers.emplace_back(std::string(key), "").value;
-    }
-
     std::string_view FormatSpec::get_specifier(std::string_view key) const {
         if (m_type == Type::FormattingGroupList) {
             // Format specifier-related functions are not available on formatting group lists
             throw FormattedError("bad and/or ambiguous format specification access - specification contains nested formatting group(s) and cannot be accessed by specifier (key: '{}')", key);
         }
 
-        for (const Specifier& specifier : std::get<SpecifierList>(m_spec)) {
-            if (icasecmp(specifier.name, key)) {
-                return specifier.value;
+        for (std::size_t i = 0u; i < m_size; ++i) {
+            if (icasecmp(m_specifiers[i].name, key)) {
+                return m_specifiers[i].value;
             }
         }
 
@@ -823,30 +1273,39 @@ namespace utils {
                 // get_group(0) - continue treating this as a specifier list
                 return *this;
             }
-            else {
-                // When an additional group is requested, convert internal structure to a formatting group list
-                // This first requires the conversion of this (specifier list) to the first formatting group
-                if (empty()) {
-                    m_spec = FormattingGroupList();
-                }
-                else {
-                    m_spec = FormattingGroupList { new FormatSpec(std::move(std::get<SpecifierList>(m_spec))) };
+            
+            // When an additional group is requested, convert internal structure to a formatting group list
+            // This first requires the conversion of this (specifier list) to the first formatting group
+            FormatSpec* first = nullptr;
+            if (!empty()) {
+                first = new (arena()->allocate(sizeof(FormatSpec), alignof(FormatSpec))) FormatSpec(arena());
+                for (std::size_t i = 0u; i < m_size; ++i) {
+                    first->append_specifier(m_specifiers[i].name, m_specifiers[i].value);
                 }
-                
-                m_type = Type::FormattingGroupList;
+            }
+            
+            clear();
+            m_type = Type::FormattingGroupList;
+            m_capacity = 0u;
+            
+            if (first) {
+                reserve_groups(index + 1u);
+                m_groups[0] = first;
+                m_size = 1u;
             }
         }
 
-        FormattingGroupList& groups = std::get<FormattingGroupList>(m_spec);
-        while (index >= groups.size()) {
-            // Allow a sparse vector of formatting groups to save on memory use
-            groups.emplace_back(nullptr);
+        if (index >= m_capacity) {
+            reserve_groups(std::max(index + 1u, m_capacity * 2u));
         }
+        
+        m_size = std::max(m_size, index + 1u);
 
-        if (!groups[index]) {
-            groups[index] = new FormatSpec();
+        if (!m_groups[index]) {
+            // Nested formatting groups share the arena of the outermost spec, and are released with it
+            m_groups[index] = new (arena()->allocate(sizeof(FormatSpec), alignof(FormatSpec))) FormatSpec(arena());
         }
-        return *groups[index];
+        return *m_groups[index];
     }
 
     const FormatSpec& FormatSpec::get_group(std::size_t index) const {
@@ -854,78 +1313,72 @@ namespace utils {
             throw FormattedError("bad format specification access - formatting group {} contains a mapping of specifier name/value pairs and cannot be accessed by index", index);
         }
 
-        const FormattingGroupList& groups = std::get<FormattingGroupList>(m_spec);
-        if (index < groups.size()) {
-            return *groups[index];
+        if (index < m_size && m_groups[index]) {
+            return *m_groups[index];
         }
 
         throw FormattedError("bad format specification access - formatting group {} does not exist (index out of bounds)", index);
     }
 
     bool FormatSpec::has_group(std::size_t index) const {
-        if (std::holds_alternative<std::monostate>(m_spec)) {
-            // Uninitialized format spec
-            return false;
-        }
-        else if (m_type == Type::SpecifierList) {
+        if (m_type == Type::SpecifierList) {
+            if (empty()) {
+                // Uninitialized format spec
+                return false;
+            }
             throw FormattedError("bad format specification access - has_group called on specifier list");
         }
 
-        const FormattingGroupList& groups = std::get<FormattingGroupList>(m_spec);
-        return index < groups.size() && groups[index];
-    }
-
-    bool FormatSpec::has_specifier(std::string_view key) const {
-        if (std::holds_alternative<std::monostate>(m_spec)) {
-            // Uninitialized format spec
-            return false;
-        }
-        else if (m_type == Type::FormattingGroupList) {
-            throw FormattedError("bad format specification access - has_specifier called on formatting group list");
-        }
-        
-        for (const Specifier& specifier : std::get<SpecifierList>(m_spec)) {
-            if (icasecmp(specifier.name, key)) {
-                return true;
+        return index < m_size && m_groups[index];
+    }
+
+    CompiledFormat::CompiledFormat(std::string_view format, std::source_location source) : m_format(format),
+                                                                                           m_source(source),
+                                                                                           m_segments(),
+                                                                                           m_placeholders(),
+                                                                                           m_type(detail::Identifier::Type::Auto),
+                                                                                           m_length(0u) {
+        detail::parse_format_string(m_format, m_source, [this](std::string_view literal) {
+            m_segments.push_back({ Segment::Type::Literal, literal, 0u });
+            m_length += literal.length();
+        }, [this](const detail::Identifier& identifier, std::string_view format_spec, std::size_t position) {
+            if (m_placeholders.empty()) {
+                // The identifier of the first placeholder dictates the type of format string
+                m_type = identifier.type;
+            }
+            
+            FormatSpec spec { };
+            if (!format_spec.empty()) {
+                detail::parse_format_spec(format_spec, spec);
             }
-        }
 
-        return false;
-    }
-    
-    FormatSpec::Specifier::Specifier(std::string name, std::string value) : name(std::move(name)),
-                                                                            value(std::move(value)) {
+            m_segments.push_back({ Segment::Type::Placeholder, { }, m_placeholders.size() });
+            m_placeholders.push_back({ identifier, std::move(spec), position });
+        });
     }
 
-    FormatSpec::Specifier::~Specifier() = default;
+    CompiledFormat::~CompiledFormat() = default;
 
-    FormatSpec::Specifier& FormatSpec::Specifier::operator=(std::string other) {
-        value = std::move(other);
-        return *this;
+    std::string_view CompiledFormat::format() const {
+        return m_format;
     }
 
-    bool FormatSpec::Specifier::operator==(const FormatSpec::Specifier& other) const {
-        return icasecmp(name, other.name) && icasecmp(value, other.value);
+    std::source_location CompiledFormat::source() const {
+        return m_source;
     }
 
-    bool FormatSpec::Specifier::operator!=(const FormatSpec::Specifier& other) const {
-        return !(*this == other);
-    }
-    
-    FormatString::FormatString(const std::string& format, std::source_location source) : format(format),
-                                                                                         source(source) {
+    std::size_t CompiledFormat::size() const {
+        return m_placeholders.size();
     }
-    
-    FormatString::FormatString(std::string_view format, std::source_location source) : format(format),
-                                                                                       source(source) {
+
+    bool CompiledFormat::empty() const {
+        return m_placeholders.empty();
     }
-    
-    FormatString::FormatString(const char* format, std::source_location source) : format(format),
-                                                                                  source(source) {
+
+    CompiledFormat compile_format(std::string_view format, std::source_location source) {
+        return CompiledFormat(format, source);
     }
-    
-    FormatString::~FormatString() = default;
-    
+
     FormatterBase::FormatterBase() : justification(Justification::Left),
                                      width(0),
                                      fill_character(' ') {
@@ -971,22 +1424,65 @@ namespace utils {
     }
     
     std::string FormatterBase::format(const char* value, std::size_t length) const {
-        std::size_t capacity = std::max(length, width);
-        std::string result(capacity, fill_character);
+        std::string result;
+        
+        {
+            detail::StringBuffer buffer(result);
+            format_to(value, length, buffer);
+        }
+        
+        return result;
+    }
+    
+    void FormatterBase::format_to(const char* value, std::size_t length, FormatBuffer& out) const {
+        if (length >= width) {
+            // No justification necessary
+            out.append(value, length);
+            return;
+        }
+        
+        std::size_t padding = width - length;
         
-        std::size_t write_position;
+        std::size_t leading;
         if (justification == Justification::Left) {
-            write_position = 0;
+            leading = 0;
         }
         else if (justification == Justification::Right) {
-            write_position = capacity - length;
+            leading = padding;
         }
         else {
-            write_position = (capacity - length) / 2;
+            leading = padding / 2;
+        }
+        
+        out.append(leading, fill_character);
+        out.append(value, length);
+        out.append(padding - leading, fill_character);
+    }
+    
+    ContainerFormatterBase::ContainerFormatterBase() : FormatterBase(),
+                                                       max_elements(),
+                                                       truncation_marker("...") {
+    }
+    
+    ContainerFormatterBase::~ContainerFormatterBase() = default;
+    
+    void ContainerFormatterBase::parse(const FormatSpec& spec) {
+        FormatterBase::parse(spec);
+        
+        if (spec.has_specifier("max_elements", "maxelements")) {
+            std::string_view value = trim(spec.get_specifier("max_elements", "maxelements").value);
+            
+            std::size_t _max_elements;
+            std::size_t num_characters_read = from_string(value, _max_elements);
+            
+            if (num_characters_read > 0) {
+                max_elements = _max_elements;
+            }
+        }
+        
+        if (spec.has_specifier("truncation_marker", "truncationmarker")) {
+            truncation_marker = spec.get_specifier("truncation_marker", "truncationmarker").value;
         }
-
-        result.replace(write_position, length, value, length);
-        return std::move(result);
     }
     
     Formatter<char>::Formatter() : FormatterBase() {
@@ -1000,7 +1496,11 @@ namespace utils {
     }
     
     std::string Formatter<char>::format(char c) const {
-        return std::move(FormatterBase::format(&c, 1));
+        return std::move(detail::format_to_string(*this, c));
+    }
+    
+    void Formatter<char>::format_to(char c, FormatBuffer& out) const {
+        FormatterBase::format_to(&c, 1, out);
     }
     
     Formatter<const char*>::Formatter() : FormatterBase() {
@@ -1017,6 +1517,10 @@ namespace utils {
         return std::move(format(value, std::strlen(value)));
     }
     
+    void Formatter<const char*>::format_to(const char* value, FormatBuffer& out) const {
+        FormatterBase::format_to(value, std::strlen(value), out);
+    }
+    
     std::string Formatter<const char*>::format(const char* value, std::size_t length) const {
         return std::move(FormatterBase::format(value, length));
     }
@@ -1025,10 +1529,26 @@ namespace utils {
         return Formatter<const char*>::format(value.data(), value.length());
     }
     
+    void Formatter<std::string_view>::format_to(std::string_view value, FormatBuffer& out) const {
+        FormatterBase::format_to(value.data(), value.length(), out);
+    }
+    
     std::string Formatter<std::string>::format(const std::string& value) const {
         return Formatter<const char*>::format(value.c_str(), value.length());
     }
     
+    void Formatter<std::string>::format_to(const std::string& value, FormatBuffer& out) const {
+        FormatterBase::format_to(value.c_str(), value.length(), out);
+    }
+    
+    std::string Formatter<std::pmr::string>::format(const std::pmr::string& value) const {
+        return Formatter<const char*>::format(value.c_str(), value.length());
+    }
+    
+    void Formatter<std::pmr::string>::format_to(const std::pmr::string& value, FormatBuffer& out) const {
+        FormatterBase::format_to(value.c_str(), value.length(), out);
+    }
+    
     Formatter<void*>::Formatter() : IntegerFormatter<std::uintptr_t>() {
         // Pointers are always formatted using hexadecimal
         representation = Representation::Hexadecimal;
@@ -1074,12 +1594,16 @@ namespace utils {
     Formatter<void*>::~Formatter() = default;
     
     std::string Formatter<void*>::format(void* value) const {
+        return std::move(detail::format_to_string(*this, value));
+    }
+    
+    void Formatter<void*>::format_to(void* value, FormatBuffer& out) const {
         if (value) {
-            return std::move(IntegerFormatter<std::uintptr_t>::format((std::uintptr_t) value));
+            IntegerFormatter<std::uintptr_t>::format_to((std::uintptr_t) value, out);
         }
         else {
             // Null pointers are printed as 'nullptr' and use a subset of the available formatting specifiers
-            return std::move(FormatterBase::format("nullptr"));
+            FormatterBase::format_to("nullptr", 7u, out);
         }
     }
     
@@ -1100,20 +1624,45 @@ namespace utils {
     }
 
     std::string Formatter<std::source_location>::format(const std::source_location& value) const {
-        if (!m_format.empty()) {
-            return FormatterBase::format(utils::format(m_format, NamedArgument("file", value.file_name()), NamedArgument("line", value.line())));
+        return std::move(detail::format_to_string(*this, value));
+    }
+    
+    void Formatter<std::source_location>::format_to(const std::source_location& value, FormatBuffer& out) const {
+        if (m_format.empty()) {
+            return;
+        }
+        
+        if (!width) {
+            utils::format_to(out, m_format, NamedArgument("file", value.file_name()), NamedArgument("line", value.line()));
+            return;
         }
         
-        return "";
+        // Justification requires the length of the result
+        std::string result = utils::format(m_format, NamedArgument("file", value.file_name()), NamedArgument("line", value.line()));
+        FormatterBase::format_to(result.c_str(), result.length(), out);
     }
     
     std::string Formatter<std::filesystem::path>::format(const std::filesystem::path& value) const {
-        return std::move(Formatter<std::string>::format(value.string()));
+        return std::move(detail::format_to_string(*this, value));
+    }
+    
+    void Formatter<std::filesystem::path>::format_to(const std::filesystem::path& value, FormatBuffer& out) const {
+        if constexpr (std::is_same<std::filesystem::path::string_type, std::string>::value) {
+            // Avoid copying the path if the native representation is already a narrow string
+            Formatter<std::string>::format_to(value.native(), out);
+        }
+        else {
+            Formatter<std::string>::format_to(value.string(), out);
+        }
     }
     
     std::string Formatter<std::thread::id>::format(const std::thread::id& value) const {
+        return std::move(detail::format_to_string(*this, value));
+    }
+    
+    void Formatter<std::thread::id>::format_to(const std::thread::id& value, FormatBuffer& out) const {
         std::hash<std::thread::id> hash { };
-        return std::move(Formatter<std::size_t>::format(hash(value)));
+        Formatter<std::size_t>::format_to(hash(value), out);
     }
     
 }
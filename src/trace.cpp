@@ -0,0 +1,453 @@
+
+#include "utils/trace.hpp"
+#include "utils/logging.hpp"
+#include "utils/exceptions.hpp"
+#include "utils/platform.hpp"
+
+#include <fstream> // std::ofstream
+#include <memory> // std::shared_ptr, std::make_shared, std::unique_ptr
+#include <mutex> // std::mutex, std::lock_guard, std::unique_lock
+#include <condition_variable> // std::condition_variable
+#include <thread> // std::thread
+#include <vector> // std::vector
+#include <string> // std::string
+#include <bit> // std::bit_ceil
+#include <algorithm> // std::max, std::min, std::find
+#include <atomic> // std::atomic
+#if defined(PLATFORM_WINDOWS)
+    #include <Windows.h>
+#else
+    #include <unistd.h> // getpid
+#endif
+
+namespace utils {
+    namespace trace {
+        
+        inline constexpr std::string_view binary_trace_magic = "UTILSTRC";
+        inline constexpr std::uint32_t binary_trace_version = 1u;
+        
+        struct Event {
+            std::uint64_t begin; // Ticks
+            std::uint64_t end;
+            const char* name; // Static storage
+            std::uint32_t name_length;
+            std::uint32_t line;
+            const char* filename;
+        };
+        
+        // Single-producer (the owning thread), single-consumer (the exporter) ring buffer of events
+        class ThreadBuffer {
+            public:
+                ThreadBuffer(std::size_t capacity, std::uint32_t index);
+                ~ThreadBuffer();
+                
+                // Returns false if the buffer is full
+                bool push(const Event& event);
+                
+                // Invokes 'fn' with each event in the buffer, in the order in which they were recorded
+                template <typename Fn>
+                void drain(Fn&& fn);
+                
+                const std::uint32_t index; // Sequential thread index, assigned in the order in which threads record their first span
+                std::atomic<bool> retired; // Set once the owning thread exits
+            
+            private:
+                std::unique_ptr<Event[]> m_events;
+                std::size_t m_mask;
+                
+                // Producer and consumer operate on separate cache lines
+                alignas(64) std::atomic<std::size_t> m_head; // Written by the producer
+                alignas(64) std::atomic<std::size_t> m_tail; // Written by the consumer
+        };
+        
+        ThreadBuffer::ThreadBuffer(std::size_t capacity, std::uint32_t index) : index(index),
+                                                                                retired(false),
+                                                                                m_events(std::make_unique<Event[]>(capacity)),
+                                                                                m_mask(capacity - 1u),
+                                                                                m_head(0u),
+                                                                                m_tail(0u) {
+        }
+        
+        ThreadBuffer::~ThreadBuffer() = default;
+        
+        bool ThreadBuffer::push(const Event& event) {
+            std::size_t head = m_head.load(std::memory_order_relaxed);
+            if (head - m_tail.load(std::memory_order_acquire) > m_mask) {
+                return false;
+            }
+            
+            m_events[head & m_mask] = event;
+            m_head.store(head + 1u, std::memory_order_release);
+            return true;
+        }
+        
+        template <typename Fn>
+        void ThreadBuffer::drain(Fn&& fn) {
+            std::size_t tail = m_tail.load(std::memory_order_relaxed);
+            std::size_t head = m_head.load(std::memory_order_acquire);
+            
+            for (std::size_t position = tail; position != head; ++position) {
+                fn(m_events[position & m_mask]);
+            }
+            
+            // Slots are handed back to the producer only once all events have been processed
+            m_tail.store(head, std::memory_order_release);
+        }
+        
+        class Exporter {
+            public:
+                Exporter(const std::filesystem::path& filepath, Options options);
+                ~Exporter(); // Writes out all recorded spans
+                
+                void run();
+            
+            private:
+                // Writes out the contents of all thread buffers, removing buffers of threads that have exited once they are empty
+                void drain();
+                
+                void write_json(const Event& event, std::uint32_t thread);
+                void write_binary(const Event& event, std::uint32_t thread);
+                
+                // Converts ticks to nanoseconds since tracing was started
+                [[nodiscard]] std::int64_t to_nanoseconds(std::uint64_t ticks) const;
+                
+                std::ofstream m_file;
+                Options m_options;
+                std::string m_buffer;
+                bool m_first; // Whether no event has been written yet (JSON events are separated by commas)
+                
+                std::uint64_t m_origin; // Ticks at which tracing was started
+                double m_nanoseconds_per_tick;
+                
+                std::mutex m_lock;
+                std::condition_variable m_stop_requested;
+                bool m_stopped;
+                std::thread m_thread;
+        };
+        
+        struct Registry {
+            static Registry& instance();
+            
+            std::mutex lock;
+            std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+            std::uint32_t next_index = 0u;
+            std::size_t capacity = 16384u; // Capacity of buffers created from now on
+            
+            std::mutex exporter_lock;
+            std::unique_ptr<Exporter> exporter;
+            
+            // Calibration of the timestamp counter, measured once when tracing is first started
+            bool calibrated = false;
+            double nanoseconds_per_tick = 1.0;
+            std::uint64_t origin = 0u; // Ticks at which tracing was last started
+            
+            std::atomic<std::size_t> dropped { 0u };
+        };
+        
+        Registry& Registry::instance() {
+            static Registry registry;
+            return registry;
+        }
+        
+        // Owns the calling thread's buffer, which is marked as retired (and released by the exporter once drained) when the thread exits
+        struct ThreadBufferHandle {
+            ~ThreadBufferHandle();
+            
+            ThreadBuffer* acquire();
+            
+            std::shared_ptr<ThreadBuffer> buffer;
+        };
+        
+        thread_local ThreadBufferHandle thread_buffer;
+        
+        ThreadBufferHandle::~ThreadBufferHandle() {
+            if (buffer) {
+                buffer->retired.store(true, std::memory_order_release);
+            }
+        }
+        
+        ThreadBuffer* ThreadBufferHandle::acquire() {
+            if (!buffer) [[unlikely]] {
+                // The registry is locked only once per thread
+                Registry& registry = Registry::instance();
+                std::lock_guard guard { registry.lock };
+                buffer = std::make_shared<ThreadBuffer>(registry.capacity, registry.next_index++);
+                registry.buffers.emplace_back(buffer);
+            }
+            return buffer.get();
+        }
+        
+        std::uint32_t get_process_id() {
+            #if defined(PLATFORM_WINDOWS)
+                return static_cast<std::uint32_t>(GetCurrentProcessId());
+            #else
+                return static_cast<std::uint32_t>(getpid());
+            #endif
+        }
+        
+        // Measures the rate of the timestamp counter against std::chrono::steady_clock
+        double calibrate() {
+            #if defined(UTILS_TRACE_RDTSC)
+                using namespace std::chrono;
+                
+                steady_clock::time_point start = steady_clock::now();
+                std::uint64_t begin = detail::read_ticks();
+                std::this_thread::sleep_for(milliseconds(10));
+                std::uint64_t end = detail::read_ticks();
+                nanoseconds elapsed = duration_cast<nanoseconds>(steady_clock::now() - start);
+                
+                return end > begin ? static_cast<double>(elapsed.count()) / static_cast<double>(end - begin) : 1.0;
+            #else
+                // Ticks are steady_clock nanoseconds
+                return 1.0;
+            #endif
+        }
+        
+        Exporter::Exporter(const std::filesystem::path& filepath, Options options) : m_file(),
+                                                                                     m_options(options),
+                                                                                     m_buffer(),
+                                                                                     m_first(true),
+                                                                                     m_origin(Registry::instance().origin),
+                                                                                     m_nanoseconds_per_tick(Registry::instance().nanoseconds_per_tick),
+                                                                                     m_lock(),
+                                                                                     m_stop_requested(),
+                                                                                     m_stopped(false),
+                                                                                     m_thread() {
+            std::filesystem::path directory = filepath.parent_path();
+            if (!directory.empty()) {
+                std::filesystem::create_directories(directory);
+            }
+            
+            m_file = std::ofstream(filepath, std::ios::out | std::ios::binary | std::ios::trunc);
+            if (!m_file.is_open()) {
+                throw FormattedError("failed to open file '{}'", filepath);
+            }
+            
+            if (m_options.format == Format::Json) {
+                m_buffer.append("{\"displayTimeUnit\":\"ns\",\"traceEvents\":[");
+            }
+            else {
+                std::uint32_t process_id = get_process_id();
+                m_buffer.append(binary_trace_magic);
+                m_buffer.append(reinterpret_cast<const char*>(&binary_trace_version), sizeof(binary_trace_version));
+                m_buffer.append(reinterpret_cast<const char*>(&process_id), sizeof(process_id));
+            }
+            
+            m_thread = std::thread(&Exporter::run, this);
+        }
+        
+        Exporter::~Exporter() {
+            {
+                std::lock_guard guard { m_lock };
+                m_stopped = true;
+            }
+            m_stop_requested.notify_one();
+            m_thread.join();
+            
+            // Spans recorded after the exporter thread stopped
+            drain();
+            
+            if (m_options.format == Format::Json) {
+                m_buffer.append("]}\n");
+            }
+            m_file.write(m_buffer.data(), static_cast<std::streamsize>(m_buffer.size()));
+            m_file.flush();
+        }
+        
+        void Exporter::run() {
+            std::unique_lock guard { m_lock };
+            while (!m_stopped) {
+                m_stop_requested.wait_for(guard, m_options.export_interval, [this]() {
+                    return m_stopped;
+                });
+                
+                guard.unlock();
+                drain();
+                
+                m_file.write(m_buffer.data(), static_cast<std::streamsize>(m_buffer.size()));
+                m_buffer.clear();
+                guard.lock();
+            }
+        }
+        
+        void Exporter::drain() {
+            Registry& registry = Registry::instance();
+            
+            std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+            {
+                std::lock_guard guard { registry.lock };
+                buffers = registry.buffers;
+            }
+            
+            std::vector<const ThreadBuffer*> retired;
+            for (const std::shared_ptr<ThreadBuffer>& buffer : buffers) {
+                // Checked before draining, so that the buffer is only released once all events recorded before the thread exited are written out
+                if (buffer->retired.load(std::memory_order_acquire)) {
+                    retired.emplace_back(buffer.get());
+                }
+                
+                std::uint32_t thread = buffer->index;
+                buffer->drain([this, thread](const Event& event) {
+                    if (m_options.format == Format::Json) {
+                        write_json(event, thread);
+                    }
+                    else {
+                        write_binary(event, thread);
+                    }
+                });
+            }
+            
+            if (!retired.empty()) {
+                std::lock_guard guard { registry.lock };
+                std::erase_if(registry.buffers, [&retired](const std::shared_ptr<ThreadBuffer>& buffer) {
+                    return std::find(retired.begin(), retired.end(), buffer.get()) != retired.end();
+                });
+            }
+        }
+        
+        std::int64_t Exporter::to_nanoseconds(std::uint64_t ticks) const {
+            return static_cast<std::int64_t>(static_cast<double>(static_cast<std::int64_t>(ticks - m_origin)) * m_nanoseconds_per_tick);
+        }
+        
+        void Exporter::write_json(const Event& event, std::uint32_t thread) {
+            static const std::uint32_t process_id = get_process_id();
+            
+            std::int64_t begin = to_nanoseconds(event.begin);
+            if (begin < 0) {
+                // Span began before tracing was (re)started
+                return;
+            }
+            
+            if (!m_first) {
+                m_buffer += ',';
+            }
+            m_first = false;
+            
+            // Complete events ("ph": "X") carry both the begin timestamp and duration, timestamps are in microseconds
+            std::int64_t duration = std::max(to_nanoseconds(event.end) - begin, std::int64_t(0));
+            
+            m_buffer.append("{\"name\":\"");
+            for (char c : std::string_view(event.name, event.name_length)) {
+                if (c == '"' || c == '\\') {
+                    m_buffer += '\\';
+                }
+                m_buffer += c;
+            }
+            
+            m_buffer.append(utils::format("\",\"ph\":\"X\",\"ts\":{}.{:width=[3],fill=[0],justification=[right]},\"dur\":{}.{:width=[3],fill=[0],justification=[right]},\"pid\":{},\"tid\":{},\"args\":{{\"file\":\"",
+                                          begin / 1000, begin % 1000, duration / 1000, duration % 1000, process_id, thread));
+            
+            for (const char* c = event.filename; *c; ++c) {
+                if (*c == '"' || *c == '\\') {
+                    m_buffer += '\\';
+                }
+                m_buffer += *c;
+            }
+            
+            m_buffer.append(utils::format("\",\"line\":{}}}}}", event.line));
+        }
+        
+        void Exporter::write_binary(const Event& event, std::uint32_t thread) {
+            std::int64_t begin = to_nanoseconds(event.begin);
+            if (begin < 0) {
+                // Span began before tracing was (re)started
+                return;
+            }
+            std::int64_t duration = std::max(to_nanoseconds(event.end) - begin, std::int64_t(0));
+            
+            auto write_value = [this](const auto& value) {
+                m_buffer.append(reinterpret_cast<const char*>(&value), sizeof(value));
+            };
+            
+            auto write_string = [this, &write_value](std::string_view value) {
+                std::uint16_t length = static_cast<std::uint16_t>(std::min(value.length(), std::size_t(0xFFFFu)));
+                write_value(length);
+                m_buffer.append(value.data(), length);
+            };
+            
+            write_value(thread);
+            write_value(begin);
+            write_value(duration);
+            write_value(event.line);
+            write_string(std::string_view(event.name, event.name_length));
+            write_string(event.filename);
+        }
+        
+        void start(const std::filesystem::path& filepath, Options options) {
+            Registry& registry = Registry::instance();
+            std::lock_guard guard { registry.exporter_lock };
+            
+            // Spans recorded by the previous session are written out to its file
+            detail::enabled.store(false, std::memory_order_relaxed);
+            registry.exporter.reset();
+            
+            {
+                std::lock_guard lock { registry.lock };
+                registry.capacity = std::bit_ceil(std::max(options.buffer_capacity, std::size_t(2u)));
+            }
+            
+            if (!registry.calibrated) {
+                registry.nanoseconds_per_tick = calibrate();
+                registry.calibrated = true;
+            }
+            registry.origin = detail::read_ticks();
+            registry.dropped.store(0u, std::memory_order_relaxed);
+            
+            registry.exporter = std::make_unique<Exporter>(filepath, options);
+            detail::enabled.store(true, std::memory_order_relaxed);
+        }
+        
+        void stop() {
+            Registry& registry = Registry::instance();
+            std::lock_guard guard { registry.exporter_lock };
+            
+            detail::enabled.store(false, std::memory_order_relaxed);
+            registry.exporter.reset();
+        }
+        
+        bool is_enabled() {
+            return detail::enabled.load(std::memory_order_relaxed);
+        }
+        
+        std::size_t get_dropped_span_count() {
+            return Registry::instance().dropped.load(std::memory_order_relaxed);
+        }
+        
+        namespace detail {
+            
+            void record(std::string_view name, const std::source_location& source, std::uint64_t begin, std::uint64_t end) {
+                Event event { begin, end, name.data(), static_cast<std::uint32_t>(name.length()), source.line(), source.file_name() };
+                if (!thread_buffer.acquire()->push(event)) {
+                    Registry::instance().dropped.fetch_add(1u, std::memory_order_relaxed);
+                }
+            }
+        
+        }
+        
+        ScopedTimer::ScopedTimer(std::string_view name, std::source_location source) : m_name(name.empty() ? std::string_view(source.function_name()) : name),
+                                                                                        m_source(source),
+                                                                                        m_elapsed(nullptr),
+                                                                                        m_begin(std::chrono::steady_clock::now()) {
+        }
+        
+        ScopedTimer::ScopedTimer(std::chrono::nanoseconds& elapsed) : m_name(),
+                                                                      m_source(),
+                                                                      m_elapsed(&elapsed),
+                                                                      m_begin(std::chrono::steady_clock::now()) {
+        }
+        
+        ScopedTimer::~ScopedTimer() {
+            if (m_elapsed) {
+                *m_elapsed = elapsed();
+            }
+            else {
+                logging::debug(logging::Message("{} took {}us", m_source), m_name, std::chrono::duration_cast<std::chrono::microseconds>(elapsed()).count());
+            }
+        }
+        
+        std::chrono::nanoseconds ScopedTimer::elapsed() const {
+            return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - m_begin);
+        }
+    
+    }
+}
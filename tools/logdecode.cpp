@@ -0,0 +1,344 @@
+#include "utils/logging.hpp"
+#include "utils/exceptions.hpp"
+
+#include <cstring> // std::memcpy
+#include <fstream> // std::ifstream, std::ofstream
+#include <iostream> // std::cout, std::cerr
+#include <iterator> // std::istreambuf_iterator
+#include <optional> // std::optional
+#include <string> // std::string
+#include <string_view> // std::string_view
+#include <variant> // std::variant, std::visit
+#include <vector> // std::vector
+
+// Converts binary log files written by BinaryFileSink back into text
+// usage: utils-logdecode [--format <format>] <input> [<output>]
+// The output format supports the same placeholders as sink format strings, thread IDs are printed as the hash values that were recorded
+
+using namespace utils;
+using namespace utils::logging;
+
+namespace {
+
+    struct Argument {
+        std::string_view name; // Empty for positional arguments
+        std::variant<char, std::int8_t, std::uint8_t, std::int16_t, std::uint16_t, std::int32_t, std::uint32_t, std::int64_t, std::uint64_t, float, double, void*, std::string_view> value;
+    };
+
+    struct FormatDefinition {
+        std::string_view format;
+        std::string_view filename;
+        std::string_view function;
+        std::uint32_t line;
+        std::uint32_t column;
+    };
+
+    // Sequential reader over the contents of a binary log file
+    class Reader {
+        public:
+            explicit Reader(std::string_view data) : m_data(data),
+                                                     m_offset(0u) {
+            }
+
+            template <typename T>
+            T read() {
+                T value;
+                std::memcpy(&value, consume(sizeof(T)).data(), sizeof(T));
+                return value;
+            }
+
+            std::string_view read_string() {
+                return consume(read<std::uint32_t>());
+            }
+
+            std::string_view consume(std::size_t length) {
+                if (length > m_data.length() - m_offset) {
+                    throw FormattedError("unexpected end of input at offset {}", m_offset);
+                }
+
+                std::string_view result = m_data.substr(m_offset, length);
+                m_offset += length;
+                return result;
+            }
+
+            [[nodiscard]] bool empty() const {
+                return m_offset == m_data.length();
+            }
+
+        private:
+            std::string_view m_data;
+            std::size_t m_offset;
+    };
+
+}
+
+// Dispatches to the formatter of the type the argument was recorded with
+template <>
+struct utils::Formatter<Argument> : public FormatterBase {
+    void parse(const FormatSpec& spec) {
+        // Format specs outlive the formatter for the duration of the call
+        m_spec = &spec;
+    }
+
+    void format_to(const Argument& argument, FormatBuffer& out) const {
+        std::visit([this, &out]<typename T>(const T& value) {
+            Formatter<T> formatter { };
+            formatter.parse(*m_spec);
+            utils::detail::format_argument(formatter, value, out);
+        }, argument.value);
+    }
+
+    std::string format(const Argument& argument) const {
+        return utils::detail::format_to_string(*this, argument);
+    }
+
+    const FormatSpec* m_spec = nullptr;
+};
+
+namespace {
+
+    // Upper bound on the number of arguments of a message (enforced when messages are logged), determines the number of instantiations of the dispatch below
+    constexpr std::size_t max_arguments = logging::detail::max_deferred_arguments;
+
+    // Builds the argument list of a call to utils::format_to(...) from the arguments of a message
+    // Arguments for positional placeholders must precede arguments for named placeholders, which keeps the number of instantiations quadratic in max_arguments
+    template <bool Named, typename ...Ts>
+    void format_message(std::string& out, std::string_view format, std::span<const Argument> arguments, const Ts&... args) {
+        if (arguments.empty()) {
+            utils::format_to(out, format, args...);
+            return;
+        }
+
+        if constexpr (sizeof...(Ts) < max_arguments) {
+            const Argument& argument = arguments.front();
+            if (!argument.name.empty()) {
+                format_message<true>(out, format, arguments.subspan(1u), args..., NamedArgument(argument.name, argument));
+                return;
+            }
+
+            if constexpr (!Named) {
+                format_message<false>(out, format, arguments.subspan(1u), args..., argument);
+            }
+            else {
+                throw std::runtime_error("arguments for positional placeholders must come before arguments for named placeholders");
+            }
+        }
+        else {
+            throw FormattedError("messages with more than {} arguments are not supported", max_arguments);
+        }
+    }
+
+    Argument read_argument(Reader& reader) {
+        Argument argument { };
+
+        switch (reader.read<logging::detail::ArgumentType>()) {
+            case logging::detail::ArgumentType::Char:
+                argument.value = reader.read<char>();
+                break;
+            case logging::detail::ArgumentType::Int8:
+                argument.value = reader.read<std::int8_t>();
+                break;
+            case logging::detail::ArgumentType::UInt8:
+                argument.value = reader.read<std::uint8_t>();
+                break;
+            case logging::detail::ArgumentType::Int16:
+                argument.value = reader.read<std::int16_t>();
+                break;
+            case logging::detail::ArgumentType::UInt16:
+                argument.value = reader.read<std::uint16_t>();
+                break;
+            case logging::detail::ArgumentType::Int32:
+                argument.value = reader.read<std::int32_t>();
+                break;
+            case logging::detail::ArgumentType::UInt32:
+                argument.value = reader.read<std::uint32_t>();
+                break;
+            case logging::detail::ArgumentType::Int64:
+                argument.value = reader.read<std::int64_t>();
+                break;
+            case logging::detail::ArgumentType::UInt64:
+                argument.value = reader.read<std::uint64_t>();
+                break;
+            case logging::detail::ArgumentType::Float:
+                argument.value = reader.read<float>();
+                break;
+            case logging::detail::ArgumentType::Double:
+                argument.value = reader.read<double>();
+                break;
+            case logging::detail::ArgumentType::Pointer:
+                argument.value = reinterpret_cast<void*>(reader.read<std::uintptr_t>());
+                break;
+            case logging::detail::ArgumentType::String:
+                argument.value = reader.read_string();
+                break;
+            case logging::detail::ArgumentType::Named: {
+                std::string_view name = reader.read_string();
+                argument = read_argument(reader);
+                if (!argument.name.empty()) {
+                    throw std::runtime_error("named arguments must not be nested");
+                }
+                argument.name = name;
+                break;
+            }
+            default:
+                throw std::runtime_error("unknown argument type");
+        }
+
+        return argument;
+    }
+
+    Timestamp to_timestamp(std::int64_t nanoseconds) {
+        return Timestamp(Clock::time_point(std::chrono::duration_cast<Clock::time_point::duration>(std::chrono::nanoseconds(nanoseconds))));
+    }
+
+    void decode(std::string_view data, const CompiledFormat& layout, std::ostream& out) {
+        Reader file { data };
+
+        if (file.consume(logging::detail::binary_log_magic.length()) != logging::detail::binary_log_magic) {
+            throw std::runtime_error("input is not a binary log file");
+        }
+
+        std::uint32_t version = file.read<std::uint32_t>();
+        if (version != logging::detail::binary_log_version) {
+            throw FormattedError("unsupported binary log version {} (expected {})", version, logging::detail::binary_log_version);
+        }
+
+        std::vector<std::optional<FormatDefinition>> formats;
+        std::vector<Argument> arguments;
+        std::string message;
+        std::string line;
+
+        while (!file.empty()) {
+            logging::detail::RecordType type = file.read<logging::detail::RecordType>();
+            Reader record { file.read_string() };
+
+            switch (type) {
+                case logging::detail::RecordType::Format: {
+                    std::uint32_t id = record.read<std::uint32_t>();
+
+                    FormatDefinition definition { };
+                    definition.line = record.read<std::uint32_t>();
+                    definition.column = record.read<std::uint32_t>();
+                    definition.format = record.read_string();
+                    definition.filename = record.read_string();
+                    definition.function = record.read_string();
+
+                    if (id >= formats.size()) {
+                        formats.resize(id + 1u);
+                    }
+                    formats[id] = definition;
+                    break;
+                }
+                case logging::detail::RecordType::Message: {
+                    std::uint32_t id = record.read<std::uint32_t>();
+                    if (id >= formats.size() || !formats[id]) {
+                        throw FormattedError("message references unknown format {}", id);
+                    }
+                    const FormatDefinition& definition = *formats[id];
+
+                    Message::Level level = static_cast<Message::Level>(record.read<std::uint8_t>());
+                    Timestamp timestamp = to_timestamp(record.read<std::int64_t>());
+                    std::uint64_t thread_id = record.read<std::uint64_t>();
+                    std::uint32_t process_id = record.read<std::uint32_t>();
+
+                    // Scopes are not part of the sink placeholders
+                    std::uint8_t depth = record.read<std::uint8_t>();
+                    for (std::uint8_t i = 0u; i < depth; ++i) {
+                        (void) record.read_string();
+                    }
+
+                    arguments.clear();
+                    std::uint8_t count = record.read<std::uint8_t>();
+                    for (std::uint8_t i = 0u; i < count; ++i) {
+                        arguments.emplace_back(read_argument(record));
+                    }
+
+                    message.clear();
+                    try {
+                        format_message<false>(message, definition.format, arguments);
+                    }
+                    catch (const std::exception& e) {
+                        message = utils::format("<failed to format message '{}' ({}:{}): {}>", definition.format, definition.filename, definition.line, e.what());
+                    }
+
+                    std::string source = utils::format("{}:{}", definition.filename, definition.line);
+
+                    line.clear();
+                    utils::format_to(line, layout, NamedArgument("message", message),
+                                                   NamedArgument("level", level),
+                                                   NamedArgument("timestamp", timestamp),
+                                                   NamedArgument("date", timestamp.date),
+                                                   NamedArgument("day", timestamp.date.day),
+                                                   NamedArgument("month", timestamp.date.month),
+                                                   NamedArgument("year", timestamp.date.year),
+                                                   NamedArgument("time", timestamp.time),
+                                                   NamedArgument("hour", timestamp.time.hour),
+                                                   NamedArgument("minute", timestamp.time.minute),
+                                                   NamedArgument("second", timestamp.time.second),
+                                                   NamedArgument("millisecond", timestamp.time.millisecond),
+                                                   NamedArgument("source", source),
+                                                   NamedArgument("filename", definition.filename),
+                                                   NamedArgument("line", definition.line),
+                                                   NamedArgument("thread_id", thread_id),
+                                                   NamedArgument("tid", thread_id),
+                                                   NamedArgument("process_id", process_id),
+                                                   NamedArgument("pid", process_id));
+                    line.push_back('\n');
+                    out.write(line.data(), static_cast<std::streamsize>(line.length()));
+                    break;
+                }
+                default:
+                    // Skip records introduced by newer versions
+                    break;
+            }
+        }
+    }
+
+}
+
+int main(int argc, char** argv) {
+    std::string format = "[{level}] {message}";
+    std::vector<std::string_view> paths;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string_view argument = argv[i];
+        if (argument == "--format" && i + 1 < argc) {
+            format = argv[++i];
+        }
+        else {
+            paths.emplace_back(argument);
+        }
+    }
+
+    if (paths.empty() || paths.size() > 2u) {
+        std::cerr << "usage: utils-logdecode [--format <format>] <input> [<output>]" << std::endl;
+        return 1;
+    }
+
+    try {
+        std::ifstream input(std::string(paths[0]), std::ios::in | std::ios::binary);
+        if (!input.is_open()) {
+            throw FormattedError("failed to open file '{}'", paths[0]);
+        }
+        std::string data { std::istreambuf_iterator<char>(input), std::istreambuf_iterator<char>() };
+
+        CompiledFormat layout { format };
+
+        if (paths.size() == 2u) {
+            std::ofstream output(std::string(paths[1]), std::ios::out | std::ios::binary | std::ios::trunc);
+            if (!output.is_open()) {
+                throw FormattedError("failed to open file '{}'", paths[1]);
+            }
+            decode(data, layout, output);
+        }
+        else {
+            decode(data, layout, std::cout);
+        }
+    }
+    catch (const std::exception& e) {
+        std::cerr << "utils-logdecode: " << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}